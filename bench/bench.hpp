@@ -0,0 +1,66 @@
+/**
+ * @file
+ *
+ * Small timing helpers shared by the benchmarks
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace bench {
+/**
+ * @brief Keeps the compiler from optimizing away a value
+ */
+template <typename T> inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static const void *volatile sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * @brief Times a function, taking the best of several repetitions
+ *
+ * @param reps Number of times to run the function
+ * @param func Function to time
+ *
+ * @returns Fastest run time in nanoseconds
+ */
+template <typename F> double timeBest(const std::size_t reps, F func) {
+  double best = 1e300;
+  for (std::size_t i = 0; i < reps; i++) {
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ns =
+        std::chrono::duration<double, std::nano>(end - start).count();
+    if (ns < best) {
+      best = ns;
+    }
+  }
+
+  return best;
+}
+
+/**
+ * @brief Prints one result line
+ *
+ * @param name Name of the benchmark
+ * @param ns Total time in nanoseconds
+ * @param samples Number of samples evaluated in that time
+ */
+inline void report(const std::string &name, const double ns,
+                   const std::size_t samples) {
+  std::cout << std::left << std::setw(40) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(2)
+            << ns / static_cast<double>(samples) << " ns/sample" << std::endl;
+}
+} // namespace bench
@@ -0,0 +1,65 @@
+/**
+ * @file
+ *
+ * Compares per-call evaluation to batch evaluation on sorted times
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include <hermite/compiled.hpp>
+#include <hermite/cubic.hpp>
+#include <hermite/hermite.hpp>
+
+#include "bench.hpp"
+
+namespace {
+const std::size_t kWaypoints = 1000;
+const std::size_t kSamples = 100000;
+const std::size_t kReps = 20;
+
+void run(const std::string &name, const hermite::BaseSpline<3> &spl) {
+  std::vector<double> ts(kSamples);
+  const double start = spl.getLowestTime();
+  const double step = (spl.getHighestTime() - start) / kSamples;
+  for (std::size_t i = 0; i < kSamples; i++) {
+    ts[i] = start + step * static_cast<double>(i);
+  }
+
+  std::vector<svector::Vector<3>> out(kSamples);
+
+  const double single = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kSamples; i++) {
+      out[i] = spl.getPos(ts[i]);
+    }
+    bench::doNotOptimize(out);
+  });
+
+  const double batch = bench::timeBest(kReps, [&]() {
+    spl.getPosBatch(ts.data(), kSamples, out.data());
+    bench::doNotOptimize(out);
+  });
+
+  bench::report(name + " getPos", single, kSamples);
+  bench::report(name + " getPosBatch", batch, kSamples);
+}
+} // namespace
+
+int main() {
+  hermite::Hermite<3> h;
+  for (std::size_t i = 0; i < kWaypoints; i++) {
+    const double t = static_cast<double>(i);
+    h.insert({t, {t, 2 * t, t * t}, {1, 2, 2 * t}});
+  }
+
+  hermite::Cubic<3> cub{h.getAllWaypoints()};
+
+  std::cout << kWaypoints << " waypoints, " << kSamples << " sorted samples"
+            << std::endl;
+  run("Hermite<3>", h);
+  run("Cubic<3>", cub);
+  run("Hermite<3> compiled", h.compile());
+  run("Cubic<3> compiled", cub.compile());
+  run("Cubic<3> compiled float", cub.compile<float>());
+}
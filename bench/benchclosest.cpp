@@ -0,0 +1,94 @@
+/**
+ * @file
+ *
+ * Compares finding the closest point on a spline by sampling to the search
+ * over the cached bounding boxes
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+#include <hermite/hermite.hpp>
+
+#include "bench.hpp"
+
+namespace {
+const std::size_t kWaypoints = 1000;
+const std::size_t kQueries = 1000;
+const std::size_t kReps = 5;
+const double kTimeStep = 0.01;
+
+/**
+ * Position of a robot that follows the spline a little off to the side
+ */
+hermite::Vector<2> getRobot(const hermite::Hermite<2> &h, const double t) {
+  return h.getPos(t) + hermite::Vector<2>{0.05, -0.05};
+}
+} // namespace
+
+int main() {
+  hermite::Hermite<2> h;
+  for (std::size_t i = 0; i < kWaypoints; i++) {
+    const double t = static_cast<double>(i);
+    h.insert({t, {t, std::sin(t)}, {1, std::cos(t)}});
+  }
+
+  std::cout << kWaypoints << " waypoints" << std::endl;
+
+  const double end = static_cast<double>(kWaypoints - 1);
+  double res = 0;
+
+  // only a few queries, since each one samples the whole spline
+  const std::size_t sampledQueries = 10;
+  const double sampled = bench::timeBest(1, [&]() {
+    for (std::size_t i = 0; i < sampledQueries; i++) {
+      const auto robot = getRobot(h, end * i / sampledQueries);
+      double bestDist = 1e300;
+      for (double t = 0; t <= end; t += kTimeStep) {
+        const double dist = magn(h.getPos(t) - robot);
+        if (dist < bestDist) {
+          bestDist = dist;
+          res = t;
+        }
+      }
+      bench::doNotOptimize(res);
+    }
+  });
+
+  // the first call measures every subinterval
+  const double first = bench::timeBest(1, [&]() {
+    res = h.getClosestTime(getRobot(h, 0));
+    bench::doNotOptimize(res);
+  });
+
+  const double cold = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kQueries; i++) {
+      res = h.getClosestTime(getRobot(h, end * i / kQueries));
+      bench::doNotOptimize(res);
+    }
+  });
+
+  // a robot that moves a little between queries
+  const double step = 0.05;
+  const double tracked = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kQueries; i++) {
+      res = h.getClosestTime(getRobot(h, step * i));
+      bench::doNotOptimize(res);
+    }
+  });
+
+  const double warm = bench::timeBest(kReps, [&]() {
+    double prev = 0;
+    for (std::size_t i = 0; i < kQueries; i++) {
+      prev = h.getClosestTime(getRobot(h, step * i), prev);
+      bench::doNotOptimize(prev);
+    }
+  });
+
+  bench::report("sampled every 0.01", sampled, sampledQueries);
+  bench::report("getClosestTime() first call", first, 1);
+  bench::report("getClosestTime(point), spread out", cold, kQueries);
+  bench::report("getClosestTime(point), tracking", tracked, kQueries);
+  bench::report("getClosestTime(point, hint), tracking", warm, kQueries);
+}
@@ -0,0 +1,66 @@
+/**
+ * @file
+ *
+ * Compares moving one waypoint of an editable cubic spline to building the
+ * whole spline again
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <hermite/cubic.hpp>
+#include <hermite/editable_cubic.hpp>
+
+#include "bench.hpp"
+
+namespace {
+const std::size_t kEdits = 200;
+const std::size_t kReps = 5;
+
+void run(const std::size_t waypoints) {
+  std::vector<hermite::Pose<3>> poses(waypoints);
+  for (std::size_t i = 0; i < waypoints; i++) {
+    const double t = static_cast<double>(i) + 0.25 * static_cast<double>(i % 3);
+    poses[i] = hermite::Pose<3>{
+        t, {static_cast<double>(i % 7), t, 1}, svector::Vector<3>{}};
+  }
+
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<std::size_t> pick{1, waypoints - 2};
+  std::vector<std::size_t> edits(kEdits);
+  for (auto &edit : edits) {
+    edit = pick(gen);
+  }
+
+  hermite::Cubic<3> cub{poses};
+  const double rebuild = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kEdits; i++) {
+      poses[edits[i]].setPos({static_cast<double>(i), 0, 0});
+      cub.rebuild(poses);
+    }
+    bench::doNotOptimize(cub);
+  });
+
+  hermite::EditableCubic<3> editable{poses};
+  const double edit = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kEdits; i++) {
+      poses[edits[i]].setPos({static_cast<double>(i), 1, 0});
+      editable.replace(poses[edits[i]]);
+    }
+    bench::doNotOptimize(editable);
+  });
+
+  const std::string name = std::to_string(waypoints) + " ";
+  bench::report(name + "Cubic::rebuild", rebuild, kEdits);
+  bench::report(name + "EditableCubic::replace", edit, kEdits);
+}
+} // namespace
+
+int main() {
+  std::cout << "ns per edit" << std::endl;
+  run(1000);
+  run(100000);
+}
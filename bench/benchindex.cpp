@@ -0,0 +1,104 @@
+/**
+ * @file
+ *
+ * Compares knot searches at random times: the std::map used by Hermite, a
+ * bisection over the sorted times, and KnotIndex
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <hermite/compiled.hpp>
+#include <hermite/cubic/cubic_impl.hpp>
+#include <hermite/knot_index.hpp>
+
+#include "bench.hpp"
+
+namespace {
+const std::size_t kSamples = 1000000;
+const std::size_t kReps = 3;
+
+void runSize(const std::size_t knots) {
+  // unevenly spaced, so the constant time lookup is not used
+  std::vector<double> times(knots);
+  for (std::size_t i = 0; i < knots; i++) {
+    times[i] = static_cast<double>(i) + 0.5 * static_cast<double>(i % 2);
+  }
+
+  std::mt19937 gen{42};
+  std::uniform_real_distribution<double> dist{0.0, times.back()};
+  std::vector<double> ts(kSamples);
+  for (auto &t : ts) {
+    t = dist(gen);
+  }
+
+  std::cout << knots << " knots, " << kSamples << " random samples"
+            << std::endl;
+
+  {
+    std::map<std::int64_t, double> waypoints;
+    for (const double t : times) {
+      waypoints.emplace(static_cast<std::int64_t>(t * 10), t);
+    }
+
+    std::size_t sum = 0;
+    const double ns = bench::timeBest(kReps, [&]() {
+      for (const double t : ts) {
+        sum += static_cast<std::size_t>(
+            waypoints.upper_bound(static_cast<std::int64_t>(t * 10))->first);
+      }
+      bench::doNotOptimize(sum);
+    });
+    bench::report("std::map upper_bound", ns, kSamples);
+  }
+
+  const int n = static_cast<int>(knots);
+  std::size_t sum = 0;
+  const double bisect = bench::timeBest(kReps, [&]() {
+    for (const double t : ts) {
+      sum += static_cast<std::size_t>(hermite::splhunt(times.data(), n, t, -1));
+    }
+    bench::doNotOptimize(sum);
+  });
+  bench::report("bisection", bisect, kSamples);
+
+  const hermite::KnotIndex<double> index{times.data(), knots};
+  const double eytzinger = bench::timeBest(kReps, [&]() {
+    for (const double t : ts) {
+      sum += static_cast<std::size_t>(index.findSegment(t));
+    }
+    bench::doNotOptimize(sum);
+  });
+  bench::report("KnotIndex", eytzinger, kSamples);
+
+  hermite::CompiledSpline<1> spl{times,
+                                 std::vector<double>(4 * (knots - 1), 1)};
+  svector::Vector<1> pos;
+  const double plain = bench::timeBest(kReps, [&]() {
+    for (const double t : ts) {
+      pos += spl.getPos(t);
+    }
+    bench::doNotOptimize(pos);
+  });
+  bench::report("CompiledSpline<1> getPos", plain, kSamples);
+
+  spl.buildIndex();
+  const double indexed = bench::timeBest(kReps, [&]() {
+    for (const double t : ts) {
+      pos += spl.getPos(t);
+    }
+    bench::doNotOptimize(pos);
+  });
+  bench::report("CompiledSpline<1> getPos indexed", indexed, kSamples);
+}
+} // namespace
+
+int main() {
+  runSize(1000);
+  runSize(100000);
+  runSize(10000000);
+}
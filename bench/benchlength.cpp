@@ -0,0 +1,101 @@
+/**
+ * @file
+ *
+ * Compares the sampled arc length to the cached exact arc length, and times
+ * lookups by arc length and range queries of the largest speed
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <hermite/hermite.hpp>
+
+#include "bench.hpp"
+
+namespace {
+const std::size_t kWaypoints = 1000;
+const std::size_t kQueries = 1000;
+const std::size_t kReps = 5;
+} // namespace
+
+int main() {
+  hermite::Hermite<3> h;
+  for (std::size_t i = 0; i < kWaypoints; i++) {
+    const double t = static_cast<double>(i);
+    h.insert({t, {t, static_cast<double>(i % 5), 1}, {1, 0, 1}});
+  }
+
+  std::cout << kWaypoints << " waypoints" << std::endl;
+
+  double res = 0;
+  const double sampled = bench::timeBest(1, [&]() {
+    res = h.getLength(0.001);
+    bench::doNotOptimize(res);
+  });
+  std::cout << "getLength(0.001) = " << res << std::endl;
+
+  // the first call measures every subinterval
+  const double first = bench::timeBest(1, [&]() {
+    res = h.getLength();
+    bench::doNotOptimize(res);
+  });
+  std::cout << "getLength() = " << res << std::endl;
+
+  const double partial = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kQueries; i++) {
+      const double t = static_cast<double>(i % (kWaypoints - 1));
+      res = h.getLength(t + 0.3, t * 0.5 + 0.7);
+      bench::doNotOptimize(res);
+    }
+  });
+
+  const double window = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kQueries; i++) {
+      const double t = static_cast<double>(i % (kWaypoints - 1));
+      res = h.getMaxSpeed(t * 0.5 + 0.3, t + 0.7);
+      bench::doNotOptimize(res);
+    }
+  });
+
+  const double sampledWindow = bench::timeBest(1, [&]() {
+    res = h.getMaxSpeed(0.001);
+    bench::doNotOptimize(res);
+  });
+
+  const double edit = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kQueries; i++) {
+      const double t = static_cast<double>(i % kWaypoints);
+      h.replace({t, {t, static_cast<double>(i % 3), 1}, {1, 0, 1}});
+      res = h.getLength();
+      bench::doNotOptimize(res);
+    }
+  });
+
+  // a point moving along the path at a steady pace, one step per query
+  const double total = h.getLength();
+  const double step = total / (kQueries * 10);
+  const double lookup = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kQueries; i++) {
+      res = h.getTimeAtDistance(step * static_cast<double>(i));
+      bench::doNotOptimize(res);
+    }
+  });
+
+  hermite::Hermite<3>::DistanceCursor cursor{h};
+  const double stepped = bench::timeBest(kReps, [&]() {
+    for (std::size_t i = 0; i < kQueries; i++) {
+      res = cursor.getTime(step * static_cast<double>(i));
+      bench::doNotOptimize(res);
+    }
+  });
+
+  bench::report("getLength(0.001)", sampled, 1);
+  bench::report("getLength() first call", first, 1);
+  bench::report("getLength(t0, t1)", partial, kQueries);
+  bench::report("getMaxSpeed(t0, t1)", window, kQueries);
+  bench::report("getMaxSpeed(0.001)", sampledWindow, 1);
+  bench::report("replace + getLength()", edit, kQueries);
+  bench::report("getTimeAtDistance()", lookup, kQueries);
+  bench::report("DistanceCursor::getTime()", stepped, kQueries);
+}
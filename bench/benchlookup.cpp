@@ -0,0 +1,73 @@
+/**
+ * @file
+ *
+ * Compares random-time lookups on Hermite and FlatHermite with many waypoints,
+ * evenly and unevenly spaced
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <hermite/flat_hermite.hpp>
+#include <hermite/hermite.hpp>
+
+#include "bench.hpp"
+
+namespace {
+const std::size_t kSamples = 1000000;
+const std::size_t kReps = 5;
+
+void run(const std::string &name, const hermite::BaseSpline<3> &spl,
+         const std::vector<double> &ts) {
+  svector::Vector<3> sum;
+  const double ns = bench::timeBest(kReps, [&]() {
+    for (const double t : ts) {
+      sum += spl.getPos(t);
+    }
+    bench::doNotOptimize(sum);
+  });
+
+  bench::report(name + " getPos", ns, ts.size());
+}
+
+void runSize(const std::size_t waypoints, const bool even) {
+  std::vector<hermite::Pose<3>> poses;
+  poses.reserve(waypoints);
+  for (std::size_t i = 0; i < waypoints; i++) {
+    const double t = static_cast<double>(i) + (even ? 0.0 : 0.3 * (i % 3));
+    poses.push_back({t, {t, 2 * t, t * t}, {1, 2, 2 * t}});
+  }
+
+  hermite::Hermite<3> h;
+  hermite::FlatHermite<3> f;
+  f.reserve(waypoints);
+  for (const auto &pose : poses) {
+    h.insert(pose);
+    f.insert(pose);
+  }
+
+  std::mt19937 gen{42};
+  std::uniform_real_distribution<double> dist{
+      0.0, static_cast<double>(waypoints - 1)};
+  std::vector<double> ts(kSamples);
+  for (auto &t : ts) {
+    t = dist(gen);
+  }
+
+  std::cout << waypoints << (even ? " even" : " uneven") << " waypoints, "
+            << kSamples << " random samples" << std::endl;
+  run("Hermite<3>", h, ts);
+  run("FlatHermite<3>", f, ts);
+}
+} // namespace
+
+int main() {
+  for (const bool even : {false, true}) {
+    runSize(1000, even);
+    runSize(100000, even);
+    runSize(1000000, even);
+  }
+}
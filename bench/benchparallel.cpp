@@ -0,0 +1,78 @@
+/**
+ * @file
+ *
+ * Compares the sequential spline solvers to the parallel one on very many
+ * waypoints
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <hermite/cubic/cubic_impl.hpp>
+#include <hermite/cubic/cubic_parallel.hpp>
+
+#include "bench.hpp"
+
+namespace {
+const std::size_t kDims = 3;
+const std::size_t kReps = 5;
+
+void run(const std::size_t waypoints) {
+  const int n = static_cast<int>(waypoints);
+  const int m = static_cast<int>(kDims);
+  std::vector<double> ts(waypoints);
+  std::vector<double> ys(waypoints * kDims);
+  for (std::size_t i = 0; i < waypoints; i++) {
+    ts[i] = static_cast<double>(i) + 0.25 * static_cast<double>(i % 3);
+    for (std::size_t dim = 0; dim < kDims; dim++) {
+      ys[i * kDims + dim] = static_cast<double>((i * (dim + 3)) % 11);
+    }
+  }
+
+  std::vector<double> yp(kDims);
+  std::vector<double> y(waypoints);
+  std::vector<double> y2(waypoints * kDims);
+  const double each = bench::timeBest(kReps, [&]() {
+    for (std::size_t dim = 0; dim < kDims; dim++) {
+      for (std::size_t i = 0; i < waypoints; i++) {
+        y[i] = ys[i * kDims + dim];
+      }
+      hermite::spline(ts.data(), y.data(), n, 0, 0, &y2[dim * waypoints]);
+    }
+    bench::doNotOptimize(y2);
+  });
+
+  std::vector<double> fac(4 * waypoints);
+  const double together = bench::timeBest(kReps, [&]() {
+    hermite::splfactor(ts.data(), n, fac.data());
+    hermite::splsolve(fac.data(), ys.data(), n, m, yp.data(), yp.data(),
+                      y2.data());
+    bench::doNotOptimize(y2);
+  });
+
+  const std::string name = std::to_string(waypoints) + " ";
+  bench::report(name + "spline per dimension", each, waypoints);
+  bench::report(name + "splfactor + splsolve", together, waypoints);
+
+  for (int threads = 1; threads <= 8; threads *= 2) {
+    const double parallel = bench::timeBest(kReps, [&]() {
+      hermite::splparallel(ts.data(), ys.data(), n, m, yp.data(), yp.data(),
+                           y2.data(), threads);
+      bench::doNotOptimize(y2);
+    });
+    bench::report(name + "splparallel, " + std::to_string(threads) +
+                      " threads",
+                  parallel, waypoints);
+  }
+}
+} // namespace
+
+int main() {
+  std::cout << kDims << " dimensions, " << std::thread::hardware_concurrency()
+            << " hardware threads, ns per waypoint" << std::endl;
+  run(1000000);
+  run(4000000);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file
+ *
+ * Compares finding the closest approach of two trajectories by sampling to
+ * the exact search over merged waypoints
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+#include <hermite/hermite.hpp>
+
+#include "bench.hpp"
+
+namespace {
+const std::size_t kWaypoints = 1000;
+const std::size_t kReps = 5;
+const double kTimeStep = 0.01;
+const double kThreshold = 0.5;
+} // namespace
+
+int main() {
+  // two robots on nearby wavy paths, with waypoints at different times
+  hermite::Hermite<2> a;
+  hermite::Hermite<2> b;
+  for (std::size_t i = 0; i < kWaypoints; i++) {
+    const double t = static_cast<double>(i);
+    a.insert({t, {t, std::sin(t)}, {1, std::cos(t)}});
+
+    const double s = t + 0.4;
+    b.insert({s, {s, 2 + std::sin(0.7 * s)}, {1, 0.7 * std::cos(0.7 * s)}});
+  }
+
+  std::cout << kWaypoints << " waypoints each" << std::endl;
+
+  const double end = static_cast<double>(kWaypoints - 1);
+  double res = 0;
+  const double sampled = bench::timeBest(1, [&]() {
+    res = 1e300;
+    for (double t = 0.4; t <= end; t += kTimeStep) {
+      res = std::fmin(res, magn(a.getPos(t) - b.getPos(t)));
+    }
+    bench::doNotOptimize(res);
+  });
+  std::cout << "sampled distance = " << res << std::endl;
+
+  // the first call measures every subinterval of both
+  hermite::Separation sep;
+  const double first = bench::timeBest(1, [&]() {
+    sep = a.getSeparation(b, kThreshold);
+    bench::doNotOptimize(sep);
+  });
+  std::cout << "exact distance = " << sep.distance << " at " << sep.time
+            << ", " << sep.crossings.size() << " crossings" << std::endl;
+
+  const double cached = bench::timeBest(kReps, [&]() {
+    sep = a.getSeparation(b, kThreshold);
+    bench::doNotOptimize(sep);
+  });
+
+  bench::report("sampled every 0.01", sampled, 1);
+  bench::report("getSeparation() first call", first, 1);
+  bench::report("getSeparation()", cached, 1);
+}
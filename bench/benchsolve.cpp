@@ -0,0 +1,87 @@
+/**
+ * @file
+ *
+ * Compares solving each dimension of a natural cubic spline on its own to
+ * solving all dimensions at once, and building a spline to solving it again
+ * for new positions
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <hermite/cubic.hpp>
+#include <hermite/cubic/cubic_impl.hpp>
+
+#include "bench.hpp"
+
+namespace {
+const std::size_t kWaypoints = 10000;
+const std::size_t kReps = 20;
+
+template <std::size_t D> void run() {
+  const int n = static_cast<int>(kWaypoints);
+  std::vector<double> ts(kWaypoints);
+  std::vector<double> ys(kWaypoints * D);
+  std::vector<hermite::Pose<D>> poses(kWaypoints);
+  for (std::size_t i = 0; i < kWaypoints; i++) {
+    ts[i] = static_cast<double>(i) + 0.25 * static_cast<double>(i % 3);
+    svector::Vector<D> pos;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      pos[dim] = static_cast<double>((i * (dim + 3)) % 11);
+      ys[i * D + dim] = pos[dim];
+    }
+    poses[i] = hermite::Pose<D>{ts[i], pos, svector::Vector<D>{}};
+  }
+
+  std::vector<double> yp(D);
+  std::vector<double> y(kWaypoints);
+  std::vector<double> y2(kWaypoints * D);
+  const double each = bench::timeBest(kReps, [&]() {
+    for (std::size_t dim = 0; dim < D; dim++) {
+      for (std::size_t i = 0; i < kWaypoints; i++) {
+        y[i] = ys[i * D + dim];
+      }
+      hermite::spline(ts.data(), y.data(), n, 0, 0, &y2[dim * kWaypoints]);
+    }
+    bench::doNotOptimize(y2);
+  });
+
+  std::vector<double> fac(4 * kWaypoints);
+  const double together = bench::timeBest(kReps, [&]() {
+    hermite::splfactor(ts.data(), n, fac.data());
+    hermite::splsolve(fac.data(), ys.data(), n, static_cast<int>(D), yp.data(),
+                      yp.data(), y2.data());
+    bench::doNotOptimize(y2);
+  });
+
+  const double build = bench::timeBest(kReps, [&]() {
+    hermite::Cubic<D> cub{poses};
+    bench::doNotOptimize(cub);
+  });
+
+  hermite::Cubic<D> cub{poses};
+  std::vector<svector::Vector<D>> positions(kWaypoints);
+  for (std::size_t i = 0; i < kWaypoints; i++) {
+    positions[i] = poses[i].getPos();
+  }
+  const double resolve = bench::timeBest(kReps, [&]() {
+    cub.resolve(positions, svector::Vector<D>{}, svector::Vector<D>{});
+    bench::doNotOptimize(cub);
+  });
+
+  const std::string name = std::to_string(D) + "D";
+  bench::report(name + " spline per dimension", each, kWaypoints);
+  bench::report(name + " splfactor + splsolve", together, kWaypoints);
+  bench::report(name + " Cubic constructor", build, kWaypoints);
+  bench::report(name + " Cubic::resolve", resolve, kWaypoints);
+}
+} // namespace
+
+int main() {
+  std::cout << kWaypoints << " waypoints, ns per waypoint" << std::endl;
+  run<3>();
+  run<7>();
+  run<30>();
+}
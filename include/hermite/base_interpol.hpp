@@ -8,6 +8,7 @@
 
 #include <cstddef>
 
+#include "hermite/state.hpp"
 #include "hermite/thirdparty/simplevectors.hpp"
 
 namespace hermite {
@@ -70,5 +71,20 @@ public:
    * @returns Output from function's second derivative
    */
   virtual Vector<D> getAcc(const double t) const = 0;
+
+  /**
+   * @brief Gets the function and its first two derivatives at a certain point
+   *
+   * This will usually be the position, velocity, and acceleration. Classes
+   * that override this share the work between the three, so it is faster than
+   * calling getPos(), getVel(), and getAcc() separately.
+   *
+   * @param t Input to get value from
+   *
+   * @returns Output from the function and its derivatives
+   */
+  virtual State<D> getState(const double t) const {
+    return State<D>{getPos(t), getVel(t), getAcc(t)};
+  }
 };
 } // namespace hermite
@@ -9,6 +9,7 @@
 #include <cstddef>
 
 #include "hermite/base_interpol.hpp"
+#include "hermite/state.hpp"
 #include "hermite/thirdparty/simplevectors.hpp"
 
 namespace hermite {
@@ -77,6 +78,74 @@ public:
    */
   virtual Vector<D> getAcc(const double t) const = 0;
 
+  /**
+   * @brief Gets positions at many times at once
+   *
+   * Evaluates the spline at every time in the input array and writes the
+   * results to the output array. This only makes one virtual call for the
+   * whole batch, and splines that override it reuse the segment from the
+   * previous time when the input is sorted.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  virtual void getPosBatch(const double ts[], const std::size_t n,
+                           Vector<D> out[]) const {
+    for (std::size_t i = 0; i < n; i++) {
+      out[i] = getPos(ts[i]);
+    }
+  }
+
+  /**
+   * @brief Gets velocities at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   *
+   * @see getPosBatch()
+   */
+  virtual void getVelBatch(const double ts[], const std::size_t n,
+                           Vector<D> out[]) const {
+    for (std::size_t i = 0; i < n; i++) {
+      out[i] = getVel(ts[i]);
+    }
+  }
+
+  /**
+   * @brief Gets accelerations at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   *
+   * @see getPosBatch()
+   */
+  virtual void getAccBatch(const double ts[], const std::size_t n,
+                           Vector<D> out[]) const {
+    for (std::size_t i = 0; i < n; i++) {
+      out[i] = getAcc(ts[i]);
+    }
+  }
+
+  /**
+   * @brief Gets positions, velocities, and accelerations at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n states
+   *
+   * @see getPosBatch()
+   * @see getState()
+   */
+  virtual void getStateBatch(const double ts[], const std::size_t n,
+                             State<D> out[]) const {
+    for (std::size_t i = 0; i < n; i++) {
+      out[i] = this->getState(ts[i]);
+    }
+  }
+
   /**
    * @brief Gets maximum distance from origin
    *
@@ -175,4 +244,15 @@ public:
    */
   virtual double getLength(const double timeStep) const = 0;
 };
+
+/**
+ * @brief Evaluation cursor of a spline
+ *
+ * Shorthand for the spline's nested cursor class. For example,
+ * SplineCursor<Hermite<3>> is Hermite<3>::Cursor.
+ *
+ * A cursor remembers the segment that it last evaluated, so that evaluating at
+ * times close to each other takes amortized constant time.
+ */
+template <typename S> using SplineCursor = typename S::Cursor;
 } // namespace hermite
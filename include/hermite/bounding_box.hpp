@@ -0,0 +1,162 @@
+/**
+ * @file
+ *
+ * Contains the axis-aligned bounding box data structure
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#include "hermite/thirdparty/simplevectors.hpp"
+
+namespace hermite {
+using svector::Vector;
+
+/**
+ * @brief Axis-aligned box that contains part of a spline
+ *
+ * Returned by Hermite::getBoundingBox() and Cubic::getBoundingBox(). The
+ * default box is empty, and merging it with another box gives the other box.
+ */
+template <std::size_t D> struct BoundingBox {
+  Vector<D> lower; //!< Smallest coordinate in each dimension
+  Vector<D> upper; //!< Largest coordinate in each dimension
+
+  /**
+   * @brief Default constructor
+   *
+   * Initializes an empty box, which has lower bounds of infinity and upper
+   * bounds of negative infinity
+   */
+  BoundingBox() {
+    const double inf = std::numeric_limits<double>::infinity();
+    for (std::size_t dim = 0; dim < D; dim++) {
+      lower[dim] = inf;
+      upper[dim] = -inf;
+    }
+  }
+
+  /**
+   * @brief Constructor
+   *
+   * @param lower Smallest coordinate in each dimension
+   * @param upper Largest coordinate in each dimension
+   */
+  BoundingBox(const Vector<D> &lower, const Vector<D> &upper)
+      : lower{lower}, upper{upper} {}
+
+  /**
+   * @brief Checks whether the box contains no points
+   *
+   * @returns True if the lower bound is above the upper bound in any dimension
+   */
+  bool isEmpty() const {
+    for (std::size_t dim = 0; dim < D; dim++) {
+      if (lower[dim] > upper[dim]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Checks whether the box contains a point
+   *
+   * @param point Point
+   *
+   * @returns True if the point is inside or on the box
+   */
+  bool contains(const Vector<D> &point) const {
+    for (std::size_t dim = 0; dim < D; dim++) {
+      if (point[dim] < lower[dim] || point[dim] > upper[dim]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Checks whether two boxes overlap
+   *
+   * @param other Other box
+   *
+   * @returns True if the boxes share a point, including touching faces
+   */
+  bool intersects(const BoundingBox<D> &other) const {
+    for (std::size_t dim = 0; dim < D; dim++) {
+      if (other.upper[dim] < lower[dim] || other.lower[dim] > upper[dim]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Gets the squared distance from a point to the nearest point of the
+   * box
+   *
+   * @param point Point
+   *
+   * @returns Squared distance, which is 0 if the point is inside the box, or
+   * infinity if the box is empty
+   */
+  double getSquaredDistance(const Vector<D> &point) const {
+    if (isEmpty()) {
+      return std::numeric_limits<double>::infinity();
+    }
+
+    double res = 0;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      const double gap = std::max(
+          std::max(lower[dim] - point[dim], point[dim] - upper[dim]), 0.0);
+      res += gap * gap;
+    }
+    return res;
+  }
+
+  /**
+   * @brief Gets the squared distance between the nearest points of two boxes
+   *
+   * @param other Other box
+   *
+   * @returns Squared distance, which is 0 if the boxes overlap, or infinity if
+   * either box is empty
+   */
+  double getSquaredDistance(const BoundingBox<D> &other) const {
+    if (isEmpty() || other.isEmpty()) {
+      return std::numeric_limits<double>::infinity();
+    }
+
+    double res = 0;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      const double gap =
+          std::max(std::max(lower[dim] - other.upper[dim],
+                            other.lower[dim] - upper[dim]),
+                   0.0);
+      res += gap * gap;
+    }
+    return res;
+  }
+
+  /**
+   * @brief Gets the smallest box that contains two boxes
+   *
+   * @param a First box
+   * @param b Second box
+   *
+   * @returns Union of the boxes
+   */
+  static BoundingBox<D> merge(const BoundingBox<D> &a,
+                              const BoundingBox<D> &b) {
+    BoundingBox<D> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res.lower[dim] = std::min(a.lower[dim], b.lower[dim]);
+      res.upper[dim] = std::max(a.upper[dim], b.upper[dim]);
+    }
+    return res;
+  }
+};
+} // namespace hermite
@@ -0,0 +1,716 @@
+/**
+ * @file
+ *
+ * A frozen spline stored as a table of polynomial coefficients
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "hermite/base_spline.hpp"
+#include "hermite/cubic/cubic_impl.hpp"
+#include "hermite/knot_index.hpp"
+#include "hermite/poly/poly.hpp"
+#include "hermite/simd/simd.hpp"
+#include "hermite/state.hpp"
+#include "hermite/thirdparty/simplevectors.hpp"
+#include "hermite/uniform_knots.hpp"
+
+namespace hermite {
+using svector::magn;
+using svector::Vector;
+
+/**
+ * @brief Converts a table of coefficients to another scalar type
+ *
+ * @param coefs Coefficients in double
+ *
+ * @returns Coefficients rounded to T
+ */
+template <typename T>
+std::vector<T> convertCoefficients(std::vector<double> coefs) {
+  return std::vector<T>(coefs.begin(), coefs.end());
+}
+
+/**
+ * @brief Converts a table of coefficients to double, which is a move
+ *
+ * @param coefs Coefficients in double
+ *
+ * @returns The same coefficients
+ */
+template <>
+inline std::vector<double>
+convertCoefficients<double>(std::vector<double> coefs) {
+  return coefs;
+}
+
+/**
+ * @brief A compiled piecewise polynomial spline
+ *
+ * Stores every segment of a cubic spline in the power basis:
+ *
+ * @f[
+ * \mathbf{p}(t) = \mathbf{a} + \mathbf{b}u + \mathbf{c}u^2 + \mathbf{d}u^3,
+ * \quad u = \frac{t - t_k}{t_{k+1} - t_k}
+ * @f]
+ *
+ * All of the coefficients are kept in one contiguous array, along with the
+ * knot times and the reciprocal of each segment's length, so evaluating the
+ * spline is a segment search followed by one Horner pass per dimension.
+ *
+ * This class cannot be edited. It is meant to be created once from
+ * Hermite::compile() or Cubic::compile() and then evaluated many times.
+ *
+ * The coefficients can be stored as float instead of double, which halves the
+ * size of the table and lets the batch kernels evaluate twice as many times
+ * per instruction. The knot times stay double, and u is found in double from
+ * the offset of t into its segment before it is rounded to T, so large
+ * absolute times do not lose precision. The coefficients themselves are
+ * rounded, so each result has a relative error of about 1e-7 of the largest
+ * term of its polynomial. That is, positions far from the origin lose
+ * precision: at a distance of 1e4, float positions are only accurate to about
+ * 1e-3.
+ *
+ * @tparam D Number of dimensions
+ * @tparam T Scalar type of the coefficients, either double or float
+ *
+ * @note If time is outside the domain of the knots, then the first or last
+ * segment is extended, like in Hermite and Cubic.
+ */
+template <std::size_t D, typename T = double>
+class CompiledSpline : public BaseSpline<D> {
+public:
+  /**
+   * @brief Evaluation cursor
+   *
+   * Remembers the segment that it last evaluated, so evaluating at a time
+   * close to the previous one takes amortized constant time.
+   *
+   * @note The CompiledSpline object must outlive the cursor.
+   */
+  class Cursor {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param spline CompiledSpline object to evaluate
+     */
+    explicit Cursor(const CompiledSpline<D, T> &spline)
+        : m_spline{&spline}, m_seg{0} {}
+
+    /**
+     * @brief Gets position at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as CompiledSpline::getPos()
+     */
+    Vector<D> getPos(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_spline->evalPos(m_seg, t);
+    }
+
+    /**
+     * @brief Gets velocity at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as CompiledSpline::getVel()
+     */
+    Vector<D> getVel(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_spline->evalVel(m_seg, t);
+    }
+
+    /**
+     * @brief Gets acceleration at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as CompiledSpline::getAcc()
+     */
+    Vector<D> getAcc(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_spline->evalAcc(m_seg, t);
+    }
+
+    /**
+     * @brief Gets position, velocity, and acceleration at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as CompiledSpline::getState()
+     */
+    State<D> getState(const double t) {
+      if (!seek(t)) {
+        return State<D>{};
+      }
+
+      return m_spline->evalState(m_seg, t);
+    }
+
+    /**
+     * @brief Forgets the current segment
+     */
+    void reset() { m_seg = 0; }
+
+  private:
+    const CompiledSpline<D, T> *m_spline;
+    int m_seg;
+
+    /**
+     * Moves the cursor to the segment containing a certain time
+     *
+     * @returns False if there are not enough knots to evaluate
+     */
+    bool seek(const double t) {
+      if (m_spline->m_times.size() < 2) {
+        return false;
+      }
+
+      m_seg = m_spline->findSegment(t, m_seg);
+      return true;
+    }
+  };
+
+  /**
+   * @brief Default constructor
+   *
+   * Initializes with zero knots
+   */
+  CompiledSpline() = default;
+
+  /**
+   * @brief Constructor
+   *
+   * It is recommended to use Hermite::compile() or Cubic::compile() instead of
+   * calling this directly.
+   *
+   * @param times Knot times, sorted with no repeats
+   * @param coefs Coefficients of each segment. There must be 4 * D numbers for
+   * each of the times.size() - 1 segments, and the coefficient of u^j in
+   * dimension dim of segment k is at coefs[(4 * k + j) * D + dim].
+   *
+   * @note If the times are not sorted or the sizes do not match, then there
+   * will be undefined behavior.
+   */
+  CompiledSpline(std::vector<double> times, std::vector<T> coefs)
+      : m_times{std::move(times)}, m_coefs{std::move(coefs)} {
+    if (m_times.size() < 2) {
+      return;
+    }
+
+    m_uniform = UniformKnots{m_times.data(), m_times.size()};
+    m_invH.resize(m_times.size() - 1);
+    for (std::size_t k = 0; k < m_invH.size(); k++) {
+      m_invH[k] = 1 / (m_times[k + 1] - m_times[k]);
+    }
+  }
+
+  /**
+   * @brief Copy constructor
+   */
+  CompiledSpline(const CompiledSpline<D, T> &other)
+      : m_times{other.m_times}, m_invH{other.m_invH}, m_coefs{other.m_coefs},
+        m_uniform{other.m_uniform}, m_index{other.m_index} {}
+
+  /**
+   * @brief Assignment operator
+   */
+  CompiledSpline<D, T> &operator=(const CompiledSpline<D, T> &other) {
+    if (this == &other) {
+      return *this;
+    }
+
+    m_times = other.m_times;
+    m_invH = other.m_invH;
+    m_coefs = other.m_coefs;
+    m_uniform = other.m_uniform;
+    m_index = other.m_index;
+
+    return *this;
+  }
+
+  /**
+   * @brief Destructor
+   */
+  ~CompiledSpline() override = default;
+
+  /**
+   * @brief Gets the knot times
+   *
+   * @returns Knot times, sorted
+   */
+  const std::vector<double> &getTimes() const { return m_times; }
+
+  /**
+   * @brief Gets the coefficient table
+   *
+   * @returns Coefficients, laid out as described in the constructor
+   */
+  const std::vector<T> &getCoefficients() const { return m_coefs; }
+
+  /**
+   * @brief Checks whether the knots are evenly spaced
+   *
+   * If they are, within UNIFORM_TOLERANCE of the spacing, then segments are
+   * found in constant time instead of with a binary search.
+   *
+   * @returns True if the knots are evenly spaced
+   */
+  bool isUniform() const { return m_uniform.isUniform(); }
+
+  /**
+   * @brief Builds a search index over the knot times
+   *
+   * Speeds up getPos(), getVel(), getAcc(), and getState() at random times when
+   * there are many knots, at the cost of a second copy of the times. Cursors
+   * and batches walk from the previous segment instead, so they do not use the
+   * index.
+   *
+   * @see KnotIndex
+   */
+  void buildIndex() {
+    m_index = KnotIndex<double>{m_times.data(), m_times.size()};
+  }
+
+  /**
+   * @brief Checks whether the search index has been built
+   *
+   * @returns True if buildIndex() has been called
+   */
+  bool hasIndex() const { return !m_index.empty(); }
+
+  /**
+   * @brief Gets the lower bound of the domain of the piecewise spline function,
+   * which is the first knot time.
+   *
+   * @note If there are no knots, then returns 0
+   *
+   * @returns The first time measurement
+   */
+  double getLowestTime() const override {
+    if (m_times.size() == 0) {
+      return 0;
+    }
+
+    return m_times[0];
+  }
+
+  /**
+   * @brief Gets the upper bound of the domain of the piecewise spline function,
+   * which is the last knot time.
+   *
+   * @note If there are no knots, then returns 0
+   *
+   * @returns The last time measurement
+   */
+  double getHighestTime() const override {
+    if (m_times.size() == 0) {
+      return 0;
+    }
+
+    return m_times[m_times.size() - 1];
+  }
+
+  /**
+   * @brief Gets position at a certain time
+   *
+   * Same as calling operator()()
+   *
+   * @note If number of knots is less than or equal to 1, then returns a zero
+   * vector.
+   *
+   * @param t Time
+   *
+   * @returns Position
+   */
+  Vector<D> getPos(const double t) const override {
+    if (m_times.size() < 2) {
+      return Vector<D>{};
+    }
+
+    return evalPos(findSegment(t, -1), t);
+  }
+
+  /**
+   * @brief Gets velocity at a certain time
+   *
+   * @note If number of knots is less than or equal to 1, then returns a zero
+   * vector.
+   *
+   * @param t Time
+   *
+   * @returns Velocity
+   */
+  Vector<D> getVel(const double t) const override {
+    if (m_times.size() < 2) {
+      return Vector<D>{};
+    }
+
+    return evalVel(findSegment(t, -1), t);
+  }
+
+  /**
+   * @brief Gets acceleration at a certain time
+   *
+   * @note If number of knots is less than or equal to 1, then returns a zero
+   * vector.
+   * @note If called on a knot, will take the value of the latter segment.
+   *
+   * @param t Time
+   *
+   * @returns Acceleration
+   */
+  Vector<D> getAcc(const double t) const override {
+    if (m_times.size() < 2) {
+      return Vector<D>{};
+    }
+
+    return evalAcc(findSegment(t, -1), t);
+  }
+
+  /**
+   * @brief Gets position, velocity, and acceleration at a certain time
+   *
+   * @note If number of knots is less than or equal to 1, then returns zero
+   * vectors.
+   *
+   * @param t Time
+   *
+   * @returns Position, velocity, and acceleration
+   */
+  State<D> getState(const double t) const override {
+    if (m_times.size() < 2) {
+      return State<D>{};
+    }
+
+    return evalState(findSegment(t, -1), t);
+  }
+
+  /**
+   * @brief Gets positions at many times at once
+   *
+   * @note If the times are sorted, then each segment is found by hunting from
+   * the previous one, and times that fall in the same segment are evaluated
+   * together with the vectorized kernels in simd.hpp.
+   * @note If number of knots is less than or equal to 1, then fills the output
+   * with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getPosBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    if (m_times.size() < 2) {
+      std::fill(out, out + n, Vector<D>{});
+      return;
+    }
+
+    evalRuns(0, ts, n, out);
+  }
+
+  /**
+   * @brief Gets velocities at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   *
+   * @see getPosBatch()
+   */
+  void getVelBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    if (m_times.size() < 2) {
+      std::fill(out, out + n, Vector<D>{});
+      return;
+    }
+
+    evalRuns(1, ts, n, out);
+  }
+
+  /**
+   * @brief Gets accelerations at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   *
+   * @see getPosBatch()
+   */
+  void getAccBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    if (m_times.size() < 2) {
+      std::fill(out, out + n, Vector<D>{});
+      return;
+    }
+
+    evalRuns(2, ts, n, out);
+  }
+
+  /**
+   * @brief Gets positions, velocities, and accelerations at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n states
+   *
+   * @see getPosBatch()
+   */
+  void getStateBatch(const double ts[], const std::size_t n,
+                     State<D> out[]) const override {
+    if (m_times.size() < 2) {
+      std::fill(out, out + n, State<D>{});
+      return;
+    }
+
+    int seg = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      seg = findSegment(ts[i], seg);
+      out[i] = evalState(seg, ts[i]);
+    }
+  }
+
+  /**
+   * @brief Gets arc length
+   *
+   * @param timeStep The time step to try for the arc length
+   *
+   * @note This function will take much longer for smaller timesteps.
+   * Recommended is between 0.001 and 0.1, but this also depends on the domain
+   * of your function.
+   * @note If zero or one knots, returns 0.
+   *
+   * @returns Arc length
+   */
+  double getLength(const double timeStep) const override {
+    double res = 0.0;
+
+    if (m_times.size() < 2) {
+      return res;
+    }
+
+    double time = getLowestTime() + timeStep;
+    const double timeEnd = getHighestTime();
+    int seg = 0;
+    while (time <= timeEnd) {
+      seg = findSegment(time, seg);
+      auto vel = evalVel(seg, time);
+      auto speed = magn(vel);
+      res += speed * timeStep;
+
+      time += timeStep;
+    }
+
+    return res;
+  }
+
+  using BaseSpline<D>::getMaxDistance;
+  using BaseSpline<D>::getMaxSpeed;
+  using BaseSpline<D>::getMaxAcceleration;
+
+  /**
+   * @brief Gets maximum distance from origin exactly, in time linear in the
+   * number of knots
+   *
+   * @note If number of knots is less than or equal to 1, then returns 0.
+   *
+   * @returns Maximum distance from the origin
+   *
+   * @see Hermite::getMaxDistance()
+   */
+  double getMaxDistance() const { return getMaxMagn(0); }
+
+  /**
+   * @brief Gets maximum speed exactly, in time linear in the number of knots
+   *
+   * @note If number of knots is less than or equal to 1, then returns 0.
+   *
+   * @returns Maximum speed
+   *
+   * @see Hermite::getMaxSpeed()
+   */
+  double getMaxSpeed() const { return getMaxMagn(1); }
+
+  /**
+   * @brief Gets maximum magnitude of acceleration exactly, in time linear in
+   * the number of knots
+   *
+   * @note If number of knots is less than or equal to 1, then returns 0.
+   *
+   * @returns Magnitude of maximum acceleration
+   *
+   * @see Hermite::getMaxAcceleration()
+   */
+  double getMaxAcceleration() const { return getMaxMagn(2); }
+
+private:
+  std::vector<double> m_times;
+  std::vector<double> m_invH;
+  std::vector<T> m_coefs;
+  UniformKnots m_uniform;
+  KnotIndex<double> m_index;
+
+  /**
+   * Gets the largest magnitude of a derivative over all segments
+   *
+   * @param deriv 0 for position, 1 for velocity, 2 for acceleration
+   */
+  double getMaxMagn(const int deriv) const {
+    double res = 0;
+    double coefs[4 * D];
+    for (std::size_t seg = 0; seg < m_invH.size(); seg++) {
+      std::copy(&m_coefs[4 * D * seg], &m_coefs[4 * D * (seg + 1)], coefs);
+      res = std::max(res, poly::getSegmentMax<D>(coefs, m_invH[seg], deriv));
+    }
+
+    return std::sqrt(res);
+  }
+
+  /**
+   * Finds the segment containing a time, hunting from a hint, or searching the
+   * index if the hint is negative and the index has been built
+   *
+   * @returns Index of the segment
+   */
+  int findSegment(const double t, const int hint) const {
+    if (m_uniform.isUniform()) {
+      return m_uniform.getSegment(t);
+    }
+
+    if (hint < 0 && !m_index.empty()) {
+      return m_index.findSegment(t);
+    }
+
+    return splhunt(m_times.data(), static_cast<int>(m_times.size()), t, hint);
+  }
+
+  /**
+   * Evaluates a derivative at many times, handing each run of times in the
+   * same segment to the vectorized kernels at once
+   *
+   * @param deriv 0 for position, 1 for velocity, 2 for acceleration
+   * @param ts Array of times
+   * @param n Number of times
+   * @param out Output array
+   */
+  void evalRuns(const int deriv, const double ts[], const std::size_t n,
+                Vector<D> out[]) const {
+    const int last = static_cast<int>(m_times.size()) - 2;
+
+    int seg = 0;
+    std::size_t i = 0;
+    while (i < n) {
+      seg = findSegment(ts[i], seg);
+
+      std::size_t j = i + 1;
+      while (j < n && (seg == 0 || m_times[seg] <= ts[j]) &&
+             (seg == last || ts[j] < m_times[seg + 1])) {
+        j++;
+      }
+
+      if (j - i < simd::MIN_RUN) {
+        for (; i < j; i++) {
+          out[i] = deriv == 0 ? evalPos(seg, ts[i])
+                   : deriv == 1 ? evalVel(seg, ts[i])
+                                : evalAcc(seg, ts[i]);
+        }
+        continue;
+      }
+
+      simd::evalSegment<D>(&m_coefs[4 * D * seg], m_times[seg], m_invH[seg],
+                           deriv, ts + i, j - i, out + i);
+      i = j;
+    }
+  }
+
+  /**
+   * Evaluates position on a segment
+   */
+  Vector<D> evalPos(const int seg, const double t) const {
+    const T u = static_cast<T>((t - m_times[seg]) * m_invH[seg]);
+    const T *c = &m_coefs[4 * D * seg];
+
+    Vector<D> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] =
+          c[dim] + u * (c[D + dim] + u * (c[2 * D + dim] + u * c[3 * D + dim]));
+    }
+
+    return res;
+  }
+
+  /**
+   * Evaluates velocity on a segment
+   */
+  Vector<D> evalVel(const int seg, const double t) const {
+    const double invH = m_invH[seg];
+    const T u = static_cast<T>((t - m_times[seg]) * invH);
+    const T *c = &m_coefs[4 * D * seg];
+
+    Vector<D> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] =
+          (c[D + dim] + u * (2 * c[2 * D + dim] + u * 3 * c[3 * D + dim])) *
+          invH;
+    }
+
+    return res;
+  }
+
+  /**
+   * Evaluates acceleration on a segment
+   */
+  Vector<D> evalAcc(const int seg, const double t) const {
+    const double invH = m_invH[seg];
+    const T u = static_cast<T>((t - m_times[seg]) * invH);
+    const T *c = &m_coefs[4 * D * seg];
+
+    Vector<D> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] = (2 * c[2 * D + dim] + 6 * u * c[3 * D + dim]) * invH * invH;
+    }
+
+    return res;
+  }
+
+  /**
+   * Evaluates position, velocity, and acceleration on a segment
+   */
+  State<D> evalState(const int seg, const double t) const {
+    const double invH = m_invH[seg];
+    const T u = static_cast<T>((t - m_times[seg]) * invH);
+    const T *c = &m_coefs[4 * D * seg];
+
+    State<D> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      const T c0 = c[dim];
+      const T c1 = c[D + dim];
+      const T c2 = c[2 * D + dim];
+      const T c3 = c[3 * D + dim];
+
+      res.pos[dim] = c0 + u * (c1 + u * (c2 + u * c3));
+      res.vel[dim] = (c1 + u * (2 * c2 + u * 3 * c3)) * invH;
+      res.acc[dim] = (2 * c2 + 6 * u * c3) * invH * invH;
+    }
+
+    return res;
+  }
+};
+} // namespace hermite
@@ -6,12 +6,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "hermite/base_spline.hpp"
+#include "hermite/bounding_box.hpp"
+#include "hermite/compiled.hpp"
 #include "hermite/cubic/cubic_vec.hpp"
+#include "hermite/cubic/cubic_workspace.hpp"
+#include "hermite/poly/poly.hpp"
 #include "hermite/pose.hpp"
+#include "hermite/segment_cache.hpp"
+#include "hermite/state.hpp"
 #include "hermite/thirdparty/simplevectors.hpp"
 
 namespace hermite {
@@ -39,10 +50,197 @@ namespace hermite {
  * points. To use it for another set, it is highly recommended to insert/delete
  * points from the Hermite class and use the output of
  * Hermite::getAllWaypoints() to generate the points in the constructor to
- * ensure defined behavior.
+ * ensure defined behavior. If a new spline is built in a loop, rebuild()
+ * reuses the memory of this one instead.
+ *
+ * The positions and velocities of the waypoints, and the second derivatives
+ * of the solved spline, are stored as T, which is double by default. With
+ * float, a spline takes about half the memory. It is still solved and
+ * evaluated in double, and the times stay double so that each segment is
+ * evaluated from the offset of the time into it, but the stored values are
+ * rounded to about 7 significant digits, so results carry a relative error of
+ * about 1e-7 of the largest position nearby.
+ *
+ * Arc length, extrema, bounding boxes, and closest points are answered from
+ * measurements of the segments that are taken by the first such query after
+ * the spline is built or modified. Like the other const methods, these queries
+ * can be called from several threads at once, but not while the spline is
+ * being modified.
  */
-template <std::size_t D> class Cubic : public BaseSpline<D> {
+template <std::size_t D, typename T = double>
+class Cubic : public BaseSpline<D> {
 public:
+  /**
+   * @brief Evaluation cursor
+   *
+   * Remembers the segment that it last evaluated, so evaluating at a time
+   * close to the previous one (e.g. stepping forward in a control loop) takes
+   * amortized constant time instead of bisecting over all waypoints. If the
+   * time jumps far away, then the search takes logarithmic time.
+   *
+   * @note The Cubic object must outlive the cursor.
+   */
+  class Cursor {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param spline Cubic object to evaluate
+     */
+    explicit Cursor(const Cubic<D, T> &spline) : m_spline{&spline}, m_klo{0} {}
+
+    /**
+     * @brief Gets position at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as Cubic::getPos()
+     */
+    Vector<D> getPos(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_spline->m_spl.splpos(t, m_klo);
+    }
+
+    /**
+     * @brief Gets velocity at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as Cubic::getVel()
+     */
+    Vector<D> getVel(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_spline->m_spl.splvel(t, m_klo);
+    }
+
+    /**
+     * @brief Gets acceleration at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as Cubic::getAcc()
+     */
+    Vector<D> getAcc(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_spline->m_spl.splacc(t, m_klo);
+    }
+
+    /**
+     * @brief Gets position, velocity, and acceleration at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as Cubic::getState()
+     */
+    State<D> getState(const double t) {
+      if (!seek(t)) {
+        return State<D>{};
+      }
+
+      return m_spline->m_spl.splstate(t, m_klo);
+    }
+
+    /**
+     * @brief Forgets the current segment
+     */
+    void reset() { m_klo = 0; }
+
+  private:
+    const Cubic<D, T> *m_spline;
+    int m_klo;
+
+    /**
+     * Moves the cursor to the segment containing a certain time
+     *
+     * @returns False if there are not enough waypoints to evaluate
+     */
+    bool seek(const double t) {
+      if (m_spline->m_waypoints.size() < 2) {
+        return false;
+      }
+
+      m_klo = m_spline->m_spl.findSegment(t, m_klo);
+      return true;
+    }
+  };
+
+  /**
+   * @brief Cursor for following the spline by arc length
+   *
+   * Remembers where it last was, so moving a short distance from the previous
+   * query, such as stepping along the path in a control loop, takes amortized
+   * constant time: it only integrates from the previous answer instead of
+   * searching the whole spline.
+   *
+   * The cursor notices when the Cubic object has been modified and searches
+   * again, but the Cubic object must outlive the cursor.
+   */
+  class DistanceCursor {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param spline Cubic object to follow
+     */
+    explicit DistanceCursor(const Cubic<D, T> &spline)
+        : m_spline{&spline}, m_cursor{spline} {}
+
+    /**
+     * @brief Gets the time at a certain arc length from the first waypoint
+     *
+     * @param dist Arc length from the first waypoint
+     *
+     * @returns Same as Cubic::getTimeAtDistance()
+     */
+    double getTime(const double dist) {
+      return m_spline->getCache().getTimeAtDistance(dist, m_hint);
+    }
+
+    /**
+     * @brief Gets position at a certain arc length from the first waypoint
+     *
+     * @param dist Arc length from the first waypoint
+     *
+     * @returns Same as Cubic::getPosAtDistance()
+     */
+    Vector<D> getPos(const double dist) {
+      return m_cursor.getPos(getTime(dist));
+    }
+
+    /**
+     * @brief Gets velocity at a certain arc length from the first waypoint
+     *
+     * @param dist Arc length from the first waypoint
+     *
+     * @returns Velocity at getTime()
+     */
+    Vector<D> getVel(const double dist) {
+      return m_cursor.getVel(getTime(dist));
+    }
+
+    /**
+     * @brief Forgets where the cursor was
+     */
+    void reset() {
+      m_hint = typename SegmentCache<D>::Hint{};
+      m_cursor.reset();
+    }
+
+  private:
+    const Cubic<D, T> *m_spline;
+    Cursor m_cursor;
+    typename SegmentCache<D>::Hint m_hint;
+  };
+
   /**
    * @brief Default constructor
    *
@@ -62,24 +260,28 @@ public:
    * @note Make sure that there are no two waypoints that share the same time,
    * or there will be undefined behavior.
    */
-  Cubic(const std::vector<Pose<D>> &waypoints) : m_waypoints{waypoints} {
-    std::sort(m_waypoints.begin(), m_waypoints.end(),
-              [](const Pose<D> &a, const Pose<D> &b) {
-                return a.getTime() < b.getTime();
-              });
-    m_spl = CubicVec<D>{m_waypoints};
+  Cubic(const std::vector<Pose<D, T>> &waypoints)
+      : m_waypoints{sortWaypoints(waypoints)} {
+    // the spline is solved in place rather than copied from a temporary
+    if (m_waypoints.size() >= 2) {
+      m_spl.solve(m_waypoints);
+    }
   }
 
   /**
    * @brief Copy constructor
    */
-  Cubic(const Cubic<D> &other)
-      : m_waypoints{other.m_waypoints}, m_spl{other.m_spl} {}
+  Cubic(const Cubic<D, T> &other)
+      : m_waypoints{other.m_waypoints}, m_spl{other.m_spl} {
+    std::lock_guard<std::mutex> lock{other.m_cacheMutex};
+    m_cache = other.m_cache;
+    m_cacheValid = other.m_cacheValid.load();
+  }
 
   /**
    * @brief Assignment operator
    */
-  Cubic<D> &operator=(const Cubic<D> &other) {
+  Cubic<D, T> &operator=(const Cubic<D, T> &other) {
     if (this == &other) {
       return *this;
     }
@@ -87,6 +289,10 @@ public:
     m_waypoints = other.m_waypoints;
     m_spl = other.m_spl;
 
+    std::lock_guard<std::mutex> lock{other.m_cacheMutex};
+    m_cache = other.m_cache;
+    m_cacheValid = other.m_cacheValid.load();
+
     return *this;
   }
 
@@ -95,12 +301,166 @@ public:
    */
   ~Cubic() override = default;
 
+  /**
+   * @brief Replaces the spline with one through new waypoints
+   *
+   * Same as assigning a newly constructed spline, but reuses the memory of
+   * this one. Once this object has held as many waypoints, this does not
+   * allocate, unless the spline is large enough to be solved in parallel.
+   *
+   * @param waypoints A list of waypoints
+   *
+   * @note Sorts the waypoints
+   * @note Make sure that there are no two waypoints that share the same time,
+   * or there will be undefined behavior.
+   */
+  void rebuild(const std::vector<Pose<D, T>> &waypoints) {
+    m_waypoints.assign(waypoints.begin(), waypoints.end());
+    sortByTime(m_waypoints);
+    m_cacheValid = false;
+    if (m_waypoints.size() >= 2) {
+      m_spl.solve(m_waypoints);
+    }
+  }
+
+  /**
+   * @brief Replaces the spline with one through new waypoints, using a
+   * workspace
+   *
+   * Same as rebuild(), but the scratch memory for the solve comes from a
+   * workspace, which can be shared by many splines.
+   *
+   * @param waypoints A list of waypoints
+   * @param workspace Scratch memory
+   *
+   * @note Sorts the waypoints
+   * @note Make sure that there are no two waypoints that share the same time,
+   * or there will be undefined behavior.
+   */
+  void rebuild(const std::vector<Pose<D, T>> &waypoints,
+               CubicWorkspace &workspace) {
+    m_waypoints.assign(waypoints.begin(), waypoints.end());
+    sortByTime(m_waypoints);
+    m_cacheValid = false;
+    if (m_waypoints.size() >= 2) {
+      m_spl.solve(m_waypoints, workspace);
+    }
+  }
+
+  /**
+   * @brief Solves the spline again for new positions and end velocities
+   *
+   * For loops where the waypoint times stay the same and only the positions
+   * change. The factorization of the spline system only depends on the times,
+   * so it is kept from the constructor and reused. This takes linear time, and
+   * does not sort or allocate memory, unless the spline is large enough to be
+   * solved in parallel.
+   *
+   * @param positions New position of each waypoint, in order of time
+   * @param startVel New velocity at the first waypoint
+   * @param endVel New velocity at the last waypoint
+   *
+   * @returns False, without changing anything, if there are fewer than 2
+   * waypoints or the number of positions is not the number of waypoints
+   */
+  bool resolve(const std::vector<Vector<D>> &positions,
+               const Vector<D> &startVel, const Vector<D> &endVel) {
+    if (!setPositions(positions, startVel, endVel)) {
+      return false;
+    }
+
+    m_cacheValid = false;
+    m_spl.resolve(positions.data(), startVel, endVel);
+    return true;
+  }
+
+  /**
+   * @brief Solves the spline again for new positions and end velocities, using
+   * a workspace
+   *
+   * Same as resolve(), but the scratch memory for the solve comes from a
+   * workspace, which can be shared by many splines.
+   *
+   * @param positions New position of each waypoint, in order of time
+   * @param startVel New velocity at the first waypoint
+   * @param endVel New velocity at the last waypoint
+   * @param workspace Scratch memory
+   *
+   * @returns False, without changing anything, if there are fewer than 2
+   * waypoints or the number of positions is not the number of waypoints
+   */
+  bool resolve(const std::vector<Vector<D>> &positions,
+               const Vector<D> &startVel, const Vector<D> &endVel,
+               CubicWorkspace &workspace) {
+    if (!setPositions(positions, startVel, endVel)) {
+      return false;
+    }
+
+    m_cacheValid = false;
+    m_spl.resolve(positions.data(), startVel, endVel, workspace);
+    return true;
+  }
+
   /**
    * @brief Gets a list of all waypoints
    *
    * @returns A list of all waypoints, sorted in order of time.
    */
-  std::vector<Pose<D>> getAllWaypoints() const { return m_waypoints; }
+  std::vector<Pose<D, T>> getAllWaypoints() const { return m_waypoints; }
+
+  /**
+   * @brief Compiles the spline into a table of polynomial coefficients
+   *
+   * Converts every segment into the power basis and stores them
+   * contiguously, so evaluating the result takes one search and one Horner
+   * pass. Use this if the spline is built once and evaluated many times.
+   *
+   * @tparam C Scalar type of the coefficients. Use float to halve the size of
+   * the table, at the cost of precision described in CompiledSpline.
+   *
+   * @returns Compiled spline
+   */
+  template <typename C = double> CompiledSpline<D, C> compile() const {
+    std::vector<double> times;
+    std::vector<double> coefs;
+    getTable(times, coefs);
+
+    return CompiledSpline<D, C>{std::move(times),
+                                convertCoefficients<C>(std::move(coefs))};
+  }
+
+  /**
+   * @brief Checks whether the waypoints are evenly spaced in time
+   *
+   * If they are, within UNIFORM_TOLERANCE of the spacing, then segments are
+   * found in constant time instead of with a binary search.
+   *
+   * @returns True if the waypoints are evenly spaced
+   */
+  bool isUniform() const { return m_spl.isUniform(); }
+
+  /**
+   * @brief Builds a search index over the waypoint times
+   *
+   * Speeds up getPos(), getVel(), getAcc(), and getState() at random times when
+   * there are many waypoints, at the cost of a second copy of the times.
+   * Cursors and batches walk from the previous segment instead, so they
+   * do not use the index.
+   *
+   * Once built, the index is kept: rebuild() builds it again over the new
+   * waypoint times.
+   *
+   * @see KnotIndex
+   */
+  void buildIndex() { m_spl.buildIndex(); }
+
+  /**
+   * @brief Checks whether the search index has been built
+   *
+   * @returns True if buildIndex() has been called, even if the spline has
+   * been rebuilt since
+   */
+  bool hasIndex() const { return m_spl.hasIndex(); }
 
   /**
    * @brief Gets the lower bound of the domain of the piecewise spline function,
@@ -201,6 +561,111 @@ public:
     return m_spl.splacc(t);
   }
 
+  /**
+   * @brief Gets position, velocity, and acceleration at a certain time
+   *
+   * Only searches for the segment once, so this is faster than calling
+   * getPos(), getVel(), and getAcc() separately.
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns zero
+   * vectors.
+   *
+   * @param t Time
+   *
+   * @returns Position, velocity, and acceleration
+   */
+  State<D> getState(const double t) const override {
+    if (m_waypoints.size() < 2) {
+      return State<D>{};
+    }
+
+    return m_spl.splstate(t);
+  }
+
+  /**
+   * @brief Gets positions at many times at once
+   *
+   * @note If the times are sorted, then the segment is only searched for when
+   * the time moves past the next waypoint.
+   * @note If number of waypoints is less than or equal to 1, then fills the
+   * output with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getPosBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    if (m_waypoints.size() < 2) {
+      std::fill(out, out + n, Vector<D>{});
+      return;
+    }
+
+    m_spl.splposBatch(ts, n, out);
+  }
+
+  /**
+   * @brief Gets velocities at many times at once
+   *
+   * @note If number of waypoints is less than or equal to 1, then fills the
+   * output with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getVelBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    if (m_waypoints.size() < 2) {
+      std::fill(out, out + n, Vector<D>{});
+      return;
+    }
+
+    m_spl.splvelBatch(ts, n, out);
+  }
+
+  /**
+   * @brief Gets accelerations at many times at once
+   *
+   * @note If number of waypoints is less than or equal to 1, then fills the
+   * output with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getAccBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    if (m_waypoints.size() < 2) {
+      std::fill(out, out + n, Vector<D>{});
+      return;
+    }
+
+    m_spl.splaccBatch(ts, n, out);
+  }
+
+  /**
+   * @brief Gets positions, velocities, and accelerations at many times at once
+   *
+   * @note If number of waypoints is less than or equal to 1, then fills the
+   * output with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n states
+   */
+  void getStateBatch(const double ts[], const std::size_t n,
+                     State<D> out[]) const override {
+    if (m_waypoints.size() < 2) {
+      std::fill(out, out + n, State<D>{});
+      return;
+    }
+
+    m_spl.splstateBatch(ts, n, out);
+  }
+
   /**
    * @brief Gets arc length
    *
@@ -233,8 +698,372 @@ public:
     return res;
   }
 
+  using BaseSpline<D>::getMaxDistance;
+  using BaseSpline<D>::getMaxSpeed;
+  using BaseSpline<D>::getMaxAcceleration;
+
+  /**
+   * @brief Gets maximum distance from origin exactly
+   *
+   * The maximum of each segment is cached along with its arc length, so this
+   * takes constant time until the spline is rebuilt or solved again.
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Maximum distance from the origin
+   *
+   * @see Hermite::getMaxDistance()
+   */
+  double getMaxDistance() const { return getMaxMagn(0); }
+
+  /**
+   * @brief Gets maximum distance from origin exactly between two times
+   *
+   * Takes logarithmic time, plus the time to check the partial segments at the
+   * ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the domain of the waypoints, and may be in
+   * either order.
+   *
+   * @returns Maximum distance from the origin
+   *
+   * @see Hermite::getMaxDistance(double, double)
+   */
+  double getMaxDistance(const double t0, const double t1) const {
+    return getCache().getMax(t0, t1, 0);
+  }
+
+  /**
+   * @brief Gets maximum speed exactly
+   *
+   * The maximum of each segment is cached along with its arc length, so this
+   * takes constant time until the spline is rebuilt or solved again.
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Maximum speed
+   *
+   * @see Hermite::getMaxSpeed()
+   */
+  double getMaxSpeed() const { return getMaxMagn(1); }
+
+  /**
+   * @brief Gets maximum speed exactly between two times
+   *
+   * Takes logarithmic time, plus the time to check the partial segments at the
+   * ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the domain of the waypoints, and may be in
+   * either order.
+   *
+   * @returns Maximum speed
+   *
+   * @see Hermite::getMaxSpeed(double, double)
+   */
+  double getMaxSpeed(const double t0, const double t1) const {
+    return getCache().getMax(t0, t1, 1);
+  }
+
+  /**
+   * @brief Gets maximum magnitude of acceleration exactly
+   *
+   * The maximum of each segment is cached along with its arc length, so this
+   * takes constant time until the spline is rebuilt or solved again.
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Magnitude of maximum acceleration
+   *
+   * @see Hermite::getMaxAcceleration()
+   */
+  double getMaxAcceleration() const { return getMaxMagn(2); }
+
+  /**
+   * @brief Gets maximum magnitude of acceleration exactly between two times
+   *
+   * Takes logarithmic time, plus the time to check the partial segments at the
+   * ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the domain of the waypoints, and may be in
+   * either order.
+   *
+   * @returns Magnitude of maximum acceleration
+   *
+   * @see Hermite::getMaxAcceleration(double, double)
+   */
+  double getMaxAcceleration(const double t0, const double t1) const {
+    return getCache().getMax(t0, t1, 2);
+  }
+
+  /**
+   * @brief Gets the smallest axis-aligned box that contains the spline
+   *
+   * The box of each segment is cached along with its arc length, so this takes
+   * constant time until the spline is rebuilt or solved again.
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns an
+   * empty box.
+   *
+   * @returns Bounding box
+   *
+   * @see Hermite::getBoundingBox()
+   */
+  BoundingBox<D> getBoundingBox() const {
+    return getCache().getTree().getAll().box;
+  }
+
+  /**
+   * @brief Gets the smallest axis-aligned box that contains the spline between
+   * two times
+   *
+   * Takes logarithmic time, plus the time to bound the partial segments at the
+   * ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the domain of the waypoints, and may be in
+   * either order.
+   *
+   * @returns Bounding box
+   */
+  BoundingBox<D> getBoundingBox(const double t0, const double t1) const {
+    return getCache().getBox(t0, t1);
+  }
+
+  /**
+   * @brief Gets the bounding box of every segment
+   *
+   * @returns Boxes, where box i contains the segment between waypoints i and
+   * i + 1
+   *
+   * @see Hermite::getBoundingBoxes()
+   */
+  std::vector<BoundingBox<D>> getBoundingBoxes() const {
+    const SegmentCache<D> &cache = getCache();
+
+    std::vector<BoundingBox<D>> res;
+    res.reserve(cache.getSegmentCount());
+    for (std::size_t seg = 0; seg < cache.getSegmentCount(); seg++) {
+      res.push_back(cache.getTree().get(seg).box);
+    }
+    return res;
+  }
+
+  /**
+   * @brief Gets the time at which the spline is closest to a point
+   *
+   * @param point Point
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Time of the closest point
+   *
+   * @see Hermite::getClosestTime()
+   */
+  double getClosestTime(const Vector<D> &point) const {
+    return getCache().getClosestTime(point);
+  }
+
+  /**
+   * @brief Gets the time at which the spline is closest to a point, starting
+   * from a nearby time
+   *
+   * @param point Point
+   * @param hint Time to start from
+   *
+   * @returns Time of the closest point
+   *
+   * @see Hermite::getClosestTime(const Vector<D> &, double)
+   */
+  double getClosestTime(const Vector<D> &point, const double hint) const {
+    return getCache().getClosestTime(point, hint);
+  }
+
+  /**
+   * @brief Gets arc length exactly
+   *
+   * Each segment is measured once with adaptive Gauss-Legendre quadrature and
+   * cached, along with a running total, so this takes constant time until the
+   * spline is rebuilt or solved again.
+   *
+   * @note The lengths are measured by the first query after a modification,
+   * which is guarded, so several threads can query at once.
+   * @note If zero or one waypoints, returns 0.
+   *
+   * @returns Arc length over the domain of the waypoints
+   */
+  double getLength() const { return getCache().getLength(); }
+
+  /**
+   * @brief Gets arc length between two times
+   *
+   * Takes logarithmic time, plus the time to measure the partial segments at
+   * the ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the domain of the waypoints.
+   *
+   * @returns Arc length, which is negative if t1 < t0
+   *
+   * @see getLength()
+   */
+  double getLength(const double t0, const double t1) const {
+    return getCache().getLength(t0, t1);
+  }
+
+  /**
+   * @brief Gets the time at which the arc length from the first waypoint
+   * reaches a certain distance
+   *
+   * Finds the segment in logarithmic time from the cached lengths, and then
+   * solves for the time within it with Newton's method on the speed. To follow
+   * the path at a steady pace, use a DistanceCursor instead.
+   *
+   * @param dist Arc length from the first waypoint, which is clamped to the
+   * range from 0 to getLength()
+   *
+   * @note If the spline stops, then the first time that it reaches the
+   * distance is not always the one returned.
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Time
+   *
+   * @see getLength()
+   */
+  double getTimeAtDistance(const double dist) const {
+    return getCache().getTimeAtDistance(dist);
+  }
+
+  /**
+   * @brief Gets position at a certain arc length from the first waypoint
+   *
+   * @param dist Arc length from the first waypoint
+   *
+   * @returns Position at getTimeAtDistance()
+   */
+  Vector<D> getPosAtDistance(const double dist) const {
+    return getPos(getTimeAtDistance(dist));
+  }
+
 private:
-  std::vector<Pose<D>> m_waypoints;
-  CubicVec<D> m_spl;
+  std::vector<Pose<D, T>> m_waypoints;
+  CubicVec<D, T> m_spl;
+
+  // measurements of the segments, brought up to date on demand. Once
+  // m_cacheValid is set, the cache is only read until the spline is modified.
+  mutable SegmentCache<D> m_cache;
+  mutable std::atomic<bool> m_cacheValid{false};
+  mutable std::mutex m_cacheMutex; // held while updating the cache
+
+  /**
+   * Gets the times of the waypoints and the coefficients of every segment in
+   * the power basis, laid out as in CompiledSpline::CompiledSpline()
+   */
+  void getTable(std::vector<double> &times, std::vector<double> &coefs) const {
+    times.clear();
+    times.reserve(m_waypoints.size());
+    for (const auto &waypoint : m_waypoints) {
+      times.push_back(waypoint.getTime());
+    }
+
+    coefs.clear();
+    if (m_waypoints.size() >= 2) {
+      coefs.resize(4 * D * (m_waypoints.size() - 1));
+      for (std::size_t seg = 0; seg + 1 < m_waypoints.size(); seg++) {
+        m_spl.getPowerBasis(static_cast<int>(seg), &coefs[4 * D * seg]);
+      }
+    }
+  }
+
+  /**
+   * Brings the measurements of the segments up to date. Several threads can
+   * call this at once, and only the first one measures.
+   *
+   * @returns The cache
+   */
+  const SegmentCache<D> &getCache() const {
+    if (m_cacheValid.load(std::memory_order_acquire)) {
+      return m_cache;
+    }
+
+    std::lock_guard<std::mutex> lock{m_cacheMutex};
+    if (!m_cacheValid.load(std::memory_order_relaxed)) {
+      std::vector<double> times;
+      std::vector<double> coefs;
+      getTable(times, coefs);
+      m_cache.assign(std::move(times), std::move(coefs));
+      m_cacheValid.store(true, std::memory_order_release);
+    }
+
+    return m_cache;
+  }
+
+  /**
+   * Gets the largest magnitude of a derivative over all segments
+   *
+   * @param deriv 0 for position, 1 for velocity, 2 for acceleration
+   */
+  double getMaxMagn(const int deriv) const {
+    return getCache().getTree().getAll().maxMagn[deriv];
+  }
+
+  /**
+   * Replaces the positions of the waypoints and the end velocities
+   *
+   * @returns False, without changing anything, if there are fewer than 2
+   * waypoints or the number of positions is not the number of waypoints
+   */
+  bool setPositions(const std::vector<Vector<D>> &positions,
+                    const Vector<D> &startVel, const Vector<D> &endVel) {
+    const std::size_t n = m_waypoints.size();
+    if (n < 2 || positions.size() != n) {
+      return false;
+    }
+
+    for (std::size_t i = 0; i < n; i++) {
+      m_waypoints[i].setPos(positions[i]);
+    }
+    m_waypoints[0].setVel(startVel);
+    m_waypoints[n - 1].setVel(endVel);
+
+    return true;
+  }
+
+  /**
+   * Copies waypoints and sorts them by time, skipping the sort if they are
+   * already sorted
+   */
+  static std::vector<Pose<D, T>>
+  sortWaypoints(const std::vector<Pose<D, T>> &waypoints) {
+    std::vector<Pose<D, T>> res{waypoints};
+    sortByTime(res);
+    return res;
+  }
+
+  /**
+   * Sorts waypoints by time in place, skipping the sort if they are already
+   * sorted
+   */
+  static void sortByTime(std::vector<Pose<D, T>> &waypoints) {
+    const auto byTime = [](const Pose<D, T> &a, const Pose<D, T> &b) {
+      return a.getTime() < b.getTime();
+    };
+
+    if (!std::is_sorted(waypoints.begin(), waypoints.end(), byTime)) {
+      std::sort(waypoints.begin(), waypoints.end(), byTime);
+    }
+  }
 };
 } // namespace hermite
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 namespace hermite {
@@ -21,13 +22,16 @@ namespace hermite {
  * @param yp1 The velocity at the first point
  * @param ypn The velocity at the last point
  * @param y2 Output array, filled with second derivatives at each point.
+ * @param u Workspace array of n numbers, overwritten
+ *
+ * @note Does not allocate, so this can be used where heap allocation is not
+ * allowed.
  */
 inline void spline(const double t[], const double y[], const int n,
-                   const double yp1, const double ypn, double y2[]) {
+                   const double yp1, const double ypn, double y2[],
+                   double u[]) {
   int i, k;
   double p, qn, sig, un;
-  std::vector<double> u;
-  u.resize(n + 2);
 
   if (yp1 > 0.99e30) {
     // y2[1] = u[1] = 0.0;
@@ -61,27 +65,314 @@ inline void spline(const double t[], const double y[], const int n,
 }
 
 /**
- * @brief Calculates position of spline
+ * @brief Calculates second derivatives at tabulated points
+ *
+ * Same as the overload taking a workspace, but allocates the workspace.
+ *
+ * @param t The time values of each point where splines are supposed to join
+ * up.
+ * @param y The y-values of each know point.
+ * @param n Number of points.
+ * @param yp1 The velocity at the first point
+ * @param ypn The velocity at the last point
+ * @param y2 Output array, filled with second derivatives at each point.
+ */
+inline void spline(const double t[], const double y[], const int n,
+                   const double yp1, const double ypn, double y2[]) {
+  std::vector<double> u;
+  u.resize(n + 2);
+  spline(t, y, n, yp1, ypn, y2, u.data());
+}
+
+/**
+ * @brief Factorizes the spline system for clamped ends
+ *
+ * https://archive.org/details/NumericalRecipes/page/n139/mode/2up
+ *
+ * The elimination factors in spline() only depend on the time values, so they
+ * can be calculated once and shared by every dimension with splsolve(). This
+ * only applies when the velocities at both ends are given, since natural ends
+ * change the factors.
+ *
+ * @param t The time values of each point where splines are supposed to join
+ * up.
+ * @param n Number of points, at least 2.
+ * @param fac Output array of 4 * n numbers. For each point i, fac[4 * i] is
+ * the reciprocal of the length of the interval after it, fac[4 * i + 1] and
+ * fac[4 * i + 2] are the weights of the new data and of the previous point
+ * in the forward substitution, and fac[4 * i + 3] is the weight of the next
+ * point in the back substitution.
+ */
+inline void splfactor(const double t[], const int n, double fac[]) {
+  int i;
+  double sig, p;
+
+  fac[0] = 1.0 / (t[1] - t[0]);
+  fac[1] = 3.0 * fac[0];
+  fac[2] = 0.0;
+  fac[3] = -0.5;
+
+  for (i = 1; i <= n - 2; i++) {
+    sig = (t[i] - t[i - 1]) / (t[i + 1] - t[i - 1]);
+    p = sig * fac[4 * (i - 1) + 3] + 2.0;
+    fac[4 * i] = 1.0 / (t[i + 1] - t[i]);
+    fac[4 * i + 1] = 6.0 / ((t[i + 1] - t[i - 1]) * p);
+    fac[4 * i + 2] = sig / p;
+    fac[4 * i + 3] = (sig - 1.0) / p;
+  }
+
+  // the last point uses the reciprocal of its denominator instead
+  fac[4 * (n - 1)] = 0.0;
+  fac[4 * (n - 1) + 1] = 3.0 * fac[4 * (n - 2)];
+  fac[4 * (n - 1) + 2] = 0.5;
+  fac[4 * (n - 1) + 3] = 1.0 / (0.5 * fac[4 * (n - 2) + 3] + 1.0);
+}
+
+/**
+ * @brief Calculates second derivatives of many splines with the same time
+ * values at once
+ *
+ * Same as calling spline() on each spline with clamped ends, but the
+ * elimination factors come from splfactor(), and the splines are interleaved
+ * so that the inner loops run across splines and can be vectorized.
+ *
+ * @param fac Factors from splfactor()
+ * @param y The y-values of each known point, interleaved, so y[i * m + j] is
+ * the value of spline j at point i.
+ * @param n Number of points, at least 2.
+ * @param m Number of splines
+ * @param yp1 The velocity of each spline at the first point
+ * @param ypn The velocity of each spline at the last point
+ * @param y2 Output array of n * m numbers, filled with second derivatives,
+ * interleaved like y.
+ *
+ * @note Does not allocate, and uses y2 for the intermediate values.
+ */
+inline void splsolve(const double fac[], const double y[], const int n,
+                     const int m, const double yp1[], const double ypn[],
+                     double y2[]) {
+  int i, j;
+
+  // forward substitution, storing the intermediate values in y2
+  for (j = 0; j < m; j++) {
+    y2[j] = fac[1] * ((y[m + j] - y[j]) * fac[0] - yp1[j]);
+  }
+
+  for (i = 1; i <= n - 2; i++) {
+    const double invH = fac[4 * i];
+    const double invHPrev = fac[4 * (i - 1)];
+    const double w = fac[4 * i + 1];
+    const double sp = fac[4 * i + 2];
+    const double *yPrev = y + (i - 1) * m;
+    const double *yCur = y + i * m;
+    const double *yNext = y + (i + 1) * m;
+    const double *uPrev = y2 + (i - 1) * m;
+    double *u = y2 + i * m;
+
+    for (j = 0; j < m; j++) {
+      const double d =
+          (yNext[j] - yCur[j]) * invH - (yCur[j] - yPrev[j]) * invHPrev;
+      u[j] = d * w - sp * uPrev[j];
+    }
+  }
+
+  const double *last = fac + 4 * (n - 1);
+  const double invHLast = fac[4 * (n - 2)];
+  for (j = 0; j < m; j++) {
+    const double slope = (y[(n - 1) * m + j] - y[(n - 2) * m + j]) * invHLast;
+    const double un = last[1] * (ypn[j] - slope);
+    y2[(n - 1) * m + j] = (un - last[2] * y2[(n - 2) * m + j]) * last[3];
+  }
+
+  // back substitution
+  for (i = n - 2; i >= 0; i--) {
+    const double c = fac[4 * i + 3];
+    const double *next = y2 + (i + 1) * m;
+    double *cur = y2 + i * m;
+
+    for (j = 0; j < m; j++) {
+      cur[j] = c * next[j] + cur[j];
+    }
+  }
+}
+
+/**
+ * @brief Gets one row of the spline system
+ *
+ * Row i of the system is a * y2[i - 1] + b * y2[i] + c * y2[i + 1] = r, which
+ * is the system that spline() eliminates, before scaling.
+ *
+ * @param t The time values of each point
+ * @param n Number of points, at least 2.
+ * @param natStart True if the first point has a natural end
+ * @param natEnd True if the last point has a natural end
+ * @param i Index of the row
+ * @param a Output, the weight of the previous point
+ * @param b Output, the weight of the point
+ * @param c Output, the weight of the next point
+ */
+inline void splrow(const double t[], const int n, const bool natStart,
+                   const bool natEnd, const int i, double &a, double &b,
+                   double &c) {
+  if (i == 0) {
+    const double h = t[1] - t[0];
+    a = 0.0;
+    b = natStart ? 1.0 : h / 3.0;
+    c = natStart ? 0.0 : h / 6.0;
+  } else if (i == n - 1) {
+    const double h = t[n - 1] - t[n - 2];
+    a = natEnd ? 0.0 : h / 6.0;
+    b = natEnd ? 1.0 : h / 3.0;
+    c = 0.0;
+  } else {
+    const double hPrev = t[i] - t[i - 1];
+    const double h = t[i + 1] - t[i];
+    a = hPrev / 6.0;
+    b = (hPrev + h) / 3.0;
+    c = h / 6.0;
+  }
+}
+
+/**
+ * @brief Gets the right-hand side of one row of the spline system
+ *
+ * @param t The time values of each point
+ * @param y The y-values of the spline, interleaved like in splsolve()
+ * @param n Number of points, at least 2.
+ * @param m Number of splines
+ * @param yp1 The velocity of each spline at the first point
+ * @param ypn The velocity of each spline at the last point
+ * @param i Index of the row
+ * @param j Index of the spline
+ *
+ * @returns The right-hand side of row i of spline j
+ */
+inline double splrhs(const double t[], const double y[], const int n,
+                     const int m, const double yp1[], const double ypn[],
+                     const int i, const int j) {
+  if (i == 0) {
+    if (yp1[j] > 0.99e30) {
+      return 0.0;
+    }
+
+    return (y[m + j] - y[j]) / (t[1] - t[0]) - yp1[j];
+  }
+
+  if (i == n - 1) {
+    if (ypn[j] > 0.99e30) {
+      return 0.0;
+    }
+
+    return ypn[j] -
+           (y[(n - 1) * m + j] - y[(n - 2) * m + j]) / (t[n - 1] - t[n - 2]);
+  }
+
+  return (y[(i + 1) * m + j] - y[i * m + j]) / (t[i + 1] - t[i]) -
+         (y[i * m + j] - y[(i - 1) * m + j]) / (t[i] - t[i - 1]);
+}
+
+/**
+ * @brief Solves part of the spline system, keeping the rest fixed
+ *
+ * Solves rows lo to hi of the system for one spline, with the second
+ * derivatives just outside of those rows taken from y2. Since the effect of
+ * a change in the positions decays quickly with the distance from the change,
+ * this gives the new solution near an edit without solving the whole system.
+ * If lo is 0 and hi is n - 1, then this is the same as spline().
+ *
+ * @param t The time values of each point
+ * @param y The y-values of each known point
+ * @param n Number of points, at least 2.
+ * @param yp1 The velocity at the first point, or more than 0.99e30 for a
+ * natural end
+ * @param ypn The velocity at the last point, or more than 0.99e30 for a
+ * natural end
+ * @param lo First row to solve
+ * @param hi Last row to solve
+ * @param y2 Second derivatives, only read at lo - 1 and hi + 1
+ * @param cp Workspace array of hi - lo + 1 numbers, overwritten
+ * @param out Output array of hi - lo + 1 numbers, filled with the second
+ * derivatives at lo to hi
+ */
+inline void splwindow(const double t[], const double y[], const int n,
+                      const double yp1, const double ypn, const int lo,
+                      const int hi, const double y2[], double cp[],
+                      double out[]) {
+  const bool natStart = yp1 > 0.99e30;
+  const bool natEnd = ypn > 0.99e30;
+  int i;
+  double a, b, c;
+
+  for (i = lo; i <= hi; i++) {
+    splrow(t, n, natStart, natEnd, i, a, b, c);
+    double r = splrhs(t, y, n, 1, &yp1, &ypn, i, 0);
+
+    // the points outside of the window are known
+    if (i == lo && lo > 0) {
+      r -= a * y2[lo - 1];
+    }
+    if (i == hi && hi < n - 1) {
+      r -= c * y2[hi + 1];
+    }
+
+    const double inv = 1.0 / (i == lo ? b : b - a * cp[i - lo - 1]);
+    cp[i - lo] = i == hi ? 0.0 : c * inv;
+    out[i - lo] = (i == lo ? r : r - a * out[i - lo - 1]) * inv;
+  }
+
+  for (i = hi - 1; i >= lo; i--) {
+    out[i - lo] -= cp[i - lo] * out[i - lo + 1];
+  }
+}
+
+/**
+ * @brief Finds the segment containing a point, starting from a guess
  *
  * https://archive.org/details/NumericalRecipes/page/n139/mode/2up
  *
+ * Hunts outwards from the guess in steps of doubling size until the point is
+ * bracketed, then bisects. If the point is close to the guess, this takes
+ * constant time, and a large jump takes at most twice as long as a bisection
+ * over the whole array.
+ *
+ * Gives the same segment as the bisection in splpos(), splvel(), and splacc().
+ *
  * @param xa The time values of each point where splines are supposed to join
  * up.
- * @param ya The y-values of each know point.
- * @param y2a Second derivatives, calculated from spline()
- * @param n Number of points
- * @param x Point to evaluate
- * @param y Pointer to result
+ * @param n Number of points, at least 2.
+ * @param x Point to find
+ * @param klo Guess for the index of the lower point of the segment. If it is
+ * out of range, then bisects the whole array.
  *
- * @returns True on success, false on failure
+ * @returns Index of the lower point of the segment, between 0 and n - 2
  */
-inline bool splpos(const double xa[], const double ya[], const double y2a[],
-                   const int n, const double x, double *y) {
-  int klo, khi, k;
-  double h, b, a;
+inline int splhunt(const double xa[], const int n, const double x, int klo) {
+  int khi, k, inc;
+
+  if (klo < 0 || klo > n - 2) {
+    klo = 0;
+    khi = n - 1;
+  } else if (klo == 0 || xa[klo] <= x) {
+    // hunt up
+    inc = 1;
+    khi = klo + 1;
+    while (khi < n - 1 && xa[khi] <= x) {
+      klo = khi;
+      inc += inc;
+      khi = std::min(klo + inc, n - 1);
+    }
+  } else {
+    // hunt down
+    inc = 1;
+    khi = klo;
+    klo = khi - 1;
+    while (klo > 0 && xa[klo] > x) {
+      khi = klo;
+      inc += inc;
+      klo = std::max(khi - inc, 0);
+    }
+  }
 
-  klo = 0;
-  khi = n - 1;
   while (khi - klo > 1) {
     k = (khi + klo) >> 1;
     if (xa[k] > x) {
@@ -91,38 +382,104 @@ inline bool splpos(const double xa[], const double ya[], const double y2a[],
     }
   }
 
-  h = xa[khi] - xa[klo];
+  return klo;
+}
+
+/**
+ * @brief Calculates power basis coefficients of one segment of a spline
+ *
+ * Rewrites the segment between xa[klo] and xa[klo + 1] as
+ * c[0] + c[1]u + c[2]u^2 + c[3]u^3, where u = (x - xa[klo]) / h goes from 0
+ * to 1 over the segment.
+ *
+ * @param xa The time values of each point where splines are supposed to join
+ * up.
+ * @param ya The y-values of each know point.
+ * @param y2a Second derivatives, calculated from spline()
+ * @param klo Index of the lower point of the segment
+ * @param c Output array of 4 coefficients
+ *
+ * @tparam T Scalar type of ya and y2a, which are read into double
+ */
+template <typename T>
+inline void splcoef(const double xa[], const T ya[], const T y2a[],
+                    const int klo, double c[]) {
+  const double h = xa[klo + 1] - xa[klo];
+  const double h26 = h * h / 6.0;
+  const double ylo = ya[klo];
+  const double yhi = ya[klo + 1];
+  const double lo = y2a[klo];
+  const double hi = y2a[klo + 1];
+
+  c[0] = ylo;
+  c[1] = yhi - ylo - h26 * (2 * lo + hi);
+  c[2] = 3 * h26 * lo;
+  c[3] = h26 * (hi - lo);
+}
+
+/**
+ * @brief Location of a point within one segment of a spline
+ *
+ * Holds everything about the point that does not depend on the y-values, so
+ * it can be found once and then used to evaluate every dimension of a spline
+ * with the same time values.
+ */
+struct SplineSegment {
+  int klo;  //!< Index of the lower point of the segment
+  int khi;  //!< Index of the upper point of the segment
+  double h; //!< Length of the segment
+  double a; //!< Weight of the lower point, 1 at xa[klo] and 0 at xa[khi]
+  double b; //!< Weight of the upper point, 0 at xa[klo] and 1 at xa[khi]
+};
+
+/**
+ * @brief Locates a point within a known segment of a spline
+ *
+ * Does not search, so this is for callers that already know the segment, for
+ * example from splhunt() or their own cursor.
+ *
+ * @param xa The time values of each point where splines are supposed to join
+ * up.
+ * @param klo Index of the lower point of the segment
+ * @param x Point to locate
+ * @param seg Pointer to result
+ *
+ * @returns True on success, false if the segment has zero length
+ */
+inline bool splsegat(const double xa[], const int klo, const double x,
+                     SplineSegment *seg) {
+  const int khi = klo + 1;
+  const double h = xa[khi] - xa[klo];
   if (h == 0.0) {
     return false;
   }
 
-  a = (xa[khi] - x) / h;
-  b = (x - xa[klo]) / h;
-  *y =
-      a * ya[klo] + b * ya[khi] +
-      ((a * a * a - a) * y2a[klo] + (b * b * b - b) * y2a[khi]) * (h * h) / 6.0;
+  seg->klo = klo;
+  seg->khi = khi;
+  seg->h = h;
+  seg->a = (xa[khi] - x) / h;
+  seg->b = (x - xa[klo]) / h;
   return true;
 }
 
 /**
- * @brief Calculates velocity of spline
+ * @brief Finds the segment containing a point and locates the point in it
  *
  * https://archive.org/details/NumericalRecipes/page/n139/mode/2up
  *
+ * Bisects the whole array, so a point on a knot is in the later segment.
+ *
  * @param xa The time values of each point where splines are supposed to join
  * up.
- * @param ya The y-values of each know point.
- * @param y2a Second derivatives, calculated from spline()
  * @param n Number of points
- * @param x Point to evaluate
- * @param y Pointer to result
+ * @param x Point to locate
+ * @param seg Pointer to result
  *
- * @returns True on success, false on failure
+ * @returns True on success, false if the segment has zero length
  */
-inline bool splvel(const double xa[], const double ya[], const double y2a[],
-                   const int n, const double x, double *y) {
+inline bool splseg(const double xa[], const int n, const double x,
+                   SplineSegment *seg) {
   int klo, khi, k;
-  double h, b, a;
 
   klo = 0;
   khi = n - 1;
@@ -135,22 +492,131 @@ inline bool splvel(const double xa[], const double ya[], const double y2a[],
     }
   }
 
-  h = xa[khi] - xa[klo];
-  if (h == 0.0) {
+  return splsegat(xa, klo, x, seg);
+}
+
+/**
+ * @brief Calculates position of spline in a located segment
+ *
+ * @param ya The y-values of each know point.
+ * @param y2a Second derivatives, calculated from spline()
+ * @param seg Segment from splseg() or splsegat()
+ *
+ * @tparam T Scalar type of ya and y2a, which are read into double
+ *
+ * @returns Position
+ */
+template <typename T>
+inline double splpos(const T ya[], const T y2a[], const SplineSegment &seg) {
+  const double a = seg.a;
+  const double b = seg.b;
+  const double lo = y2a[seg.klo];
+  const double hi = y2a[seg.khi];
+  return a * ya[seg.klo] + b * ya[seg.khi] +
+         ((a * a * a - a) * lo + (b * b * b - b) * hi) * (seg.h * seg.h) /
+             6.0;
+}
+
+/**
+ * @brief Calculates velocity of spline in a located segment
+ *
+ * @param ya The y-values of each know point.
+ * @param y2a Second derivatives, calculated from spline()
+ * @param seg Segment from splseg() or splsegat()
+ *
+ * @tparam T Scalar type of ya and y2a, which are read into double
+ *
+ * @returns Velocity
+ */
+template <typename T>
+inline double splvel(const T ya[], const T y2a[], const SplineSegment &seg) {
+  const double a = seg.a;
+  const double b = seg.b;
+  const double h = seg.h;
+  const double lo = y2a[seg.klo];
+  const double hi = y2a[seg.khi];
+  return (-1 / h) * ya[seg.klo] + (1 / h) * ya[seg.khi] +
+         ((3 * a * a - 1) * lo * (-1 / h) + (3 * b * b - 1) * hi * (1 / h)) *
+             (h * h) / 6.0;
+}
+
+/**
+ * @brief Calculates acceleration of spline in a located segment
+ *
+ * @param y2a Second derivatives, calculated from spline()
+ * @param seg Segment from splseg() or splsegat()
+ *
+ * @tparam T Scalar type of y2a, which is read into double
+ *
+ * @returns Acceleration
+ */
+template <typename T>
+inline double splacc(const T y2a[], const SplineSegment &seg) {
+  const double lo = y2a[seg.klo];
+  const double hi = y2a[seg.khi];
+  return lo * seg.a + hi * seg.b;
+}
+
+/**
+ * @brief Calculates position, velocity, and acceleration of spline in a
+ * located segment
+ *
+ * @param ya The y-values of each know point.
+ * @param y2a Second derivatives, calculated from spline()
+ * @param seg Segment from splseg() or splsegat()
+ * @param y Pointer to position result
+ * @param yd Pointer to velocity result
+ * @param ydd Pointer to acceleration result
+ *
+ * @tparam T Scalar type of ya and y2a, which are read into double
+ */
+template <typename T>
+inline void splstate(const T ya[], const T y2a[], const SplineSegment &seg,
+                     double *y, double *yd, double *ydd) {
+  const double a = seg.a;
+  const double b = seg.b;
+  const double h = seg.h;
+  const double h6 = h / 6.0;
+  const double ylo = ya[seg.klo];
+  const double yhi = ya[seg.khi];
+  const double lo = y2a[seg.klo];
+  const double hi = y2a[seg.khi];
+
+  *y = a * ylo + b * yhi +
+       ((a * a * a - a) * lo + (b * b * b - b) * hi) * h * h6;
+  *yd = (yhi - ylo) / h +
+        ((1 - 3 * a * a) * lo + (3 * b * b - 1) * hi) * h6;
+  *ydd = lo * a + hi * b;
+}
+
+/**
+ * @brief Calculates position of spline
+ *
+ * https://archive.org/details/NumericalRecipes/page/n139/mode/2up
+ *
+ * @param xa The time values of each point where splines are supposed to join
+ * up.
+ * @param ya The y-values of each know point.
+ * @param y2a Second derivatives, calculated from spline()
+ * @param n Number of points
+ * @param x Point to evaluate
+ * @param y Pointer to result
+ *
+ * @returns True on success, false on failure
+ */
+inline bool splpos(const double xa[], const double ya[], const double y2a[],
+                   const int n, const double x, double *y) {
+  SplineSegment seg;
+  if (!splseg(xa, n, x, &seg)) {
     return false;
   }
 
-  a = (xa[khi] - x) / h;
-  b = (x - xa[klo]) / h;
-  *y = (-1 / h) * ya[klo] + (1 / h) * ya[khi] +
-       ((3 * a * a - 1) * y2a[klo] * (-1 / h) +
-        (3 * b * b - 1) * y2a[khi] * (1 / h)) *
-           (h * h) / 6.0;
+  *y = splpos(ya, y2a, seg);
   return true;
 }
 
 /**
- * @brief Calculates acceleration of spline
+ * @brief Calculates velocity of spline
  *
  * https://archive.org/details/NumericalRecipes/page/n139/mode/2up
  *
@@ -164,32 +630,74 @@ inline bool splvel(const double xa[], const double ya[], const double y2a[],
  *
  * @returns True on success, false on failure
  */
-inline bool splacc(const double xa[], const double ya[], const double y2a[],
+inline bool splvel(const double xa[], const double ya[], const double y2a[],
                    const int n, const double x, double *y) {
-  int klo, khi, k;
-  double h, b, a;
-
-  klo = 0;
-  khi = n - 1;
-  while (khi - klo > 1) {
-    k = (khi + klo) >> 1;
-    if (xa[k] > x) {
-      khi = k;
-    } else {
-      klo = k;
-    }
+  SplineSegment seg;
+  if (!splseg(xa, n, x, &seg)) {
+    return false;
   }
 
-  h = xa[khi] - xa[klo];
-  if (h == 0.0) {
+  *y = splvel(ya, y2a, seg);
+  return true;
+}
+
+/**
+ * @brief Calculates acceleration of spline
+ *
+ * https://archive.org/details/NumericalRecipes/page/n139/mode/2up
+ *
+ * @param xa The time values of each point where splines are supposed to join
+ * up.
+ * @param ya The y-values of each know point.
+ * @param y2a Second derivatives, calculated from spline()
+ * @param n Number of points
+ * @param x Point to evaluate
+ * @param y Pointer to result
+ *
+ * @returns True on success, false on failure
+ */
+inline bool splacc(const double xa[], const double ya[], const double y2a[],
+                   const int n, const double x, double *y) {
+  SplineSegment seg;
+  if (!splseg(xa, n, x, &seg)) {
     return false;
   }
 
   (void)ya;
 
-  a = (xa[khi] - x) / h;
-  b = (x - xa[klo]) / h;
-  *y = y2a[klo] * a + y2a[khi] * b;
+  *y = splacc(y2a, seg);
+  return true;
+}
+
+/**
+ * @brief Calculates position, velocity, and acceleration of spline
+ *
+ * https://archive.org/details/NumericalRecipes/page/n139/mode/2up
+ *
+ * Same as calling splpos(), splvel(), and splacc(), but only searches for the
+ * segment and calculates the shared terms once.
+ *
+ * @param xa The time values of each point where splines are supposed to join
+ * up.
+ * @param ya The y-values of each know point.
+ * @param y2a Second derivatives, calculated from spline()
+ * @param n Number of points
+ * @param x Point to evaluate
+ * @param y Pointer to position result
+ * @param yd Pointer to velocity result
+ * @param ydd Pointer to acceleration result
+ *
+ * @returns True on success, false on failure
+ */
+inline bool splstate(const double xa[], const double ya[], const double y2a[],
+                     const int n, const double x, double *y, double *yd,
+                     double *ydd) {
+  SplineSegment seg;
+  if (!splseg(xa, n, x, &seg)) {
+    return false;
+  }
+
+  splstate(ya, y2a, seg, y, yd, ydd);
   return true;
 }
 } // namespace hermite
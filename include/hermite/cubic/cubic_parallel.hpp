@@ -0,0 +1,336 @@
+/**
+ * @file
+ *
+ * A parallel solver for the spline system, for very many points
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "hermite/cubic/cubic_impl.hpp"
+
+namespace hermite {
+/**
+ * @brief Fewest points that are solved in parallel by default
+ *
+ * Below this, starting the threads costs more than the solve itself.
+ */
+const int PARALLEL_MIN_POINTS = 100000;
+
+/**
+ * @brief Fewest points given to each thread by default
+ */
+const int PARALLEL_POINTS_PER_THREAD = 25000;
+
+/**
+ * @brief Agreement between splparallel() and spline()
+ *
+ * The two solve the same system in a different order, so the second
+ * derivatives differ by rounding. The difference is bounded by this fraction
+ * of the largest second derivative in magnitude.
+ */
+const double PARALLEL_TOLERANCE = 1e-9;
+
+/**
+ * @brief Picks the number of threads for solving a spline
+ *
+ * @param n Number of points
+ *
+ * @returns Number of threads to pass to splparallel(), or 1 if the spline
+ * should be solved sequentially with spline() or splsolve()
+ */
+inline int splthreads(const int n) {
+  if (n < PARALLEL_MIN_POINTS) {
+    return 1;
+  }
+
+  const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+  return std::max(1, std::min(hardware, n / PARALLEL_POINTS_PER_THREAD));
+}
+
+/**
+ * @brief Solves one block of the spline system on its own
+ *
+ * Eliminates rows s to e as if the points just outside of them were zero,
+ * which gives g, and also solves for the effect of those points, so that the
+ * solution of the whole system in the block is
+ * x[i] = g[i] + v[i] * x[s - 1] + w[i] * x[e + 1].
+ *
+ * @param t The time values of each point
+ * @param y The y-values of the splines, interleaved like in splsolve()
+ * @param n Number of points
+ * @param m Number of splines
+ * @param yp1 The velocity of each spline at the first point
+ * @param ypn The velocity of each spline at the last point
+ * @param s First row of the block
+ * @param e Last row of the block
+ * @param cp Scratch array of n numbers, for the eliminated upper diagonal
+ * @param v Output array of n numbers, the effect of the point before
+ * @param w Output array of n numbers, the effect of the point after
+ * @param g Output array of n * m numbers, interleaved like y
+ */
+inline void splblock(const double t[], const double y[], const int n,
+                     const int m, const double yp1[], const double ypn[],
+                     const int s, const int e, double cp[], double v[],
+                     double w[], double g[]) {
+  const bool natStart = yp1[0] > 0.99e30;
+  const bool natEnd = ypn[0] > 0.99e30;
+  int i, j;
+  double a, b, c;
+
+  // forward elimination, with the coupling to the point before in v
+  for (i = s; i <= e; i++) {
+    splrow(t, n, natStart, natEnd, i, a, b, c);
+    const double inv = 1.0 / (i == s ? b : b - a * cp[i - 1]);
+    cp[i] = i == e ? 0.0 : c * inv;
+    v[i] = i == s ? -a * inv : -a * v[i - 1] * inv;
+    w[i] = i == e ? -c * inv : 0.0;
+
+    for (j = 0; j < m; j++) {
+      const double r = splrhs(t, y, n, m, yp1, ypn, i, j);
+      g[i * m + j] = i == s ? r * inv : (r - a * g[(i - 1) * m + j]) * inv;
+    }
+  }
+
+  // back substitution
+  for (i = e - 1; i >= s; i--) {
+    v[i] -= cp[i] * v[i + 1];
+    w[i] = -cp[i] * w[i + 1];
+    for (j = 0; j < m; j++) {
+      g[i * m + j] -= cp[i] * g[(i + 1) * m + j];
+    }
+  }
+}
+
+/**
+ * @brief Solves a small dense system in place
+ *
+ * Gaussian elimination with partial pivoting.
+ *
+ * @param mat Row-major N by N matrix, destroyed
+ * @param rhs Row-major N by m right-hand sides, replaced with the solutions
+ * @param N Size of the system
+ * @param m Number of right-hand sides
+ */
+inline void spldense(double mat[], double rhs[], const int N, const int m) {
+  int i, j, k;
+
+  for (k = 0; k < N; k++) {
+    int pivot = k;
+    for (i = k + 1; i < N; i++) {
+      if (std::fabs(mat[i * N + k]) > std::fabs(mat[pivot * N + k])) {
+        pivot = i;
+      }
+    }
+
+    if (pivot != k) {
+      std::swap_ranges(mat + k * N, mat + (k + 1) * N, mat + pivot * N);
+      std::swap_ranges(rhs + k * m, rhs + (k + 1) * m, rhs + pivot * m);
+    }
+
+    for (i = k + 1; i < N; i++) {
+      const double f = mat[i * N + k] / mat[k * N + k];
+      if (f == 0.0) {
+        continue;
+      }
+
+      for (j = k; j < N; j++) {
+        mat[i * N + j] -= f * mat[k * N + j];
+      }
+      for (j = 0; j < m; j++) {
+        rhs[i * m + j] -= f * rhs[k * m + j];
+      }
+    }
+  }
+
+  for (k = N - 1; k >= 0; k--) {
+    for (j = 0; j < m; j++) {
+      double sum = rhs[k * m + j];
+      for (i = k + 1; i < N; i++) {
+        sum -= mat[k * N + i] * rhs[i * m + j];
+      }
+      rhs[k * m + j] = sum / mat[k * N + k];
+    }
+  }
+}
+
+/**
+ * @brief Joins every thread in a list when it goes out of scope
+ *
+ * Destroying a thread that can still be joined terminates the program, so
+ * this keeps an exception from doing that.
+ */
+class SplJoiner {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param workers Threads to join
+   */
+  explicit SplJoiner(std::vector<std::thread> &workers) : m_workers{workers} {}
+
+  /**
+   * @brief Destructor
+   *
+   * Waits for the threads to finish.
+   */
+  ~SplJoiner() {
+    for (auto &worker : m_workers) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  /**
+   * @brief Copy constructor, deleted since the list must be joined only once
+   */
+  SplJoiner(const SplJoiner &) = delete;
+
+  /**
+   * @brief Assignment operator, deleted since the list must be joined only
+   * once
+   */
+  SplJoiner &operator=(const SplJoiner &) = delete;
+
+private:
+  std::vector<std::thread> &m_workers;
+};
+
+/**
+ * @brief Runs a function on several threads and waits for all of them
+ *
+ * The calling thread runs the function with 0, and new threads run it with 1
+ * to threads - 1. If a thread cannot be started, then the calling thread runs
+ * the rest of the indices itself, so the result is the same. The calls with
+ * different indices must not wait on each other.
+ *
+ * @param threads Number of threads, including the calling one
+ * @param func Function taking the index of the thread
+ *
+ * @note If func throws on the calling thread, then the threads that were
+ * started are joined before the exception is passed on.
+ */
+template <typename F> void splrun(const int threads, F func) {
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  const SplJoiner joiner{workers};
+
+  int k = 1;
+  try {
+    for (; k < threads; k++) {
+      workers.emplace_back(func, k);
+    }
+  } catch (const std::system_error &) {
+    // out of threads, so the remaining blocks run below
+  }
+
+  for (; k < threads; k++) {
+    func(k);
+  }
+  func(0);
+}
+
+/**
+ * @brief Calculates second derivatives of many splines on several threads
+ *
+ * Gives the same result as spline() on each spline, within
+ * PARALLEL_TOLERANCE, by partitioning the system. The points are split into
+ * one block per thread, and each thread solves its block on its own,
+ * along with the effect of the two points just outside of it, which decays
+ * quickly since the system is diagonally dominant. The first and last points
+ * of every block then form a small system of 2 * threads unknowns, which is
+ * solved on the calling thread, and each thread fills in its block from those.
+ *
+ * Each thread does more work per point than splsolve(), since it also solves
+ * for the effect of the neighboring blocks, so this is only faster when the
+ * threads run on separate cores. splthreads() picks the number of threads
+ * for a number of points.
+ *
+ * @param t The time values of each point where splines are supposed to join
+ * up.
+ * @param y The y-values of each known point, interleaved, so y[i * m + j] is
+ * the value of spline j at point i.
+ * @param n Number of points, at least 2.
+ * @param m Number of splines
+ * @param yp1 The velocity of each spline at the first point, or more than
+ * 0.99e30 for a natural end
+ * @param ypn The velocity of each spline at the last point, or more than
+ * 0.99e30 for a natural end
+ * @param y2 Output array of n * m numbers, filled with second derivatives,
+ * interleaved like y.
+ * @param threads Number of threads to use. Reduced so that every block has at
+ * least 2 points.
+ *
+ * @note Every spline must have the same kind of end at each point, since the
+ * kind of end changes the system. Splines with other ends must be solved in
+ * another call.
+ */
+inline void splparallel(const double t[], const double y[], const int n,
+                        const int m, const double yp1[], const double ypn[],
+                        double y2[], int threads) {
+  threads = std::max(1, std::min(threads, n / 2));
+
+  std::vector<double> scratch(3 * static_cast<std::size_t>(n));
+  double *cp = scratch.data();
+  double *v = cp + n;
+  double *w = v + n;
+
+  std::vector<int> starts(threads + 1);
+  for (int k = 0; k <= threads; k++) {
+    starts[k] = static_cast<int>(static_cast<long long>(n) * k / threads);
+  }
+
+  splrun(threads, [&](const int k) {
+    splblock(t, y, n, m, yp1, ypn, starts[k], starts[k + 1] - 1, cp, v, w,
+             y2);
+  });
+
+  // unknown 2k is the first point of block k, and 2k + 1 is the last point
+  const int N = 2 * threads;
+  std::vector<double> mat(static_cast<std::size_t>(N) * N);
+  std::vector<double> ends(static_cast<std::size_t>(N) * m);
+  for (int k = 0; k < threads; k++) {
+    const int rows[2] = {starts[k], starts[k + 1] - 1};
+    for (int side = 0; side < 2; side++) {
+      const int row = 2 * k + side;
+      const int i = rows[side];
+      mat[row * N + row] = 1.0;
+      if (k > 0) {
+        mat[row * N + 2 * k - 1] -= v[i];
+      }
+      if (k < threads - 1) {
+        mat[row * N + 2 * k + 2] -= w[i];
+      }
+      for (int j = 0; j < m; j++) {
+        ends[row * m + j] = y2[i * m + j];
+      }
+    }
+  }
+
+  spldense(mat.data(), ends.data(), N, m);
+
+  splrun(threads, [&](const int k) {
+    const double *before = k > 0 ? &ends[(2 * k - 1) * m] : nullptr;
+    const double *after = k < threads - 1 ? &ends[(2 * k + 2) * m] : nullptr;
+    for (int i = starts[k]; i < starts[k + 1]; i++) {
+      for (int j = 0; j < m; j++) {
+        double x = y2[i * m + j];
+        if (before != nullptr) {
+          x += v[i] * before[j];
+        }
+        if (after != nullptr) {
+          x += w[i] * after[j];
+        }
+        y2[i * m + j] = x;
+      }
+    }
+  });
+}
+} // namespace hermite
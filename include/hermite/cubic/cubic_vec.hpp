@@ -6,13 +6,21 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <vector>
 
 #include "hermite/cubic/cubic_impl.hpp"
+#include "hermite/cubic/cubic_parallel.hpp"
+#include "hermite/cubic/cubic_workspace.hpp"
+#include "hermite/knot_index.hpp"
+#include "hermite/pod_vector.hpp"
 #include "hermite/pose.hpp"
+#include "hermite/simd/simd.hpp"
+#include "hermite/state.hpp"
 #include "hermite/thirdparty/simplevectors.hpp"
+#include "hermite/uniform_knots.hpp"
 
 namespace hermite {
 using svector::Vector;
@@ -21,8 +29,13 @@ using svector::Vector;
  * @brief Spline vector calculator
  *
  * Calculates spline for vectors in C++ STL containers
+ *
+ * The positions and second derivatives are stored as T, which is double by
+ * default. The spline is always solved and evaluated in double, and the knot
+ * times are always stored as doubles, so with float only the stored values
+ * are rounded, to about 7 significant digits.
  */
-template <std::size_t D> class CubicVec {
+template <std::size_t D, typename T = double> class CubicVec {
 public:
   /**
    * @brief Default constructor
@@ -47,38 +60,24 @@ public:
    *
    * @param waypoints A list of poses
    */
-  CubicVec(const std::vector<Pose<D>> &waypoints) {
-    const std::size_t n = waypoints.size();
-    m_ts.resize(n);
-
-    // solve each dimension independently
-    for (std::size_t dim = 0; dim < D; dim++) {
-      m_ys[dim].resize(n);
-      m_accs[dim].resize(n);
-
-      for (std::size_t i = 0; i < n; i++) {
-        m_ts[i] = waypoints[i].getTime();
-        m_ys[dim][i] = waypoints[i].getPos()[dim];
-      }
-
-      const double yp1 = waypoints[0].getVel()[dim];
-      const double ypn = waypoints[n - 1].getVel()[dim];
-
-      spline(m_ts.data(), m_ys[dim].data(), static_cast<int>(n), yp1, ypn,
-             m_accs[dim].data());
-    }
-  }
+  CubicVec(const std::vector<Pose<D, T>> &waypoints) { solve(waypoints); }
 
   /**
    * @brief Copy constructor
+   *
+   * The workspace only holds scratch data, so it is sized for the copied
+   * spline instead of copied, as in the assignment operator.
    */
-  CubicVec(const CubicVec<D> &other)
-      : m_ts{other.m_ts}, m_ys{other.m_ys}, m_accs{other.m_accs} {}
+  CubicVec(const CubicVec<D, T> &other)
+      : m_ts{other.m_ts}, m_ys{other.m_ys}, m_accs{other.m_accs},
+        m_uniform{other.m_uniform}, m_index{other.m_index},
+        m_fac{other.m_fac}, m_workspace{other.m_ts.size(), D},
+        m_threads{other.m_threads} {}
 
   /**
    * @brief Assignment operator
    */
-  CubicVec<D> &operator=(const CubicVec<D> &other) {
+  CubicVec<D, T> &operator=(const CubicVec<D, T> &other) {
     // check if assigning to self
     if (this == &other) {
       return *this;
@@ -87,6 +86,11 @@ public:
     m_ts = other.m_ts;
     m_ys = other.m_ys;
     m_accs = other.m_accs;
+    m_uniform = other.m_uniform;
+    m_index = other.m_index;
+    m_fac = other.m_fac;
+    m_workspace.reserve(m_ts.size(), D);
+    m_threads = other.m_threads;
 
     return *this;
   }
@@ -96,6 +100,116 @@ public:
    */
   ~CubicVec() = default;
 
+  /**
+   * Solves the spline through a list of poses, replacing the current one
+   *
+   * Same as constructing a new object, but reuses the storage.
+   *
+   * @note Assumes that the size of poses is greater than or equal to 2, it is
+   * sorted by time, and there are no repeated times. Otherwise, there will be
+   * undefined behavior.
+   *
+   * @param waypoints A list of poses
+   */
+  void solve(const std::vector<Pose<D, T>> &waypoints) {
+    solve(waypoints, m_workspace);
+  }
+
+  /**
+   * Solves the spline through a list of poses with a workspace, replacing the
+   * current one
+   *
+   * Once the workspace and this object have held a spline with as many
+   * waypoints, this does not allocate, unless the spline is solved in
+   * parallel.
+   *
+   * @note Assumes that the size of poses is greater than or equal to 2, it is
+   * sorted by time, and there are no repeated times. Otherwise, there will be
+   * undefined behavior.
+   *
+   * @param waypoints A list of poses
+   * @param workspace Scratch memory, which can be shared with other splines
+   */
+  void solve(const std::vector<Pose<D, T>> &waypoints,
+             CubicWorkspace &workspace) {
+    const std::size_t n = waypoints.size();
+    m_ts.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+      m_ts[i] = waypoints[i].getTime();
+    }
+    m_uniform = UniformKnots{m_ts.data(), n};
+    if (hasIndex()) {
+      buildIndex();
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      m_ys[dim].resize(n);
+      m_accs[dim].resize(n);
+    }
+
+    for (std::size_t i = 0; i < n; i++) {
+      const auto &pos = waypoints[i].getPosData();
+      for (std::size_t dim = 0; dim < D; dim++) {
+        m_ys[dim][i] = pos[dim];
+      }
+    }
+
+    // the factors only depend on the times, so they are kept for resolve(),
+    // unless the spline is large enough to be solved in parallel instead
+    m_threads = splthreads(static_cast<int>(n));
+    if (m_threads > 1) {
+      m_fac.clear();
+    } else {
+      m_fac.resize(4 * n);
+      splfactor(m_ts.data(), static_cast<int>(n), m_fac.data());
+    }
+
+    solveAll(waypoints[0].getVel(), waypoints[n - 1].getVel(), workspace);
+  }
+
+  /**
+   * Solves the spline again for new positions and end velocities, keeping the
+   * times
+   *
+   * Reuses the factorization and the storage from solve(), so this takes linear
+   * time and does not allocate, unless the spline is solved in parallel.
+   *
+   * @param positions Array of one position vector for each time
+   * @param startVel Velocity at the first time
+   * @param endVel Velocity at the last time
+   *
+   * @note Assumes that solve() has been called, and that positions has the
+   * same number of elements as the times.
+   */
+  void resolve(const Vector<D> positions[], const Vector<D> &startVel,
+               const Vector<D> &endVel) {
+    resolve(positions, startVel, endVel, m_workspace);
+  }
+
+  /**
+   * Solves the spline again for new positions and end velocities with a
+   * workspace, keeping the times
+   *
+   * @param positions Array of one position vector for each time
+   * @param startVel Velocity at the first time
+   * @param endVel Velocity at the last time
+   * @param workspace Scratch memory, which can be shared with other splines
+   *
+   * @note Assumes that solve() has been called, and that positions has the
+   * same number of elements as the times.
+   */
+  void resolve(const Vector<D> positions[], const Vector<D> &startVel,
+               const Vector<D> &endVel, CubicWorkspace &workspace) {
+    const std::size_t n = m_ts.size();
+    for (std::size_t i = 0; i < n; i++) {
+      for (std::size_t dim = 0; dim < D; dim++) {
+        m_ys[dim][i] = static_cast<T>(positions[i][dim]);
+      }
+    }
+
+    solveAll(startVel, endVel, workspace);
+  }
+
   /**
    * Gets position value given a time input
    *
@@ -104,67 +218,415 @@ public:
    * @returns Position vector at a given time
    */
   Vector<D> splpos(const double t) const {
-    const std::size_t n = m_ts.size();
+    return splpos(t, findSegment(t, -1));
+  }
+
+  /**
+   * Gets velocity value given a time input
+   *
+   * @param t Time input
+   *
+   * @returns Velocity vector at a given time
+   */
+  Vector<D> splvel(const double t) const {
+    return splvel(t, findSegment(t, -1));
+  }
+
+  /**
+   * Gets acceleration value given a time input
+   *
+   * @param t Time input
+   *
+   * @returns Acceleration vector at a given time
+   */
+  Vector<D> splacc(const double t) const {
+    return splacc(t, findSegment(t, -1));
+  }
+
+  /**
+   * Gets position, velocity, and acceleration values given a time input
+   *
+   * @param t Time input
+   *
+   * @returns Position, velocity, and acceleration vectors at a given time
+   */
+  State<D> splstate(const double t) const {
+    return splstate(t, findSegment(t, -1));
+  }
+
+  /**
+   * Finds the segment that contains a time, given the segment of a previous
+   * time
+   *
+   * If the time is close to the hinted segment, or the knots are evenly
+   * spaced, this takes constant time. If there is no hint and the search index
+   * has been built, then the index is searched.
+   *
+   * @param t Time input
+   * @param hint Lower knot index of a previous segment, or -1 if unknown
+   *
+   * @returns Index of the lower knot of the segment, between 0 and n - 2
+   */
+  int findSegment(const double t, const int hint) const {
+    if (m_uniform.isUniform()) {
+      return m_uniform.getSegment(t);
+    }
+
+    if (hint < 0 && !m_index.empty()) {
+      return m_index.findSegment(t);
+    }
+
+    return splhunt(m_ts.data(), static_cast<int>(m_ts.size()), t, hint);
+  }
+
+  /**
+   * Gets position value on a certain segment
+   *
+   * @param t Time input
+   * @param klo Lower knot index of the segment, from findSegment()
+   *
+   * @returns Position vector at a given time
+   */
+  Vector<D> splpos(const double t, const int klo) const {
     Vector<D> res;
+    SplineSegment seg;
+    if (!splsegat(m_ts.data(), klo, t, &seg)) {
+      return res;
+    }
 
-    // solve each dimension independently
+    // the segment is shared by all dimensions
     for (std::size_t dim = 0; dim < D; dim++) {
-      double output;
-      hermite::splpos(m_ts.data(), m_ys[dim].data(), m_accs[dim].data(),
-                      static_cast<int>(n), t, &output);
-      res[dim] = output;
+      res[dim] = hermite::splpos(m_ys[dim].data(), m_accs[dim].data(), seg);
     }
 
     return res;
   }
 
   /**
-   * Gets velocity value given a time input
+   * Gets velocity value on a certain segment
    *
    * @param t Time input
+   * @param klo Lower knot index of the segment, from findSegment()
    *
    * @returns Velocity vector at a given time
    */
-  Vector<D> splvel(const double t) const {
-    const std::size_t n = m_ts.size();
+  Vector<D> splvel(const double t, const int klo) const {
     Vector<D> res;
+    SplineSegment seg;
+    if (!splsegat(m_ts.data(), klo, t, &seg)) {
+      return res;
+    }
 
-    // solve each dimension independently
     for (std::size_t dim = 0; dim < D; dim++) {
-      double output;
-      hermite::splvel(m_ts.data(), m_ys[dim].data(), m_accs[dim].data(),
-                      static_cast<int>(n), t, &output);
-      res[dim] = output;
+      res[dim] = hermite::splvel(m_ys[dim].data(), m_accs[dim].data(), seg);
     }
 
     return res;
   }
 
   /**
-   * Gets acceleration value given a time input
+   * Gets acceleration value on a certain segment
    *
    * @param t Time input
+   * @param klo Lower knot index of the segment, from findSegment()
    *
    * @returns Acceleration vector at a given time
    */
-  Vector<D> splacc(const double t) const {
-    const std::size_t n = m_ts.size();
+  Vector<D> splacc(const double t, const int klo) const {
     Vector<D> res;
+    SplineSegment seg;
+    if (!splsegat(m_ts.data(), klo, t, &seg)) {
+      return res;
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] = hermite::splacc(m_accs[dim].data(), seg);
+    }
+
+    return res;
+  }
+
+  /**
+   * Gets position, velocity, and acceleration values on a certain segment
+   *
+   * @param t Time input
+   * @param klo Lower knot index of the segment, from findSegment()
+   *
+   * @returns Position, velocity, and acceleration vectors at a given time
+   */
+  State<D> splstate(const double t, const int klo) const {
+    State<D> res;
+    SplineSegment seg;
+    if (!splsegat(m_ts.data(), klo, t, &seg)) {
+      return res;
+    }
 
-    // solve each dimension independently
     for (std::size_t dim = 0; dim < D; dim++) {
-      double output;
-      hermite::splacc(m_ts.data(), m_ys[dim].data(), m_accs[dim].data(),
-                      static_cast<int>(n), t, &output);
-      res[dim] = output;
+      hermite::splstate(m_ys[dim].data(), m_accs[dim].data(), seg,
+                        &res.pos[dim], &res.vel[dim], &res.acc[dim]);
     }
 
     return res;
   }
 
+  /**
+   * Gets the coefficients of a segment in the power basis
+   *
+   * @param klo Lower knot index of the segment
+   * @param coefs Output array of 4 * D numbers. The coefficient of u^j in
+   * dimension dim is written to coefs[j * D + dim], where u goes from 0 to 1
+   * over the segment.
+   */
+  void getPowerBasis(const int klo, double coefs[]) const {
+    for (std::size_t dim = 0; dim < D; dim++) {
+      double c[4];
+      splcoef(m_ts.data(), m_ys[dim].data(), m_accs[dim].data(), klo, c);
+      for (std::size_t j = 0; j < 4; j++) {
+        coefs[j * D + dim] = c[j];
+      }
+    }
+  }
+
+  /**
+   * Gets position values given many time inputs
+   *
+   * If the times are sorted, then each segment is found by hunting from the
+   * previous one, so the cost is amortized constant per time instead of
+   * logarithmic. Times that fall in the same segment are evaluated together
+   * with the vectorized kernels in simd.hpp.
+   *
+   * @param ts Array of time inputs
+   * @param n Number of time inputs
+   * @param out Output array, must have room for n vectors
+   */
+  void splposBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const {
+    evalRuns(0, ts, n, out);
+  }
+
+  /**
+   * Gets velocity values given many time inputs
+   *
+   * @param ts Array of time inputs
+   * @param n Number of time inputs
+   * @param out Output array, must have room for n vectors
+   *
+   * @see splposBatch()
+   */
+  void splvelBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const {
+    evalRuns(1, ts, n, out);
+  }
+
+  /**
+   * Gets acceleration values given many time inputs
+   *
+   * @param ts Array of time inputs
+   * @param n Number of time inputs
+   * @param out Output array, must have room for n vectors
+   *
+   * @see splposBatch()
+   */
+  void splaccBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const {
+    evalRuns(2, ts, n, out);
+  }
+
+  /**
+   * Gets position, velocity, and acceleration values given many time inputs
+   *
+   * @param ts Array of time inputs
+   * @param n Number of time inputs
+   * @param out Output array, must have room for n states
+   *
+   * @see splposBatch()
+   */
+  void splstateBatch(const double ts[], const std::size_t n,
+                     State<D> out[]) const {
+    int klo = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      klo = findSegment(ts[i], klo);
+      out[i] = splstate(ts[i], klo);
+    }
+  }
+
+  /**
+   * Checks whether the knots are evenly spaced
+   *
+   * @returns True if segments are found in constant time
+   */
+  bool isUniform() const { return m_uniform.isUniform(); }
+
+  /**
+   * Builds a search index over the knot times, for faster lookups at random
+   * times when there are many knots
+   *
+   * The index is built again by every later solve() with the new times.
+   */
+  void buildIndex() { m_index = KnotIndex<double>{m_ts.data(), m_ts.size()}; }
+
+  /**
+   * Checks whether the search index has been built
+   *
+   * @returns True if buildIndex() has been called
+   */
+  bool hasIndex() const { return !m_index.empty(); }
+
 private:
   std::vector<double> m_ts;
-  std::array<std::vector<double>, D> m_ys;
-  std::array<std::vector<double>, D> m_accs;
+  std::array<std::vector<T>, D> m_ys;
+  std::array<std::vector<T>, D> m_accs;
+  UniformKnots m_uniform;
+  KnotIndex<double> m_index;
+  std::vector<double> m_fac;   // factors of the times, from splfactor()
+  CubicWorkspace m_workspace; // scratch space for solveAll()
+  int m_threads = 1;           // threads for solveAll(), from splthreads()
+
+  /**
+   * Solves for the second derivatives of every dimension from the stored
+   * positions and the factors of the times
+   *
+   * Dimensions with clamped ends are solved together, interleaved so that the
+   * solve vectorizes across them. Natural ends change the elimination factors,
+   * so those dimensions are solved on their own. Large splines are solved with
+   * splparallel() instead.
+   *
+   * @param startVel Velocity at the first time
+   * @param endVel Velocity at the last time
+   * @param workspace Scratch memory
+   */
+  void solveAll(const Vector<D> &startVel, const Vector<D> &endVel,
+                CubicWorkspace &workspace) {
+    const std::size_t n = m_ts.size();
+    double *ys = workspace.getData(n, D);
+    double *u = ys + 2 * n * D + 2 * D;
+
+    std::array<std::size_t, D> dims;
+    std::size_t m = 0;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      if (startVel[dim] > 0.99e30 || endVel[dim] > 0.99e30) {
+        // solved in place if the values are stored as doubles
+        const double *y = getColumn(m_ys[dim], ys);
+        double *acc = getColumn(m_accs[dim], ys + n);
+        const double yp1 = startVel[dim];
+        const double ypn = endVel[dim];
+        if (m_threads > 1) {
+          splparallel(m_ts.data(), y, static_cast<int>(n), 1, &yp1, &ypn, acc,
+                      m_threads);
+        } else {
+          spline(m_ts.data(), y, static_cast<int>(n), yp1, ypn, acc, u);
+        }
+        setColumn(acc, m_accs[dim]);
+      } else {
+        dims[m] = dim;
+        m++;
+      }
+    }
+
+    if (m == 0) {
+      return;
+    }
+
+    double *accs = ys + n * m;
+    double *yp1 = accs + n * m;
+    double *ypn = yp1 + m;
+
+    for (std::size_t i = 0; i < n; i++) {
+      for (std::size_t j = 0; j < m; j++) {
+        ys[i * m + j] = m_ys[dims[j]][i];
+      }
+    }
+
+    for (std::size_t j = 0; j < m; j++) {
+      yp1[j] = startVel[dims[j]];
+      ypn[j] = endVel[dims[j]];
+    }
+
+    if (m_threads > 1) {
+      splparallel(m_ts.data(), ys, static_cast<int>(n), static_cast<int>(m),
+                  yp1, ypn, accs, m_threads);
+    } else {
+      splsolve(m_fac.data(), ys, static_cast<int>(n), static_cast<int>(m), yp1,
+               ypn, accs);
+    }
+
+    for (std::size_t i = 0; i < n; i++) {
+      for (std::size_t j = 0; j < m; j++) {
+        m_accs[dims[j]][i] = static_cast<T>(accs[i * m + j]);
+      }
+    }
+  }
+
+  /**
+   * Gets a column of stored values as doubles, which is the column itself
+   */
+  static double *getColumn(std::vector<double> &column, double *) {
+    return column.data();
+  }
+
+  /**
+   * Gets a column of stored values as doubles, copied into scratch memory
+   */
+  template <typename U>
+  static double *getColumn(std::vector<U> &column, double *scratch) {
+    std::copy(column.begin(), column.end(), scratch);
+    return scratch;
+  }
+
+  /**
+   * Stores a column of doubles from getColumn(), which is only copied if it
+   * is not the column itself
+   */
+  static void setColumn(const double *values, std::vector<T> &column) {
+    if (static_cast<const void *>(values) ==
+        static_cast<const void *>(column.data())) {
+      return;
+    }
+
+    for (std::size_t i = 0; i < column.size(); i++) {
+      column[i] = static_cast<T>(values[i]);
+    }
+  }
+
+  /**
+   * Evaluates a derivative at many times, handing each run of times in the
+   * same segment to the vectorized kernels at once
+   *
+   * @param deriv 0 for position, 1 for velocity, 2 for acceleration
+   * @param ts Array of times
+   * @param n Number of times
+   * @param out Output array
+   */
+  void evalRuns(const int deriv, const double ts[], const std::size_t n,
+                Vector<D> out[]) const {
+    const int last = static_cast<int>(m_ts.size()) - 2;
+    double coefs[4 * D];
+
+    int klo = 0;
+    std::size_t i = 0;
+    while (i < n) {
+      klo = findSegment(ts[i], klo);
+
+      std::size_t j = i + 1;
+      while (j < n && (klo == 0 || m_ts[klo] <= ts[j]) &&
+             (klo == last || ts[j] < m_ts[klo + 1])) {
+        j++;
+      }
+
+      if (j - i < simd::MIN_RUN) {
+        for (; i < j; i++) {
+          out[i] = deriv == 0 ? splpos(ts[i], klo)
+                   : deriv == 1 ? splvel(ts[i], klo)
+                                : splacc(ts[i], klo);
+        }
+        continue;
+      }
+
+      getPowerBasis(klo, coefs);
+      simd::evalSegment<D>(coefs, m_ts[klo], 1 / (m_ts[klo + 1] - m_ts[klo]),
+                           deriv, ts + i, j - i, out + i);
+      i = j;
+    }
+  }
 };
 } // namespace hermite
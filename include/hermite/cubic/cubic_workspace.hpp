@@ -0,0 +1,102 @@
+/**
+ * @file
+ *
+ * Reusable scratch memory for solving cubic splines
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace hermite {
+/**
+ * @brief Scratch memory for solving cubic splines
+ *
+ * Solving a spline needs temporary arrays that grow with the number of
+ * waypoints. Keeping them in a workspace that outlives the solve means that
+ * they are only allocated when a spline is larger than any solved before, so
+ * after the first solve (or a call to reserve()), solving splines of the same
+ * size or smaller does not allocate.
+ *
+ * One workspace can be shared by any number of splines, as long as they are
+ * not solved at the same time.
+ */
+class CubicWorkspace {
+public:
+  /**
+   * @brief Default constructor
+   *
+   * Initializes without any memory, which is allocated by the first solve
+   */
+  CubicWorkspace() = default;
+
+  /**
+   * @brief Constructor
+   *
+   * Allocates enough memory to solve a spline of a certain size.
+   *
+   * @param n Number of waypoints
+   * @param dims Number of dimensions
+   */
+  CubicWorkspace(const std::size_t n, const std::size_t dims) {
+    reserve(n, dims);
+  }
+
+  /**
+   * @brief Makes sure that there is enough memory to solve a spline
+   *
+   * Only allocates if the memory is smaller than needed.
+   *
+   * @param n Number of waypoints
+   * @param dims Number of dimensions
+   */
+  void reserve(const std::size_t n, const std::size_t dims) {
+    const std::size_t size = getSize(n, dims);
+    if (m_data.size() < size) {
+      m_data.resize(size);
+    }
+  }
+
+  /**
+   * @brief Gets the number of doubles of scratch memory
+   *
+   * @returns Size of the memory
+   */
+  std::size_t size() const { return m_data.size(); }
+
+  /**
+   * @brief Gets the scratch memory for solving a spline
+   *
+   * Grows the memory first if it is too small.
+   *
+   * @param n Number of waypoints
+   * @param dims Number of dimensions
+   *
+   * @returns Pointer to at least 2 * n * dims + 2 * dims + n doubles, which
+   * stays valid until the memory grows again
+   */
+  double *getData(const std::size_t n, const std::size_t dims) {
+    reserve(n, dims);
+    return m_data.data();
+  }
+
+  /**
+   * @brief Gets the number of doubles needed to solve a spline
+   *
+   * Enough for the positions and second derivatives of every dimension, the
+   * velocities at both ends, and one more array of n doubles for spline().
+   *
+   * @param n Number of waypoints
+   * @param dims Number of dimensions
+   *
+   * @returns Number of doubles
+   */
+  static std::size_t getSize(const std::size_t n, const std::size_t dims) {
+    return 2 * n * dims + 2 * dims + n;
+  }
+
+private:
+  std::vector<double> m_data;
+};
+} // namespace hermite
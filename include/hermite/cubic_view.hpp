@@ -0,0 +1,462 @@
+/**
+ * @file
+ *
+ * A cubic spline over arrays owned by the caller
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "hermite/base_spline.hpp"
+#include "hermite/cubic/cubic_impl.hpp"
+#include "hermite/cubic/cubic_workspace.hpp"
+#include "hermite/state.hpp"
+#include "hermite/thirdparty/simplevectors.hpp"
+#include "hermite/uniform_knots.hpp"
+
+namespace hermite {
+using svector::magn;
+using svector::Vector;
+
+/**
+ * @brief A natural cubic spline over arrays owned by the caller
+ *
+ * Same spline as Cubic, but the times and positions are read from the
+ * caller's arrays instead of being copied into poses, so data that is already
+ * stored in columns (one array of times and one array of positions per
+ * dimension) can be interpolated without packing or copying it. Only the
+ * second derivatives at each time are stored in this object.
+ *
+ * If the positions in the arrays change, resolve() solves the spline again
+ * from them. The times must not change.
+ *
+ * @note The arrays must outlive this object, and the times must be sorted
+ * with no repeats, since they are not copied or sorted. Otherwise, there will
+ * be undefined behavior.
+ */
+template <std::size_t D> class CubicView : public BaseSpline<D> {
+public:
+  /**
+   * @brief Default constructor
+   *
+   * Initializes with zero waypoints
+   */
+  CubicView() : m_times{nullptr}, m_positions{}, m_n{0} {}
+
+  /**
+   * @brief Constructor
+   *
+   * Solves the spline through the arrays in linear time.
+   *
+   * @param times Array of n times, sorted with no repeats
+   * @param positions One array of n positions for each dimension
+   * @param n Number of waypoints
+   * @param startVel Velocity at the first time. A component greater than
+   * 0.99e30 gives that dimension a natural end.
+   * @param endVel Velocity at the last time, like startVel
+   */
+  CubicView(const double times[],
+            const std::array<const double *, D> &positions,
+            const std::size_t n, const Vector<D> &startVel,
+            const Vector<D> &endVel)
+      : m_times{times}, m_positions(positions), m_n{n} {
+    m_uniform = UniformKnots{m_times, m_n};
+    resolve(startVel, endVel);
+  }
+
+  /**
+   * @brief Copy constructor
+   *
+   * The copy reads from the same arrays.
+   */
+  CubicView(const CubicView<D> &other)
+      : m_times{other.m_times}, m_positions(other.m_positions), m_n{other.m_n},
+        m_accs{other.m_accs}, m_uniform{other.m_uniform} {}
+
+  /**
+   * @brief Assignment operator
+   *
+   * Afterwards, this reads from the same arrays as the other object.
+   */
+  CubicView<D> &operator=(const CubicView<D> &other) {
+    if (this == &other) {
+      return *this;
+    }
+
+    m_times = other.m_times;
+    m_positions = other.m_positions;
+    m_n = other.m_n;
+    m_accs = other.m_accs;
+    m_uniform = other.m_uniform;
+
+    return *this;
+  }
+
+  /**
+   * @brief Destructor
+   */
+  ~CubicView() override = default;
+
+  /**
+   * @brief Solves the spline again from the current positions in the arrays
+   *
+   * Takes linear time. Allocates scratch memory for each call, so pass a
+   * workspace to the other overload to avoid allocating.
+   *
+   * @param startVel Velocity at the first time
+   * @param endVel Velocity at the last time
+   */
+  void resolve(const Vector<D> &startVel, const Vector<D> &endVel) {
+    CubicWorkspace workspace;
+    resolve(startVel, endVel, workspace);
+  }
+
+  /**
+   * @brief Solves the spline again from the current positions in the arrays,
+   * using a workspace
+   *
+   * Does not allocate once this object and the workspace have been used for
+   * as many waypoints.
+   *
+   * @param startVel Velocity at the first time
+   * @param endVel Velocity at the last time
+   * @param workspace Scratch memory, which can be shared with other splines
+   */
+  void resolve(const Vector<D> &startVel, const Vector<D> &endVel,
+               CubicWorkspace &workspace) {
+    if (m_n < 2) {
+      return;
+    }
+
+    double *u = workspace.getData(m_n, 1);
+    for (std::size_t dim = 0; dim < D; dim++) {
+      m_accs[dim].resize(m_n);
+      spline(m_times, m_positions[dim], static_cast<int>(m_n), startVel[dim],
+             endVel[dim], m_accs[dim].data(), u);
+    }
+  }
+
+  /**
+   * @brief Gets the number of waypoints
+   *
+   * @returns Number of times in the arrays
+   */
+  std::size_t size() const { return m_n; }
+
+  /**
+   * @brief Gets the second derivatives at the waypoints
+   *
+   * @param dim Dimension
+   *
+   * @returns Array of one second derivative for each time, or nullptr if there
+   * are fewer than 2 waypoints
+   */
+  const double *getAccData(const std::size_t dim) const {
+    return m_n < 2 ? nullptr : m_accs[dim].data();
+  }
+
+  /**
+   * @brief Checks whether the waypoints are evenly spaced in time
+   *
+   * If they are, within UNIFORM_TOLERANCE of the spacing, then segments are
+   * found in constant time instead of with a binary search.
+   *
+   * @returns True if the waypoints are evenly spaced
+   */
+  bool isUniform() const { return m_uniform.isUniform(); }
+
+  /**
+   * @brief Gets the lower bound of the domain of the piecewise spline function,
+   * which is the first time.
+   *
+   * @note If there are no waypoints, then returns 0
+   *
+   * @returns The first time
+   */
+  double getLowestTime() const override {
+    if (m_n == 0) {
+      return 0;
+    }
+
+    return m_times[0];
+  }
+
+  /**
+   * @brief Gets the upper bound of the domain of the piecewise spline function,
+   * which is the last time.
+   *
+   * @note If there are no waypoints, then returns 0
+   *
+   * @returns The last time
+   */
+  double getHighestTime() const override {
+    if (m_n == 0) {
+      return 0;
+    }
+
+    return m_times[m_n - 1];
+  }
+
+  /**
+   * @brief Gets position at a certain time
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns a
+   * zero vector.
+   *
+   * @param t Time
+   *
+   * @returns Position
+   */
+  Vector<D> getPos(const double t) const override {
+    return evalPos(t, findSegment(t, -1));
+  }
+
+  /**
+   * @brief Gets velocity at a certain time
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns a
+   * zero vector.
+   *
+   * @param t Time
+   *
+   * @returns Velocity
+   */
+  Vector<D> getVel(const double t) const override {
+    return evalVel(t, findSegment(t, -1));
+  }
+
+  /**
+   * @brief Gets acceleration at a certain time
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns a
+   * zero vector.
+   *
+   * @param t Time
+   *
+   * @returns Acceleration
+   */
+  Vector<D> getAcc(const double t) const override {
+    return evalAcc(t, findSegment(t, -1));
+  }
+
+  /**
+   * @brief Gets position, velocity, and acceleration at a certain time
+   *
+   * Only searches for the segment once.
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns zero
+   * vectors.
+   *
+   * @param t Time
+   *
+   * @returns Position, velocity, and acceleration
+   */
+  State<D> getState(const double t) const override {
+    return evalState(t, findSegment(t, -1));
+  }
+
+  /**
+   * @brief Gets positions at many times at once
+   *
+   * @note If the times are sorted, then the segment is found by walking from
+   * the previous one.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getPosBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    int seg = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      seg = findSegment(ts[i], seg);
+      out[i] = evalPos(ts[i], seg);
+    }
+  }
+
+  /**
+   * @brief Gets velocities at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getVelBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    int seg = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      seg = findSegment(ts[i], seg);
+      out[i] = evalVel(ts[i], seg);
+    }
+  }
+
+  /**
+   * @brief Gets accelerations at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getAccBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    int seg = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      seg = findSegment(ts[i], seg);
+      out[i] = evalAcc(ts[i], seg);
+    }
+  }
+
+  /**
+   * @brief Gets positions, velocities, and accelerations at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n states
+   */
+  void getStateBatch(const double ts[], const std::size_t n,
+                     State<D> out[]) const override {
+    int seg = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      seg = findSegment(ts[i], seg);
+      out[i] = evalState(ts[i], seg);
+    }
+  }
+
+  /**
+   * @brief Gets arc length
+   *
+   * @param timeStep The time step to try for the arc length
+   *
+   * @note This function will take much longer for smaller timesteps.
+   * Recommended is between 0.001 and 0.1, but this also depends on the domain
+   * of your function.
+   * @note If zero or one waypoints, returns 0.
+   *
+   * @returns Arc length
+   */
+  double getLength(const double timeStep) const override {
+    double res = 0.0;
+
+    if (m_n < 2) {
+      return res;
+    }
+
+    double time = getLowestTime() + timeStep;
+    const double timeEnd = getHighestTime();
+    int seg = 0;
+    while (time <= timeEnd) {
+      seg = findSegment(time, seg);
+      res += magn(evalVel(time, seg)) * timeStep;
+
+      time += timeStep;
+    }
+
+    return res;
+  }
+
+private:
+  const double *m_times;
+  std::array<const double *, D> m_positions;
+  std::size_t m_n;
+  std::array<std::vector<double>, D> m_accs;
+  UniformKnots m_uniform;
+
+  /**
+   * Finds the segment containing a time, hunting from a hint, or bisecting if
+   * the hint is negative
+   *
+   * @returns Index of the lower time of the segment, or -1 if there are fewer
+   * than 2 waypoints
+   */
+  int findSegment(const double t, const int hint) const {
+    if (m_n < 2) {
+      return -1;
+    }
+
+    if (m_uniform.isUniform()) {
+      return m_uniform.getSegment(t);
+    }
+
+    return splhunt(m_times, static_cast<int>(m_n), t, hint);
+  }
+
+  /**
+   * Evaluates position on a segment
+   */
+  Vector<D> evalPos(const double t, const int klo) const {
+    Vector<D> res;
+    SplineSegment seg;
+    if (klo < 0 || !splsegat(m_times, klo, t, &seg)) {
+      return res;
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] = splpos(m_positions[dim], m_accs[dim].data(), seg);
+    }
+
+    return res;
+  }
+
+  /**
+   * Evaluates velocity on a segment
+   */
+  Vector<D> evalVel(const double t, const int klo) const {
+    Vector<D> res;
+    SplineSegment seg;
+    if (klo < 0 || !splsegat(m_times, klo, t, &seg)) {
+      return res;
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] = splvel(m_positions[dim], m_accs[dim].data(), seg);
+    }
+
+    return res;
+  }
+
+  /**
+   * Evaluates acceleration on a segment
+   */
+  Vector<D> evalAcc(const double t, const int klo) const {
+    Vector<D> res;
+    SplineSegment seg;
+    if (klo < 0 || !splsegat(m_times, klo, t, &seg)) {
+      return res;
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] = splacc(m_accs[dim].data(), seg);
+    }
+
+    return res;
+  }
+
+  /**
+   * Evaluates position, velocity, and acceleration on a segment
+   */
+  State<D> evalState(const double t, const int klo) const {
+    State<D> res;
+    SplineSegment seg;
+    if (klo < 0 || !splsegat(m_times, klo, t, &seg)) {
+      return res;
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      splstate(m_positions[dim], m_accs[dim].data(), seg, &res.pos[dim],
+               &res.vel[dim], &res.acc[dim]);
+    }
+
+    return res;
+  }
+};
+} // namespace hermite
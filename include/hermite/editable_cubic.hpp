@@ -0,0 +1,629 @@
+/**
+ * @file
+ *
+ * A natural cubic spline that can be edited one waypoint at a time
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "hermite/base_spline.hpp"
+#include "hermite/cubic/cubic_impl.hpp"
+#include "hermite/pod_vector.hpp"
+#include "hermite/pose.hpp"
+#include "hermite/state.hpp"
+#include "hermite/thirdparty/simplevectors.hpp"
+
+namespace hermite {
+using svector::magn;
+using svector::Vector;
+
+/**
+ * @brief Default tolerance of the local solve after an edit
+ *
+ * Relative to the largest change in the second derivatives near the edit.
+ */
+const double EDIT_TOLERANCE = 1e-12;
+
+/**
+ * @brief Number of waypoints on each side of an edit that are solved first
+ */
+const std::size_t EDIT_WINDOW = 8;
+
+/**
+ * @brief A natural cubic spline that can be edited
+ *
+ * Gives the same spline as Cubic through the same waypoints, but waypoints
+ * can be inserted, replaced, and removed one at a time, without copying all of
+ * them and solving the whole spline again.
+ *
+ * Changing one waypoint changes the second derivatives of the whole spline,
+ * but the change shrinks by at least half with every waypoint away from the
+ * edit (and by about 2 - sqrt(3) if the waypoints are evenly spaced). So after
+ * an edit, only a window of EDIT_WINDOW waypoints on each side of it is solved,
+ * with the second derivatives outside of the window kept. If the change at the
+ * edges of the window is larger than the tolerance times the largest change
+ * inside it, then the window is doubled and solved again. Most edits take
+ * constant time apart from moving the arrays, instead of linear time.
+ *
+ * Like in Cubic, only the velocities of the first and last waypoints are used,
+ * and a velocity greater than 0.99e30 gives that dimension a natural end.
+ *
+ * @note Times are compared exactly, so a waypoint is only replaced or removed
+ * if its time is the same double.
+ */
+template <std::size_t D> class EditableCubic : public BaseSpline<D> {
+public:
+  /**
+   * @brief Default constructor
+   *
+   * Initializes with zero waypoints
+   */
+  EditableCubic() : m_tolerance{EDIT_TOLERANCE}, m_lastSolve{0} {}
+
+  /**
+   * @brief Constructor
+   *
+   * @param waypoints A list of waypoints, which is sorted
+   *
+   * @note Make sure that there are no two waypoints that share the same time,
+   * or there will be undefined behavior.
+   */
+  EditableCubic(const std::vector<Pose<D>> &waypoints)
+      : m_tolerance{EDIT_TOLERANCE}, m_lastSolve{0} {
+    std::vector<Pose<D>> sorted{waypoints};
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Pose<D> &a, const Pose<D> &b) {
+                return a.getTime() < b.getTime();
+              });
+
+    reserve(sorted.size());
+    for (std::size_t i = 0; i < sorted.size(); i++) {
+      insertAt(i, sorted[i]);
+    }
+
+    if (sorted.size() >= 2) {
+      update(0, sorted.size() - 1);
+    }
+  }
+
+  /**
+   * @brief Copy constructor
+   */
+  EditableCubic(const EditableCubic<D> &other)
+      : m_ts{other.m_ts}, m_ys{other.m_ys}, m_accs{other.m_accs},
+        m_vels{other.m_vels}, m_tolerance{other.m_tolerance},
+        m_lastSolve{other.m_lastSolve} {}
+
+  /**
+   * @brief Assignment operator
+   */
+  EditableCubic<D> &operator=(const EditableCubic<D> &other) {
+    if (this == &other) {
+      return *this;
+    }
+
+    m_ts = other.m_ts;
+    m_ys = other.m_ys;
+    m_accs = other.m_accs;
+    m_vels = other.m_vels;
+    m_tolerance = other.m_tolerance;
+    m_lastSolve = other.m_lastSolve;
+
+    return *this;
+  }
+
+  /**
+   * @brief Destructor
+   */
+  ~EditableCubic() override = default;
+
+  /**
+   * @brief Reserves space for a number of waypoints
+   *
+   * @param n Number of waypoints to reserve space for
+   */
+  void reserve(const std::size_t n) {
+    m_ts.reserve(n);
+    m_vels.reserve(n);
+    for (std::size_t dim = 0; dim < D; dim++) {
+      m_ys[dim].reserve(n);
+      m_accs[dim].reserve(n);
+    }
+  }
+
+  /**
+   * @brief Gets the number of waypoints
+   *
+   * @returns Number of waypoints
+   */
+  std::size_t size() const { return m_ts.size(); }
+
+  /**
+   * @brief Sets the tolerance of the local solve after an edit
+   *
+   * @param tolerance Largest change in the second derivatives at the edges of
+   * the solved window, relative to the largest change inside of it. With
+   * zero, the window grows until the change at its edges is lost to rounding.
+   */
+  void setTolerance(const double tolerance) { m_tolerance = tolerance; }
+
+  /**
+   * @brief Gets the tolerance of the local solve after an edit
+   *
+   * @returns Tolerance, EDIT_TOLERANCE by default
+   */
+  double getTolerance() const { return m_tolerance; }
+
+  /**
+   * @brief Gets the number of waypoints solved by the last edit
+   *
+   * @returns Size of the window of the last solve, including any retries
+   */
+  std::size_t getLastSolveSize() const { return m_lastSolve; }
+
+  /**
+   * @brief Inserts a waypoint
+   *
+   * @param waypoint Waypoint to insert
+   *
+   * @note If the waypoint's time exists, then this method does nothing.
+   */
+  void insert(const Pose<D> &waypoint) {
+    const std::size_t idx = lowerIndex(waypoint.getTime());
+    if (idx < m_ts.size() && m_ts[idx] == waypoint.getTime()) {
+      return;
+    }
+
+    insertAt(idx, waypoint);
+    // the rows of the waypoint and its neighbors change
+    update(idx > 0 ? idx - 1 : 0, std::min(idx + 1, m_ts.size() - 1));
+  }
+
+  /**
+   * @brief Replaces a waypoint
+   *
+   * @param waypoint Waypoint to replace
+   *
+   * @note Gets the time from the waypoint.
+   * @note If the waypoint does not exist, then this method does not change
+   * anything.
+   */
+  void replace(const Pose<D> &waypoint) {
+    const std::size_t idx = lowerIndex(waypoint.getTime());
+    if (idx == m_ts.size() || m_ts[idx] != waypoint.getTime()) {
+      return;
+    }
+
+    const auto &pos = waypoint.getPosData();
+    for (std::size_t dim = 0; dim < D; dim++) {
+      m_ys[dim][idx] = pos[dim];
+    }
+    m_vels[idx] = waypoint.getVelData();
+
+    update(idx > 0 ? idx - 1 : 0, std::min(idx + 1, m_ts.size() - 1));
+  }
+
+  /**
+   * @brief Inserts a waypoint if it doesn't exist, otherwise replaces the
+   * waypoint.
+   *
+   * @param waypoint Waypoint to insert or replace
+   */
+  void insertOrReplace(const Pose<D> &waypoint) {
+    if (exists(waypoint.getTime())) {
+      replace(waypoint);
+    } else {
+      insert(waypoint);
+    }
+  }
+
+  /**
+   * @brief Removes a waypoint
+   *
+   * @param waypoint Waypoint to remove
+   *
+   * @note Only the waypoint's time is used in this method.
+   */
+  void erase(const Pose<D> &waypoint) { erase(waypoint.getTime()); }
+
+  /**
+   * @brief Removes a waypoint
+   *
+   * @param time Time of waypoint to remove
+   *
+   * @note If there is no waypoint at the time, then this method does nothing.
+   */
+  void erase(const double time) {
+    const std::size_t idx = lowerIndex(time);
+    if (idx == m_ts.size() || m_ts[idx] != time) {
+      return;
+    }
+
+    m_ts.erase(m_ts.begin() + idx);
+    m_vels.erase(m_vels.begin() + idx);
+    for (std::size_t dim = 0; dim < D; dim++) {
+      m_ys[dim].erase(m_ys[dim].begin() + idx);
+      m_accs[dim].erase(m_accs[dim].begin() + idx);
+    }
+
+    // the rows of the neighbors change
+    const std::size_t n = m_ts.size();
+    if (n >= 2) {
+      update(idx > 0 ? idx - 1 : 0, std::min(idx, n - 1));
+    }
+  }
+
+  /**
+   * @brief Checks if a waypoint at a certain time exists
+   *
+   * @param time Checks if a waypoint exists at this time
+   *
+   * @returns If waypoint exists.
+   */
+  bool exists(const double time) const {
+    return std::binary_search(m_ts.begin(), m_ts.end(), time);
+  }
+
+  /**
+   * @brief Gets a list of all waypoints
+   *
+   * @returns A list of all waypoints, sorted in order of time.
+   */
+  std::vector<Pose<D>> getAllWaypoints() const {
+    std::vector<Pose<D>> res;
+    res.reserve(m_ts.size());
+    for (std::size_t i = 0; i < m_ts.size(); i++) {
+      PodVector<D> pos;
+      for (std::size_t dim = 0; dim < D; dim++) {
+        pos[dim] = m_ys[dim][i];
+      }
+      res.push_back(Pose<D>{m_ts[i], pos, m_vels[i]});
+    }
+
+    return res;
+  }
+
+  /**
+   * @brief Gets the lower bound of the domain of the piecewise spline function,
+   * which is the first time.
+   *
+   * @note If there are no waypoints, then returns 0
+   *
+   * @returns The first time
+   */
+  double getLowestTime() const override {
+    if (m_ts.size() == 0) {
+      return 0;
+    }
+
+    return m_ts[0];
+  }
+
+  /**
+   * @brief Gets the upper bound of the domain of the piecewise spline function,
+   * which is the last time.
+   *
+   * @note If there are no waypoints, then returns 0
+   *
+   * @returns The last time
+   */
+  double getHighestTime() const override {
+    if (m_ts.size() == 0) {
+      return 0;
+    }
+
+    return m_ts[m_ts.size() - 1];
+  }
+
+  /**
+   * @brief Gets position at a certain time
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns a
+   * zero vector.
+   *
+   * @param t Time
+   *
+   * @returns Position
+   */
+  Vector<D> getPos(const double t) const override {
+    return evalPos(t, findSegment(t, -1));
+  }
+
+  /**
+   * @brief Gets velocity at a certain time
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns a
+   * zero vector.
+   *
+   * @param t Time
+   *
+   * @returns Velocity
+   */
+  Vector<D> getVel(const double t) const override {
+    return evalVel(t, findSegment(t, -1));
+  }
+
+  /**
+   * @brief Gets acceleration at a certain time
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns a
+   * zero vector.
+   *
+   * @param t Time
+   *
+   * @returns Acceleration
+   */
+  Vector<D> getAcc(const double t) const override {
+    return evalAcc(t, findSegment(t, -1));
+  }
+
+  /**
+   * @brief Gets position, velocity, and acceleration at a certain time
+   *
+   * Only searches for the segment once.
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns zero
+   * vectors.
+   *
+   * @param t Time
+   *
+   * @returns Position, velocity, and acceleration
+   */
+  State<D> getState(const double t) const override {
+    return evalState(t, findSegment(t, -1));
+  }
+
+  /**
+   * @brief Gets positions, velocities, and accelerations at many times at once
+   *
+   * @note If the times are sorted, then the segment is found by walking from
+   * the previous one.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n states
+   */
+  void getStateBatch(const double ts[], const std::size_t n,
+                     State<D> out[]) const override {
+    int seg = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      seg = findSegment(ts[i], seg);
+      out[i] = evalState(ts[i], seg);
+    }
+  }
+
+  /**
+   * @brief Gets arc length
+   *
+   * @param timeStep The time step to try for the arc length
+   *
+   * @note This function will take much longer for smaller timesteps.
+   * Recommended is between 0.001 and 0.1, but this also depends on the domain
+   * of your function.
+   * @note If zero or one waypoints, returns 0.
+   *
+   * @returns Arc length
+   */
+  double getLength(const double timeStep) const override {
+    double res = 0.0;
+
+    if (m_ts.size() < 2) {
+      return res;
+    }
+
+    double time = getLowestTime() + timeStep;
+    const double timeEnd = getHighestTime();
+    int seg = 0;
+    while (time <= timeEnd) {
+      seg = findSegment(time, seg);
+      res += magn(evalVel(time, seg)) * timeStep;
+
+      time += timeStep;
+    }
+
+    return res;
+  }
+
+private:
+  std::vector<double> m_ts;
+  std::array<std::vector<double>, D> m_ys;
+  std::array<std::vector<double>, D> m_accs;
+  std::vector<PodVector<D>> m_vels;
+  double m_tolerance;
+  std::size_t m_lastSolve;
+  std::vector<double> m_work; // scratch space for update()
+
+  /**
+   * Gets the index of the first waypoint at or after a time
+   */
+  std::size_t lowerIndex(const double time) const {
+    return static_cast<std::size_t>(
+        std::lower_bound(m_ts.begin(), m_ts.end(), time) - m_ts.begin());
+  }
+
+  /**
+   * Inserts a waypoint at an index without solving, starting its second
+   * derivatives between those of its neighbors
+   */
+  void insertAt(const std::size_t idx, const Pose<D> &waypoint) {
+    const std::size_t n = m_ts.size();
+    const auto &pos = waypoint.getPosData();
+    for (std::size_t dim = 0; dim < D; dim++) {
+      const auto &accs = m_accs[dim];
+      const double before = idx > 0 ? accs[idx - 1] : 0;
+      const double after = idx < n ? accs[idx] : before;
+      m_accs[dim].insert(m_accs[dim].begin() + idx,
+                         idx > 0 ? 0.5 * (before + after) : after);
+      m_ys[dim].insert(m_ys[dim].begin() + idx, pos[dim]);
+    }
+
+    m_ts.insert(m_ts.begin() + idx, waypoint.getTime());
+    m_vels.insert(m_vels.begin() + idx, waypoint.getVelData());
+  }
+
+  /**
+   * Solves the spline again after the rows first to last of the system
+   * changed, growing the window around them until the change at its edges is
+   * within the tolerance
+   */
+  void update(const std::size_t first, const std::size_t last) {
+    const std::size_t n = m_ts.size();
+    if (n < 2) {
+      m_lastSolve = 0;
+      return;
+    }
+
+    m_lastSolve = 0;
+    std::size_t window = EDIT_WINDOW;
+    while (true) {
+      const std::size_t lo = first > window ? first - window : 0;
+      const std::size_t hi = std::min(last + window, n - 1);
+      const std::size_t len = hi - lo + 1;
+      const bool whole = lo == 0 && hi == n - 1;
+      if (m_work.size() < (D + 1) * len) {
+        m_work.resize((D + 1) * len);
+      }
+
+      double *cp = m_work.data();
+      double *out = cp + len;
+      for (std::size_t dim = 0; dim < D; dim++) {
+        splwindow(m_ts.data(), m_ys[dim].data(), static_cast<int>(n),
+                  m_vels[0][dim], m_vels[n - 1][dim], static_cast<int>(lo),
+                  static_cast<int>(hi), m_accs[dim].data(), cp,
+                  out + dim * len);
+      }
+      m_lastSolve += len;
+
+      if (whole || isSettled(lo, hi, out)) {
+        for (std::size_t dim = 0; dim < D; dim++) {
+          std::copy(out + dim * len, out + (dim + 1) * len,
+                    m_accs[dim].begin() + lo);
+        }
+        return;
+      }
+
+      window *= 2;
+    }
+  }
+
+  /**
+   * Checks whether the change in the second derivatives at the edges of a
+   * window is within the tolerance
+   */
+  bool isSettled(const std::size_t lo, const std::size_t hi,
+                 const double out[]) const {
+    const std::size_t n = m_ts.size();
+    const std::size_t len = hi - lo + 1;
+
+    double change = 0;
+    double edge = 0;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      for (std::size_t i = 0; i < len; i++) {
+        const double diff = std::fabs(out[dim * len + i] - m_accs[dim][lo + i]);
+        change = std::max(change, diff);
+        if ((i == 0 && lo > 0) || (i == len - 1 && hi < n - 1)) {
+          edge = std::max(edge, diff);
+        }
+      }
+    }
+
+    return edge <= m_tolerance * change;
+  }
+
+  /**
+   * Finds the segment containing a time, hunting from a hint, or bisecting if
+   * the hint is negative
+   *
+   * @returns Index of the lower time of the segment, or -1 if there are fewer
+   * than 2 waypoints
+   */
+  int findSegment(const double t, const int hint) const {
+    if (m_ts.size() < 2) {
+      return -1;
+    }
+
+    return splhunt(m_ts.data(), static_cast<int>(m_ts.size()), t, hint);
+  }
+
+  /**
+   * Evaluates position on a segment
+   */
+  Vector<D> evalPos(const double t, const int klo) const {
+    Vector<D> res;
+    SplineSegment seg;
+    if (klo < 0 || !splsegat(m_ts.data(), klo, t, &seg)) {
+      return res;
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] = splpos(m_ys[dim].data(), m_accs[dim].data(), seg);
+    }
+
+    return res;
+  }
+
+  /**
+   * Evaluates velocity on a segment
+   */
+  Vector<D> evalVel(const double t, const int klo) const {
+    Vector<D> res;
+    SplineSegment seg;
+    if (klo < 0 || !splsegat(m_ts.data(), klo, t, &seg)) {
+      return res;
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] = splvel(m_ys[dim].data(), m_accs[dim].data(), seg);
+    }
+
+    return res;
+  }
+
+  /**
+   * Evaluates acceleration on a segment
+   */
+  Vector<D> evalAcc(const double t, const int klo) const {
+    Vector<D> res;
+    SplineSegment seg;
+    if (klo < 0 || !splsegat(m_ts.data(), klo, t, &seg)) {
+      return res;
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] = splacc(m_accs[dim].data(), seg);
+    }
+
+    return res;
+  }
+
+  /**
+   * Evaluates position, velocity, and acceleration on a segment
+   */
+  State<D> evalState(const double t, const int klo) const {
+    State<D> res;
+    SplineSegment seg;
+    if (klo < 0 || !splsegat(m_ts.data(), klo, t, &seg)) {
+      return res;
+    }
+
+    for (std::size_t dim = 0; dim < D; dim++) {
+      splstate(m_ys[dim].data(), m_accs[dim].data(), seg, &res.pos[dim],
+               &res.vel[dim], &res.acc[dim]);
+    }
+
+    return res;
+  }
+};
+} // namespace hermite
@@ -0,0 +1,959 @@
+/**
+ * @file
+ *
+ * A hermite spline class with contiguous waypoint storage
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "hermite/base_spline.hpp"
+#include "hermite/compiled.hpp"
+#include "hermite/hermite/hermite_sub.hpp"
+#include "hermite/knot_index.hpp"
+#include "hermite/pod_vector.hpp"
+#include "hermite/pose.hpp"
+#include "hermite/state.hpp"
+#include "hermite/thirdparty/simplevectors.hpp"
+
+namespace hermite {
+using svector::magn;
+
+/**
+ * @brief Hermite spline class with contiguous waypoint storage
+ *
+ * Interpolates the same path as Hermite and has the same methods for editing
+ * waypoints, but instead of a std::map, the waypoints are kept in sorted
+ * arrays: one for the rounded times, one for the times, one for the positions,
+ * and one for the velocities. Finding the subinterval of a time is then a
+ * binary search over an array of integers, which is much friendlier to the
+ * cache than walking the nodes of a map once there are many waypoints.
+ *
+ * The trade-off is that inserting or erasing a waypoint in the middle takes
+ * linear time, since the later waypoints have to be moved. Appending a
+ * waypoint after the last one takes amortized constant time, and many edits in
+ * the middle can be done together in linear time with insertBatch() and
+ * eraseBatch().
+ *
+ * Like Hermite, times are rounded by multiplying by a multiplier and
+ * truncating the rest of the digits.
+ */
+template <std::size_t D> class FlatHermite : public BaseSpline<D> {
+public:
+  /**
+   * @brief Evaluation cursor
+   *
+   * Remembers the subinterval that it last evaluated, so evaluating at a time
+   * close to the previous one takes amortized constant time.
+   *
+   * The cursor notices when the FlatHermite object has been modified and
+   * searches again, but the FlatHermite object must outlive the cursor.
+   */
+  class Cursor {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param spline FlatHermite object to evaluate
+     */
+    explicit Cursor(const FlatHermite<D> &spline)
+        : m_spline{&spline}, m_upper{0}, m_revision{0}, m_valid{false} {}
+
+    /**
+     * @brief Gets position at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as FlatHermite::getPos()
+     */
+    Vector<D> getPos(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_sub.getPos(t);
+    }
+
+    /**
+     * @brief Gets velocity at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as FlatHermite::getVel()
+     */
+    Vector<D> getVel(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_sub.getVel(t);
+    }
+
+    /**
+     * @brief Gets acceleration at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as FlatHermite::getAcc()
+     */
+    Vector<D> getAcc(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_sub.getAcc(t);
+    }
+
+    /**
+     * @brief Gets position, velocity, and acceleration at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as FlatHermite::getState()
+     */
+    State<D> getState(const double t) {
+      if (!seek(t)) {
+        return State<D>{};
+      }
+
+      return m_sub.getState(t);
+    }
+
+    /**
+     * @brief Forgets the current subinterval
+     */
+    void reset() { m_valid = false; }
+
+  private:
+    const FlatHermite<D> *m_spline;
+    std::size_t m_upper;
+    HermiteSub<D> m_sub;
+    std::size_t m_revision;
+    bool m_valid;
+
+    /**
+     * Moves the cursor to the subinterval containing a certain time
+     *
+     * @returns False if there are not enough waypoints to evaluate
+     */
+    bool seek(const double t) {
+      if (m_spline->m_keys.size() < 2) {
+        m_valid = false;
+        return false;
+      }
+
+      if (!m_valid || m_revision != m_spline->m_revision) {
+        m_upper = m_spline->getUpper(t);
+        m_sub = m_spline->getSub(m_upper);
+        m_revision = m_spline->m_revision;
+        m_valid = true;
+        return true;
+      }
+
+      const std::size_t next = m_spline->getUpper(t, m_upper);
+      if (next != m_upper) {
+        m_upper = next;
+        m_sub = m_spline->getSub(m_upper);
+      }
+
+      return true;
+    }
+  };
+
+  /**
+   * @brief Default constructor
+   *
+   * Sets multiplier to 10, like Hermite.
+   */
+  FlatHermite() : m_multiplier{10LL}, m_step{0}, m_revision{0} {}
+
+  /**
+   * @brief Constructor
+   *
+   * @param multiplier Multiplies the time given in the pose by the multiplier,
+   * then truncates the rest of the digits when storing the waypoint.
+   */
+  FlatHermite(const double multiplier)
+      : m_multiplier{multiplier}, m_step{0}, m_revision{0} {}
+
+  /**
+   * @brief Copy constructor
+   */
+  FlatHermite(const FlatHermite<D> &other)
+      : m_multiplier{other.m_multiplier}, m_keys{other.m_keys},
+        m_times{other.m_times}, m_pos{other.m_pos}, m_vel{other.m_vel},
+        m_step{other.m_step}, m_index{other.m_index}, m_revision{0} {}
+
+  /**
+   * @brief Assignment operator
+   *
+   * @note All data stored in current FlatHermite object will be lost.
+   */
+  FlatHermite<D> &operator=(const FlatHermite<D> &other) {
+    // check if assigning to self
+    if (this == &other) {
+      return *this;
+    }
+
+    m_multiplier = other.m_multiplier;
+    m_keys = other.m_keys;
+    m_times = other.m_times;
+    m_pos = other.m_pos;
+    m_vel = other.m_vel;
+    m_step = other.m_step;
+    m_index = other.m_index;
+    m_revision++;
+
+    return *this;
+  }
+
+  /**
+   * @brief Destructor
+   */
+  ~FlatHermite() override = default;
+
+  /**
+   * @brief Reserves space for a number of waypoints
+   *
+   * @param n Number of waypoints to reserve space for
+   */
+  void reserve(const std::size_t n) {
+    m_keys.reserve(n);
+    m_times.reserve(n);
+    m_pos.reserve(n);
+    m_vel.reserve(n);
+  }
+
+  /**
+   * @brief Gets the number of waypoints
+   *
+   * @returns Number of waypoints
+   */
+  std::size_t size() const { return m_keys.size(); }
+
+  /**
+   * @brief Checks whether the waypoints are evenly spaced in time
+   *
+   * Checks the rounded times exactly, so there is no tolerance. If they are
+   * evenly spaced, then subintervals are found in constant time instead of
+   * with a binary search.
+   *
+   * @returns True if there are at least 2 waypoints and they are evenly spaced
+   */
+  bool isUniform() const { return m_step != 0; }
+
+  /**
+   * @brief Builds a search index over the rounded times
+   *
+   * Speeds up getPos(), getVel(), getAcc(), and getState() at random times when
+   * there are many waypoints, at the cost of a second copy of the rounded
+   * times. Not needed if the waypoints are evenly spaced.
+   *
+   * @note Adding or removing waypoints drops the index, so call this after
+   * building the path.
+   *
+   * @see KnotIndex
+   */
+  void buildIndex() {
+    m_index = KnotIndex<std::int64_t>{m_keys.data(), m_keys.size()};
+  }
+
+  /**
+   * @brief Checks whether the search index has been built
+   *
+   * @returns True if buildIndex() has been called since the waypoints were
+   * last added or removed
+   */
+  bool hasIndex() const { return !m_index.empty(); }
+
+  /**
+   * @brief Inserts a waypoint
+   *
+   * @param waypoint Waypoint to insert
+   *
+   * @note If the waypoint's time exists (rounded according to the multiplier),
+   * then this method does nothing.
+   * @note Takes amortized constant time if the waypoint is after the last
+   * waypoint, and linear time otherwise.
+   */
+  void insert(const Pose<D> &waypoint) {
+    const auto key = roundTime(waypoint.getTime());
+    const std::size_t idx = lowerIndex(key);
+    if (idx < m_keys.size() && m_keys[idx] == key) {
+      return;
+    }
+
+    insertAt(idx, key, waypoint);
+  }
+
+  /**
+   * @brief Replaces a waypoint
+   *
+   * @param waypoint Waypoint to replace
+   *
+   * @note Gets the time from the waypoint.
+   * @note If the waypoint does not exist, then this method does not change
+   * anything.
+   */
+  void replace(const Pose<D> &waypoint) {
+    const auto key = roundTime(waypoint.getTime());
+    const std::size_t idx = lowerIndex(key);
+    if (idx == m_keys.size() || m_keys[idx] != key) {
+      return;
+    }
+
+    setAt(idx, waypoint);
+  }
+
+  /**
+   * @brief Inserts a waypoint if it doesn't exist, otherwise replaces the
+   * waypoint.
+   *
+   * @param waypoint Waypoint to insert or replace
+   */
+  void insertOrReplace(const Pose<D> &waypoint) {
+    const auto key = roundTime(waypoint.getTime());
+    const std::size_t idx = lowerIndex(key);
+    if (idx < m_keys.size() && m_keys[idx] == key) {
+      setAt(idx, waypoint);
+    } else {
+      insertAt(idx, key, waypoint);
+    }
+  }
+
+  /**
+   * @brief Inserts many waypoints at once
+   *
+   * Sorts the new waypoints and merges them with the existing ones, which
+   * takes O(n + m log m) time for n existing and m new waypoints, instead of
+   * O(nm) for inserting them one by one.
+   *
+   * @param waypoints Waypoints to insert, in any order
+   *
+   * @note Same as calling insert() on each waypoint in order: waypoints whose
+   * rounded time already exists are ignored, and if two new waypoints have the
+   * same rounded time, then only the first one is inserted.
+   */
+  void insertBatch(const std::vector<Pose<D>> &waypoints) {
+    std::vector<std::pair<std::int64_t, std::size_t>> order;
+    order.reserve(waypoints.size());
+    for (std::size_t i = 0; i < waypoints.size(); i++) {
+      const auto key = roundTime(waypoints[i].getTime());
+      if (!std::binary_search(m_keys.begin(), m_keys.end(), key)) {
+        order.push_back(std::make_pair(key, i));
+      }
+    }
+
+    // sorting the pairs keeps the first of any repeated keys in front
+    std::sort(order.begin(), order.end());
+    order.erase(std::unique(order.begin(), order.end(),
+                            [](const std::pair<std::int64_t, std::size_t> &a,
+                               const std::pair<std::int64_t, std::size_t> &b) {
+                              return a.first == b.first;
+                            }),
+                order.end());
+
+    if (order.size() == 0) {
+      return;
+    }
+
+    // merge from the back so that nothing is moved more than once
+    const std::size_t oldSize = m_keys.size();
+    const std::size_t newSize = oldSize + order.size();
+    m_keys.resize(newSize);
+    m_times.resize(newSize);
+    m_pos.resize(newSize);
+    m_vel.resize(newSize);
+
+    std::size_t oldIdx = oldSize;
+    std::size_t newIdx = order.size();
+    for (std::size_t dest = newSize; dest-- > 0;) {
+      if (newIdx > 0 &&
+          (oldIdx == 0 || m_keys[oldIdx - 1] < order[newIdx - 1].first)) {
+        newIdx--;
+        const auto &waypoint = waypoints[order[newIdx].second];
+        m_keys[dest] = order[newIdx].first;
+        m_times[dest] = waypoint.getTime();
+        m_pos[dest] = waypoint.getPosData();
+        m_vel[dest] = waypoint.getVelData();
+      } else {
+        oldIdx--;
+        m_keys[dest] = m_keys[oldIdx];
+        m_times[dest] = m_times[oldIdx];
+        m_pos[dest] = m_pos[oldIdx];
+        m_vel[dest] = m_vel[oldIdx];
+      }
+    }
+
+    updateStep(false);
+    m_revision++;
+  }
+
+  /**
+   * @brief Checks if a waypoint exists
+   *
+   * @param waypoint Checks if this waypoint exists
+   *
+   * @note Only uses the time argument of the waypoint.
+   *
+   * @returns If waypoint exists.
+   */
+  bool exists(const Pose<D> &waypoint) const {
+    return exists(waypoint.getTime());
+  }
+
+  /**
+   * @brief Checks if a waypoint at a certain time exists
+   *
+   * @param time Checks if a waypoint exists at this time
+   *
+   * @returns If waypoint exists.
+   */
+  bool exists(const double time) const {
+    const auto key = roundTime(time);
+    return std::binary_search(m_keys.begin(), m_keys.end(), key);
+  }
+
+  /**
+   * @brief Removes a waypoint
+   *
+   * @param waypoint Waypoint to remove
+   *
+   * @note Only the waypoint's time is used in this method.
+   * @note The waypoint's time is rounded by using the multplier
+   */
+  void erase(const Pose<D> &waypoint) { erase(waypoint.getTime()); }
+
+  /**
+   * @brief Removes a waypoint
+   *
+   * @param time Time of waypoint to remove
+   *
+   * @note The waypoint's time is rounded by using the multplier
+   * @note Takes constant time for the last waypoint, and linear time
+   * otherwise.
+   */
+  void erase(const double time) {
+    const auto key = roundTime(time);
+    const std::size_t idx = lowerIndex(key);
+    if (idx == m_keys.size() || m_keys[idx] != key) {
+      return;
+    }
+
+    m_keys.erase(m_keys.begin() + idx);
+    m_times.erase(m_times.begin() + idx);
+    m_pos.erase(m_pos.begin() + idx);
+    m_vel.erase(m_vel.begin() + idx);
+    // removing the last of evenly spaced waypoints keeps them evenly spaced
+    updateStep(idx == m_keys.size() && m_step != 0);
+    m_revision++;
+  }
+
+  /**
+   * @brief Removes many waypoints at once
+   *
+   * Compacts the arrays in one pass, which takes O(n + m log m) time for n
+   * existing waypoints and m times, instead of O(nm) for erasing them one by
+   * one.
+   *
+   * @param times Times of the waypoints to remove, in any order
+   *
+   * @note Times that do not exist are ignored.
+   */
+  void eraseBatch(const std::vector<double> &times) {
+    std::vector<std::int64_t> keys;
+    keys.reserve(times.size());
+    for (const double time : times) {
+      keys.push_back(roundTime(time));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::size_t dest = 0;
+    for (std::size_t src = 0; src < m_keys.size(); src++) {
+      if (std::binary_search(keys.begin(), keys.end(), m_keys[src])) {
+        continue;
+      }
+
+      if (dest != src) {
+        m_keys[dest] = m_keys[src];
+        m_times[dest] = m_times[src];
+        m_pos[dest] = m_pos[src];
+        m_vel[dest] = m_vel[src];
+      }
+      dest++;
+    }
+
+    if (dest == m_keys.size()) {
+      return;
+    }
+
+    m_keys.resize(dest);
+    m_times.resize(dest);
+    m_pos.resize(dest);
+    m_vel.resize(dest);
+    updateStep(false);
+    m_revision++;
+  }
+
+  /**
+   * @brief Gets a list of all waypoints
+   *
+   * @returns A list of all waypoints, sorted in order of time.
+   */
+  std::vector<Pose<D>> getAllWaypoints() const {
+    std::vector<Pose<D>> res;
+    res.reserve(m_keys.size());
+    for (std::size_t i = 0; i < m_keys.size(); i++) {
+      res.push_back(Pose<D>{m_times[i], m_pos[i], m_vel[i]});
+    }
+
+    return res;
+  }
+
+  /**
+   * @brief Compiles the spline into a table of polynomial coefficients
+   *
+   * @tparam T Scalar type of the coefficients
+   *
+   * @returns Compiled spline
+   *
+   * @see Hermite::compile()
+   */
+  template <typename T = double> CompiledSpline<D, T> compile() const {
+    std::vector<double> coefs;
+    if (m_keys.size() >= 2) {
+      coefs.resize(4 * D * (m_keys.size() - 1));
+      for (std::size_t upper = 1; upper < m_keys.size(); upper++) {
+        getSub(upper).getPowerBasis(&coefs[4 * D * (upper - 1)]);
+      }
+    }
+
+    return CompiledSpline<D, T>{m_times,
+                                convertCoefficients<T>(std::move(coefs))};
+  }
+
+  /**
+   * @brief Gets the lower bound of the domain of the piecewise spline function,
+   * which is the first time (lowest t-value) listed in the waypoints.
+   *
+   * @note If there are no waypoints, then returns 0
+   *
+   * @returns The first time measurement
+   */
+  double getLowestTime() const override {
+    if (m_times.size() == 0) {
+      return 0;
+    }
+
+    return m_times[0];
+  }
+
+  /**
+   * @brief Gets the upper bound of the domain of the piecewise spline function,
+   * which is the last time (highest t-value) listed in the waypoints.
+   *
+   * @note If there are no waypoints, then returns 0
+   *
+   * @returns The last time measurement
+   */
+  double getHighestTime() const override {
+    if (m_times.size() == 0) {
+      return 0;
+    }
+
+    return m_times[m_times.size() - 1];
+  }
+
+  /**
+   * @brief Gets position at a certain time
+   *
+   * Same as calling operator()()
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns a
+   * zero vector.
+   *
+   * @param t Time
+   *
+   * @returns Position
+   */
+  Vector<D> getPos(const double t) const override {
+    if (m_keys.size() < 2) {
+      return Vector<D>{};
+    }
+
+    return getSub(getUpper(t)).getPos(t);
+  }
+
+  /**
+   * @brief Gets velocity at a certain time
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns a
+   * zero vector.
+   *
+   * @param t Time
+   *
+   * @returns Velocity
+   */
+  Vector<D> getVel(const double t) const override {
+    if (m_keys.size() < 2) {
+      return Vector<D>{};
+    }
+
+    return getSub(getUpper(t)).getVel(t);
+  }
+
+  /**
+   * @brief Gets acceleration of the function at a certain time
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns a
+   * zero vector.
+   * @note If called on a border between two functions, will take the value of
+   * the latter function.
+   *
+   * @param t Time
+   *
+   * @returns Acceleration
+   */
+  Vector<D> getAcc(const double t) const override {
+    if (m_keys.size() < 2) {
+      return Vector<D>{};
+    }
+
+    return getSub(getUpper(t)).getAcc(t);
+  }
+
+  /**
+   * @brief Gets position, velocity, and acceleration at a certain time
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns zero
+   * vectors.
+   *
+   * @param t Time
+   *
+   * @returns Position, velocity, and acceleration
+   */
+  State<D> getState(const double t) const override {
+    if (m_keys.size() < 2) {
+      return State<D>{};
+    }
+
+    return getSub(getUpper(t)).getState(t);
+  }
+
+  /**
+   * @brief Gets positions at many times at once
+   *
+   * @note If the times are sorted, then the subinterval is found by walking
+   * from the previous one, and times that fall in the same subinterval are
+   * evaluated together with the vectorized kernels of HermiteSub.
+   * @note If number of waypoints is less than or equal to 1, then fills the
+   * output with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getPosBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    evalRuns(0, ts, n, out);
+  }
+
+  /**
+   * @brief Gets velocities at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   *
+   * @see getPosBatch()
+   */
+  void getVelBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    evalRuns(1, ts, n, out);
+  }
+
+  /**
+   * @brief Gets accelerations at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   *
+   * @see getPosBatch()
+   */
+  void getAccBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    evalRuns(2, ts, n, out);
+  }
+
+  /**
+   * @brief Gets positions, velocities, and accelerations at many times at once
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n states
+   */
+  void getStateBatch(const double ts[], const std::size_t n,
+                     State<D> out[]) const override {
+    if (m_keys.size() < 2) {
+      std::fill(out, out + n, State<D>{});
+      return;
+    }
+
+    Cursor cur{*this};
+    for (std::size_t i = 0; i < n; i++) {
+      out[i] = cur.getState(ts[i]);
+    }
+  }
+
+  /**
+   * @brief Gets arc length
+   *
+   * @param timeStep The time step to try for the arc length
+   *
+   * @note This function will take much longer for smaller timesteps.
+   * Recommended is between 0.001 and 0.1, but this also depends on the domain
+   * of your function.
+   * @note If zero or one poses, returns 0.
+   *
+   * @returns Arc length
+   */
+  double getLength(const double timeStep) const override {
+    double res = 0.0;
+
+    if (m_keys.size() < 2) {
+      return res;
+    }
+
+    Cursor cur{*this};
+    double time = getLowestTime() + timeStep;
+    const double timeEnd = getHighestTime();
+    while (time <= timeEnd) {
+      auto vel = cur.getVel(time);
+      auto speed = magn(vel);
+      res += speed * timeStep;
+
+      time += timeStep;
+    }
+
+    return res;
+  }
+
+private:
+  double m_multiplier;
+  std::vector<std::int64_t> m_keys;
+  std::vector<double> m_times;
+  std::vector<PodVector<D>> m_pos;
+  std::vector<PodVector<D>> m_vel;
+  std::int64_t m_step; // spacing of the rounded times, or 0 if not even
+  KnotIndex<std::int64_t> m_index;
+  std::size_t m_revision;
+
+  /**
+   * @brief Rounds time to int
+   *
+   * @param t Time to round
+   *
+   * @returns Rounded time
+   */
+  std::int64_t roundTime(double t) const {
+    t *= m_multiplier;
+    return static_cast<std::int64_t>(t);
+  }
+
+  /**
+   * Gets the index of the first rounded time that is not less than a key
+   */
+  std::size_t lowerIndex(const std::int64_t key) const {
+    return static_cast<std::size_t>(
+        std::lower_bound(m_keys.begin(), m_keys.end(), key) - m_keys.begin());
+  }
+
+  /**
+   * Inserts a waypoint before a certain index
+   */
+  void insertAt(const std::size_t idx, const std::int64_t key,
+                const Pose<D> &waypoint) {
+    m_keys.insert(m_keys.begin() + idx, key);
+    m_times.insert(m_times.begin() + idx, waypoint.getTime());
+    m_pos.insert(m_pos.begin() + idx, waypoint.getPosData());
+    m_vel.insert(m_vel.begin() + idx, waypoint.getVelData());
+    updateStep(idx == m_keys.size() - 1);
+    m_revision++;
+  }
+
+  /**
+   * Updates the spacing of the rounded times after waypoints are added or
+   * removed, and drops the search index, which no longer matches
+   *
+   * @param atEnd True if the only change was adding or removing the last
+   * waypoint, which can be checked in constant time
+   */
+  void updateStep(const bool atEnd) {
+    m_index = KnotIndex<std::int64_t>{};
+
+    const std::size_t n = m_keys.size();
+    if (n < 2) {
+      m_step = 0;
+      return;
+    }
+
+    if (atEnd && n > 2) {
+      if (m_keys[n - 1] - m_keys[n - 2] != m_step) {
+        m_step = 0;
+      }
+      return;
+    }
+
+    m_step = m_keys[1] - m_keys[0];
+    for (std::size_t i = 2; i < n; i++) {
+      if (m_keys[i] - m_keys[i - 1] != m_step) {
+        m_step = 0;
+        return;
+      }
+    }
+  }
+
+  /**
+   * Overwrites the waypoint at a certain index
+   */
+  void setAt(const std::size_t idx, const Pose<D> &waypoint) {
+    m_times[idx] = waypoint.getTime();
+    m_pos[idx] = waypoint.getPosData();
+    m_vel[idx] = waypoint.getVelData();
+    m_revision++;
+  }
+
+  /**
+   * Gets the index of the waypoint at the upper end of the subinterval
+   * containing a certain time
+   *
+   * Uses the same rules as Hermite, so the same subinterval is picked. If the
+   * rounded times are evenly spaced, then the index is computed directly, and
+   * if the search index has been built, then it is used.
+   *
+   * @note Assumes that number of waypoints is greater than or equal to 2.
+   *
+   * @returns Index between 1 and n - 1
+   */
+  std::size_t getUpper(const double t) const {
+    const auto key = roundTime(t);
+    if (m_step != 0) {
+      // number of rounded times less than or equal to key, like upper_bound
+      const std::int64_t count = (key - m_keys[0]) / m_step + 1;
+      const std::int64_t last = static_cast<std::int64_t>(m_keys.size()) - 1;
+      return static_cast<std::size_t>(
+          std::min(std::max(count, std::int64_t{1}), last));
+    }
+
+    if (!m_index.empty()) {
+      const std::size_t idx = m_index.upperBound(key);
+      return std::min(std::max(idx, std::size_t{1}), m_keys.size() - 1);
+    }
+
+    const std::size_t idx = static_cast<std::size_t>(
+        std::upper_bound(m_keys.begin(), m_keys.end(), key) - m_keys.begin());
+
+    return std::min(std::max(idx, std::size_t{1}), m_keys.size() - 1);
+  }
+
+  /**
+   * Gets the index of the waypoint at the upper end of the subinterval
+   * containing a certain time, walking from a hint
+   *
+   * If the time is within a few subintervals of the hint, then this takes
+   * constant time. Otherwise, it searches the whole array.
+   *
+   * @returns Index between 1 and n - 1
+   */
+  std::size_t getUpper(const double t, std::size_t hint) const {
+    if (m_step != 0) {
+      return getUpper(t);
+    }
+
+    const std::size_t maxSteps = 4;
+    const auto key = roundTime(t);
+    const std::size_t last = m_keys.size() - 1;
+
+    for (std::size_t step = 0; step <= maxSteps; step++) {
+      if (hint > 1 && key < m_keys[hint - 1]) {
+        hint--;
+      } else if (hint < last && key >= m_keys[hint]) {
+        hint++;
+      } else {
+        return hint;
+      }
+    }
+
+    // too far away from the hint
+    return getUpper(t);
+  }
+
+  /**
+   * Checks if a time is in the subinterval ending at a certain index
+   */
+  bool inSub(const double t, const std::size_t upper) const {
+    const auto key = roundTime(t);
+    return (upper == 1 || m_keys[upper - 1] <= key) &&
+           (upper == m_keys.size() - 1 || key < m_keys[upper]);
+  }
+
+  /**
+   * Gets hermite subinterval that ends at a certain index
+   */
+  HermiteSub<D> getSub(const std::size_t upper) const {
+    const std::size_t lower = upper - 1;
+    return HermiteSub<D>{m_pos[lower],   m_pos[upper],   m_vel[lower],
+                         m_vel[upper],   m_times[lower], m_times[upper]};
+  }
+
+  /**
+   * Evaluates a derivative at many times, handing each run of times in the
+   * same subinterval to HermiteSub at once
+   */
+  void evalRuns(const int deriv, const double ts[], const std::size_t n,
+                Vector<D> out[]) const {
+    if (m_keys.size() < 2) {
+      std::fill(out, out + n, Vector<D>{});
+      return;
+    }
+
+    if (n == 0) {
+      return;
+    }
+
+    std::size_t upper = getUpper(ts[0]);
+    std::size_t i = 0;
+    while (i < n) {
+      upper = getUpper(ts[i], upper);
+
+      std::size_t j = i + 1;
+      while (j < n && inSub(ts[j], upper)) {
+        j++;
+      }
+
+      const auto func = getSub(upper);
+      if (deriv == 0) {
+        func.getPosBatch(ts + i, j - i, out + i);
+      } else if (deriv == 1) {
+        func.getVelBatch(ts + i, j - i, out + i);
+      } else {
+        func.getAccBatch(ts + i, j - i, out + i);
+      }
+
+      i = j;
+    }
+  }
+};
+} // namespace hermite
@@ -7,14 +7,25 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <map>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "hermite/base_spline.hpp"
+#include "hermite/bounding_box.hpp"
+#include "hermite/compiled.hpp"
 #include "hermite/hermite/hermite_sub.hpp"
+#include "hermite/poly/poly.hpp"
 #include "hermite/pose.hpp"
+#include "hermite/segment_cache.hpp"
+#include "hermite/separation.hpp"
+#include "hermite/state.hpp"
 #include "hermite/thirdparty/simplevectors.hpp"
 
 namespace hermite {
@@ -45,8 +56,27 @@ using svector::magn;
  * removing points is quick. However, it only provides C1 continuity, which
  * means that there may be high jerk at knot points (as acceleration is
  * discontinuous).
+ *
+ * The positions and velocities of the waypoints are stored as T, which is
+ * double by default. Hermite<D, float> stores each waypoint in about half the
+ * memory, which suits embedded targets. The times stay double, and every curve
+ * is evaluated in double from the offset of the time into its subinterval, so
+ * large absolute timestamps do not lose precision. The cost is that the stored
+ * vectors are rounded to about 7 significant digits, so results carry a
+ * relative error of about 1e-7 of the largest position or velocity nearby.
+ *
+ * Arc length, extrema, bounding boxes, closest points, and separations are
+ * answered from measurements of the subintervals that are taken by the first
+ * such query after the spline is modified. Like the other const methods, these
+ * queries can be called from several threads at once, but not while the spline
+ * is being modified.
  */
-template <std::size_t D> class Hermite : public BaseSpline<D> {
+template <std::size_t D, typename T = double>
+class Hermite : public BaseSpline<D> {
+private:
+  typedef
+      typename std::map<std::int64_t, Pose<D, T>>::const_iterator WaypointIt;
+
 public:
   /**
    * @brief Default constructor
@@ -55,7 +85,7 @@ public:
    * given time by 1 digit before truncating the rest of the number whenever it
    * is stored as a waypoint.
    */
-  Hermite() : m_multiplier{10LL} {}
+  Hermite() : m_multiplier{10LL}, m_revision{0}, m_cacheValid{false} {}
 
   /**
    * @brief Constructor
@@ -63,20 +93,28 @@ public:
    * @param multiplier Multiplies the time given in the pose by the multiplier,
    * then truncates the rest of the digits when storing the waypoint.
    */
-  Hermite(const double multiplier) : m_multiplier{multiplier} {}
+  Hermite(const double multiplier)
+      : m_multiplier{multiplier}, m_revision{0}, m_cacheValid{false} {}
 
   /**
    * @brief Copy constructor
    */
-  Hermite(const Hermite<D> &other)
-      : m_multiplier{other.m_multiplier}, m_waypoints{other.m_waypoints} {}
+  Hermite(const Hermite<D, T> &other)
+      : m_multiplier{other.m_multiplier}, m_waypoints{other.m_waypoints},
+        m_revision{0}, m_cacheValid{false} {
+    std::lock_guard<std::mutex> lock{other.m_cacheMutex};
+    m_cache = other.m_cache;
+    m_cacheValid = other.m_cacheValid;
+    m_patches = other.m_patches;
+    m_cacheCurrent = other.m_cacheCurrent.load();
+  }
 
   /**
    * @brief Assignment operator
    *
    * @note All data stored in current Hermite object will be lost.
    */
-  Hermite<D> &operator=(const Hermite<D> &other) {
+  Hermite<D, T> &operator=(const Hermite<D, T> &other) {
     // check if assigning to self
     if (this == &other) {
       return *this;
@@ -84,6 +122,13 @@ public:
 
     m_multiplier = other.m_multiplier;
     m_waypoints = other.m_waypoints;
+    m_revision++;
+
+    std::lock_guard<std::mutex> lock{other.m_cacheMutex};
+    m_cache = other.m_cache;
+    m_cacheValid = other.m_cacheValid;
+    m_patches = other.m_patches;
+    m_cacheCurrent = other.m_cacheCurrent.load();
 
     return *this;
   }
@@ -93,6 +138,198 @@ public:
    */
   ~Hermite() override = default;
 
+  /**
+   * @brief Evaluation cursor
+   *
+   * Remembers the subinterval that it last evaluated, so evaluating at a time
+   * close to the previous one (e.g. stepping forward in a control loop) takes
+   * amortized constant time instead of searching the whole map. If the time
+   * jumps far away, then the cursor falls back to a logarithmic search.
+   *
+   * The cursor notices when the Hermite object has been modified and searches
+   * again, but the Hermite object must outlive the cursor.
+   */
+  class Cursor {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param spline Hermite object to evaluate
+     */
+    explicit Cursor(const Hermite<D, T> &spline)
+        : m_spline{&spline}, m_revision{0}, m_valid{false} {}
+
+    /**
+     * @brief Gets position at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as Hermite::getPos()
+     */
+    Vector<D> getPos(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_sub.getPos(t);
+    }
+
+    /**
+     * @brief Gets velocity at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as Hermite::getVel()
+     */
+    Vector<D> getVel(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_sub.getVel(t);
+    }
+
+    /**
+     * @brief Gets acceleration at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as Hermite::getAcc()
+     */
+    Vector<D> getAcc(const double t) {
+      if (!seek(t)) {
+        return Vector<D>{};
+      }
+
+      return m_sub.getAcc(t);
+    }
+
+    /**
+     * @brief Gets position, velocity, and acceleration at a certain time
+     *
+     * @param t Time
+     *
+     * @returns Same as Hermite::getState()
+     */
+    State<D> getState(const double t) {
+      if (!seek(t)) {
+        return State<D>{};
+      }
+
+      return m_sub.getState(t);
+    }
+
+    /**
+     * @brief Forgets the current subinterval
+     *
+     * The next evaluation will search the whole map.
+     */
+    void reset() { m_valid = false; }
+
+  private:
+    const Hermite<D, T> *m_spline;
+    WaypointIt m_upper;
+    HermiteSub<D, T> m_sub;
+    std::size_t m_revision;
+    bool m_valid;
+
+    /**
+     * Moves the cursor to the subinterval containing a certain time
+     *
+     * @returns False if there are not enough waypoints to evaluate
+     */
+    bool seek(const double t) {
+      if (m_spline->m_waypoints.size() < 2) {
+        m_valid = false;
+        return false;
+      }
+
+      if (!m_valid || m_revision != m_spline->m_revision) {
+        m_upper = m_spline->getUpper(t);
+        m_sub = m_spline->getSub(m_upper);
+        m_revision = m_spline->m_revision;
+        m_valid = true;
+        return true;
+      }
+
+      const auto itNext = m_spline->getUpper(t, m_upper);
+      if (itNext != m_upper) {
+        m_upper = itNext;
+        m_sub = m_spline->getSub(m_upper);
+      }
+
+      return true;
+    }
+  };
+
+  /**
+   * @brief Cursor for following the spline by arc length
+   *
+   * Remembers where it last was, so moving a short distance from the previous
+   * query, such as stepping along the path in a control loop, takes amortized
+   * constant time: it only integrates from the previous answer instead of
+   * searching the whole spline.
+   *
+   * The cursor notices when the Hermite object has been modified and searches
+   * again, but the Hermite object must outlive the cursor.
+   */
+  class DistanceCursor {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param spline Hermite object to follow
+     */
+    explicit DistanceCursor(const Hermite<D, T> &spline)
+        : m_spline{&spline}, m_cursor{spline} {}
+
+    /**
+     * @brief Gets the time at a certain arc length from the first waypoint
+     *
+     * @param dist Arc length from the first waypoint
+     *
+     * @returns Same as Hermite::getTimeAtDistance()
+     */
+    double getTime(const double dist) {
+      return m_spline->getCache().getTimeAtDistance(dist, m_hint);
+    }
+
+    /**
+     * @brief Gets position at a certain arc length from the first waypoint
+     *
+     * @param dist Arc length from the first waypoint
+     *
+     * @returns Same as Hermite::getPosAtDistance()
+     */
+    Vector<D> getPos(const double dist) {
+      return m_cursor.getPos(getTime(dist));
+    }
+
+    /**
+     * @brief Gets velocity at a certain arc length from the first waypoint
+     *
+     * @param dist Arc length from the first waypoint
+     *
+     * @returns Velocity at getTime()
+     */
+    Vector<D> getVel(const double dist) {
+      return m_cursor.getVel(getTime(dist));
+    }
+
+    /**
+     * @brief Forgets where the cursor was
+     */
+    void reset() {
+      m_hint = typename SegmentCache<D>::Hint{};
+      m_cursor.reset();
+    }
+
+  private:
+    const Hermite<D, T> *m_spline;
+    Cursor m_cursor;
+    typename SegmentCache<D>::Hint m_hint;
+  };
+
   /**
    * @brief Inserts a waypoint
    *
@@ -101,13 +338,16 @@ public:
    * @note If the waypoint's time exists (rounded according to the multiplier),
    * then this method does nothing.
    */
-  void insert(const Pose<D> &waypoint) {
+  void insert(const Pose<D, T> &waypoint) {
     if (exists(waypoint)) {
       return;
     }
 
     auto tRounded = roundTime(waypoint.getTime());
     m_waypoints[tRounded] = waypoint;
+    m_revision++;
+    m_cacheValid = false;
+    m_cacheCurrent = false;
   }
 
   /**
@@ -119,13 +359,15 @@ public:
    * @note If the waypoint does not exist, then this method does not change
    * anything.
    */
-  void replace(const Pose<D> &waypoint) {
+  void replace(const Pose<D, T> &waypoint) {
     if (!exists(waypoint)) {
       return;
     }
 
     auto tRounded = roundTime(waypoint.getTime());
     m_waypoints[tRounded] = waypoint;
+    m_revision++;
+    patchCache(tRounded);
   }
 
   /**
@@ -134,9 +376,12 @@ public:
    *
    * @param waypoint Waypoint to insert or replace
    */
-  void insertOrReplace(const Pose<D> &waypoint) {
-    auto tRounded = roundTime(waypoint.getTime());
-    m_waypoints[tRounded] = waypoint;
+  void insertOrReplace(const Pose<D, T> &waypoint) {
+    if (exists(waypoint)) {
+      replace(waypoint);
+    } else {
+      insert(waypoint);
+    }
   }
 
   /**
@@ -148,7 +393,7 @@ public:
    *
    * @returns If waypoint exists.
    */
-  bool exists(const Pose<D> &waypoint) const {
+  bool exists(const Pose<D, T> &waypoint) const {
     return exists(waypoint.getTime());
   }
 
@@ -174,7 +419,7 @@ public:
    * @note If the waypoint's time is not precise enough, then this may erase a
    * waypoint even though it might not be intended.
    */
-  void erase(const Pose<D> &waypoint) { erase(waypoint.getTime()); }
+  void erase(const Pose<D, T> &waypoint) { erase(waypoint.getTime()); }
 
   /**
    * @brief Removes a waypoint
@@ -195,6 +440,9 @@ public:
     }
 
     m_waypoints.erase(it);
+    m_revision++;
+    m_cacheValid = false;
+    m_cacheCurrent = false;
   }
 
   /**
@@ -202,8 +450,8 @@ public:
    *
    * @returns A list of all waypoints, sorted in order of time.
    */
-  std::vector<Pose<D>> getAllWaypoints() const {
-    std::vector<Pose<D>> res;
+  std::vector<Pose<D, T>> getAllWaypoints() const {
+    std::vector<Pose<D, T>> res;
     for (const auto &it : m_waypoints) {
       res.push_back(it.second);
     }
@@ -211,6 +459,32 @@ public:
     return res;
   }
 
+  /**
+   * @brief Compiles the spline into a table of polynomial coefficients
+   *
+   * Converts every subinterval into the power basis and stores them
+   * contiguously, so evaluating the result takes one search and one Horner
+   * pass. Use this if the spline is built once and evaluated many times.
+   *
+   * @note The knots of the compiled spline are the waypoint times as given,
+   * not the times rounded with the multiplier. If a waypoint's time has more
+   * digits than the multiplier keeps, then times between the exact and the
+   * rounded waypoint time may be evaluated on the neighboring subinterval.
+   *
+   * @tparam C Scalar type of the coefficients. Use float to halve the size of
+   * the table, at the cost of precision described in CompiledSpline.
+   *
+   * @returns Compiled spline
+   */
+  template <typename C = double> CompiledSpline<D, C> compile() const {
+    std::vector<double> times;
+    std::vector<double> coefs;
+    getTable(times, coefs);
+
+    return CompiledSpline<D, C>{std::move(times),
+                                convertCoefficients<C>(std::move(coefs))};
+  }
+
   /**
    * @brief Gets the lower bound of the domain of the piecewise spline function,
    * which is the first time (lowest t-value) listed in the waypoints.
@@ -315,6 +589,96 @@ public:
     return func.getAcc(t);
   }
 
+  /**
+   * @brief Gets position, velocity, and acceleration at a certain time
+   *
+   * Only looks up the subinterval once, so this is faster than calling
+   * getPos(), getVel(), and getAcc() separately.
+   *
+   * @note If time is outside the domain of time from the given points, then it
+   * calculates the value for the function whose domain is nearest to t.
+   * @note If number of waypoints is less than or equal to 1, then returns zero
+   * vectors.
+   *
+   * @param t Time
+   *
+   * @returns Position, velocity, and acceleration
+   */
+  State<D> getState(const double t) const override {
+    if (m_waypoints.size() < 2) {
+      return State<D>{};
+    }
+
+    auto func = getSub(t);
+    return func.getState(t);
+  }
+
+  /**
+   * @brief Gets positions at many times at once
+   *
+   * @note If the times are sorted, then the subinterval is found by walking
+   * from the previous one, so the cost is amortized constant per time instead
+   * of logarithmic. Times that fall in the same subinterval are evaluated
+   * together with the vectorized kernels of HermiteSub::getPosBatch().
+   * @note If number of waypoints is less than or equal to 1, then fills the
+   * output with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getPosBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    evalRuns(0, ts, n, out);
+  }
+
+  /**
+   * @brief Gets velocities at many times at once
+   *
+   * @note If number of waypoints is less than or equal to 1, then fills the
+   * output with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getVelBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    evalRuns(1, ts, n, out);
+  }
+
+  /**
+   * @brief Gets accelerations at many times at once
+   *
+   * @note If number of waypoints is less than or equal to 1, then fills the
+   * output with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getAccBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    evalRuns(2, ts, n, out);
+  }
+
+  /**
+   * @brief Gets positions, velocities, and accelerations at many times at once
+   *
+   * @note If number of waypoints is less than or equal to 1, then fills the
+   * output with zero vectors.
+   *
+   * @param ts Array of times, preferably sorted in ascending order
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n states
+   */
+  void getStateBatch(const double ts[], const std::size_t n,
+                     State<D> out[]) const override {
+    evalBatch(ts, n, out, [](const HermiteSub<D, T> &func, const double t) {
+      return func.getState(t);
+    });
+  }
+
   /**
    * @brief Gets arc length
    *
@@ -347,9 +711,320 @@ public:
     return res;
   }
 
+  using BaseSpline<D>::getMaxDistance;
+  using BaseSpline<D>::getMaxSpeed;
+  using BaseSpline<D>::getMaxAcceleration;
+
+  /**
+   * @brief Gets maximum distance from origin exactly
+   *
+   * On each subinterval, the squared distance is a polynomial of degree 6, so
+   * its maximum is at an end or at a root of its derivative. Unlike
+   * getMaxDistance(timeStep), this cannot miss a peak between samples.
+   *
+   * The maximum of each subinterval is cached along with its arc length, so
+   * this takes constant time until the spline is modified.
+   *
+   * @note Only the domain of the waypoints is checked, not the extended
+   * subintervals outside of it.
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Maximum distance from the origin
+   *
+   * @see getLength()
+   */
+  double getMaxDistance() const { return getMaxMagn(0); }
+
+  /**
+   * @brief Gets maximum distance from origin exactly between two times
+   *
+   * The cached maxima of the subintervals are kept in a segment tree, so this
+   * takes logarithmic time, plus the time to check the partial subintervals at
+   * the ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the domain of the waypoints, and may be in
+   * either order.
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Maximum distance from the origin
+   */
+  double getMaxDistance(const double t0, const double t1) const {
+    return getCache().getMax(t0, t1, 0);
+  }
+
+  /**
+   * @brief Gets maximum speed exactly
+   *
+   * On each subinterval, the squared speed is a quartic, so its maximum is at
+   * an end or at a root of its cubic derivative.
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Maximum speed
+   *
+   * @see getMaxDistance()
+   */
+  double getMaxSpeed() const { return getMaxMagn(1); }
+
+  /**
+   * @brief Gets maximum speed exactly between two times
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @returns Maximum speed
+   *
+   * @see getMaxDistance(double, double)
+   */
+  double getMaxSpeed(const double t0, const double t1) const {
+    return getCache().getMax(t0, t1, 1);
+  }
+
+  /**
+   * @brief Gets maximum magnitude of acceleration exactly
+   *
+   * On each subinterval, the acceleration is linear, so its magnitude is
+   * largest at one of the ends.
+   *
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Magnitude of maximum acceleration
+   *
+   * @see getMaxDistance()
+   */
+  double getMaxAcceleration() const { return getMaxMagn(2); }
+
+  /**
+   * @brief Gets maximum magnitude of acceleration exactly between two times
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @returns Magnitude of maximum acceleration
+   *
+   * @see getMaxDistance(double, double)
+   */
+  double getMaxAcceleration(const double t0, const double t1) const {
+    return getCache().getMax(t0, t1, 2);
+  }
+
+  /**
+   * @brief Gets the smallest axis-aligned box that contains the spline
+   *
+   * Exact up to rounding: on each subinterval, each coordinate is a cubic,
+   * whose extrema are at the ends or at the roots of its quadratic derivative.
+   * The box of each subinterval is cached along with its arc length, so this
+   * takes constant time until the spline is modified.
+   *
+   * @note Only the domain of the waypoints is bounded, not the extended
+   * subintervals outside of it.
+   * @note If number of waypoints is less than or equal to 1, then returns an
+   * empty box.
+   *
+   * @returns Bounding box
+   *
+   * @see getBoundingBoxes()
+   */
+  BoundingBox<D> getBoundingBox() const {
+    return getCache().getTree().getAll().box;
+  }
+
+  /**
+   * @brief Gets the smallest axis-aligned box that contains the spline between
+   * two times
+   *
+   * Takes logarithmic time, plus the time to bound the partial subintervals at
+   * the ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the domain of the waypoints, and may be in
+   * either order.
+   *
+   * @returns Bounding box
+   */
+  BoundingBox<D> getBoundingBox(const double t0, const double t1) const {
+    return getCache().getBox(t0, t1);
+  }
+
+  /**
+   * @brief Gets the bounding box of every subinterval
+   *
+   * Useful as a broad phase for collision checks: a part of the spline can only
+   * touch an obstacle if the box of its subinterval does.
+   *
+   * @returns Boxes, where box i contains the subinterval between waypoints i
+   * and i + 1
+   */
+  std::vector<BoundingBox<D>> getBoundingBoxes() const {
+    const SegmentCache<D> &cache = getCache();
+
+    std::vector<BoundingBox<D>> res;
+    res.reserve(cache.getSegmentCount());
+    for (std::size_t seg = 0; seg < cache.getSegmentCount(); seg++) {
+      res.push_back(cache.getTree().get(seg).box);
+    }
+    return res;
+  }
+
+  /**
+   * @brief Gets the time at which the spline is closest to a point
+   *
+   * The cached bounding boxes of the subintervals form a bounding volume
+   * hierarchy, so subintervals that cannot hold a closer point are skipped, and
+   * the rest are solved exactly from the roots of the derivative of the
+   * squared distance. Unlike sampling getPos(), this takes about logarithmic
+   * time and cannot miss the closest point.
+   *
+   * @param point Point
+   *
+   * @note Only the domain of the waypoints is searched, not the extended
+   * subintervals outside of it.
+   * @note If several points are equally close, then any of them may be
+   * returned.
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Time of the closest point
+   *
+   * @see getBoundingBox()
+   */
+  double getClosestTime(const Vector<D> &point) const {
+    return getCache().getClosestTime(point);
+  }
+
+  /**
+   * @brief Gets the time at which the spline is closest to a point, starting
+   * from a nearby time
+   *
+   * Faster than getClosestTime(const Vector<D> &) when the answer is near the
+   * hint, for example when a controller tracks a robot along the spline and
+   * passes in its previous answer. The result does not depend on the hint.
+   *
+   * @param point Point
+   * @param hint Time to start from
+   *
+   * @returns Time of the closest point
+   */
+  double getClosestTime(const Vector<D> &point, const double hint) const {
+    return getCache().getClosestTime(point, hint);
+  }
+
+  /**
+   * @brief Gets the closest approach of two trajectories at the same times
+   *
+   * Compares the positions of both splines at every time in their common time
+   * window, which is where the domains of their waypoints overlap. Unlike
+   * sampling, this cannot miss a brief close approach: the waypoints of both
+   * splines are merged, so the difference between them is a cubic on each
+   * interval, and intervals that cannot be the closest or cross the threshold
+   * are skipped using the cached bounding boxes and largest speeds. The rest
+   * are solved exactly.
+   *
+   * @param other Other trajectory
+   * @param threshold Distance whose crossings are found, such as the sum of
+   * the radii of two robots. Pass a negative number if they are not needed.
+   *
+   * @note The cache of the other spline is also brought up to date, so do not
+   * call this from several threads at once after modifying either spline.
+   * @note If either spline has less than 2 waypoints, or the time windows do
+   * not overlap, then the distance is infinity.
+   *
+   * @returns Smallest distance, its time, and the times at which the distance
+   * crosses the threshold
+   */
+  Separation getSeparation(const Hermite<D, T> &other,
+                           const double threshold) const {
+    return getCache().getSeparation(other.getCache(), threshold);
+  }
+
+  /**
+   * @brief Gets arc length exactly
+   *
+   * Each subinterval is measured once with adaptive Gauss-Legendre quadrature
+   * and cached, along with a running total, so this takes constant time until
+   * the spline is modified. Replacing a waypoint only measures the two
+   * subintervals next to it again, and inserting or removing one only measures
+   * the subintervals that changed.
+   *
+   * @note The lengths are measured by the first query after a modification,
+   * which is guarded, so several threads can query at once.
+   * @note If zero or one waypoints, returns 0.
+   *
+   * @returns Arc length over the domain of the waypoints
+   */
+  double getLength() const { return getCache().getLength(); }
+
+  /**
+   * @brief Gets arc length between two times
+   *
+   * Takes logarithmic time, plus the time to measure the partial subintervals
+   * at the ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the domain of the waypoints.
+   *
+   * @returns Arc length, which is negative if t1 < t0
+   *
+   * @see getLength()
+   */
+  double getLength(const double t0, const double t1) const {
+    return getCache().getLength(t0, t1);
+  }
+
+  /**
+   * @brief Gets the time at which the arc length from the first waypoint
+   * reaches a certain distance
+   *
+   * Finds the subinterval in logarithmic time from the cached lengths, and then
+   * solves for the time within it with Newton's method on the speed. To follow
+   * the path at a steady pace, use a DistanceCursor instead.
+   *
+   * @param dist Arc length from the first waypoint, which is clamped to the
+   * range from 0 to getLength()
+   *
+   * @note If the spline stops, then the first time that it reaches the
+   * distance is not always the one returned.
+   * @note If number of waypoints is less than or equal to 1, then returns 0.
+   *
+   * @returns Time
+   *
+   * @see getLength()
+   */
+  double getTimeAtDistance(const double dist) const {
+    return getCache().getTimeAtDistance(dist);
+  }
+
+  /**
+   * @brief Gets position at a certain arc length from the first waypoint
+   *
+   * @param dist Arc length from the first waypoint
+   *
+   * @returns Position at getTimeAtDistance()
+   */
+  Vector<D> getPosAtDistance(const double dist) const {
+    return getPos(getTimeAtDistance(dist));
+  }
+
 private:
   double m_multiplier;
-  std::map<std::int64_t, Pose<D>> m_waypoints;
+  std::map<std::int64_t, Pose<D, T>> m_waypoints;
+  std::size_t m_revision;
+
+  // measurements of the subintervals, brought up to date on demand
+  mutable SegmentCache<D> m_cache;
+  mutable bool m_cacheValid;
+  // rounded times of waypoints replaced since the cache was last updated
+  mutable std::vector<std::int64_t> m_patches;
+  // set when the cache is valid with no patches left, after which it is only
+  // read until the spline is modified
+  mutable std::atomic<bool> m_cacheCurrent{false};
+  mutable std::mutex m_cacheMutex; // held while updating the cache
 
   /**
    * @brief Rounds time to int
@@ -364,40 +1039,297 @@ private:
   }
 
   /**
-   * Gets hermite subinterval given a certain time
+   * Gets the waypoint at the upper end of the subinterval containing a certain
+   * time
    *
    * @note Assumes that number of waypoints is greater than or equal to 2. If
    * not, results in undefined behavior.
    *
-   * @returns Hermite subinterval
+   * @returns Iterator to the upper waypoint of the subinterval
    */
-  HermiteSub<D> getSub(const double t) const {
+  WaypointIt getUpper(const double t) const {
     const auto tRound = roundTime(t);
-    auto itLower = m_waypoints.upper_bound(tRound);
+    auto itUpper = m_waypoints.upper_bound(tRound);
 
-    if (itLower == m_waypoints.begin()) {
-      itLower++;
+    if (itUpper == m_waypoints.begin()) {
+      itUpper++;
     }
 
-    if (itLower == m_waypoints.end()) {
-      itLower--;
+    if (itUpper == m_waypoints.end()) {
+      itUpper--;
     }
 
-    auto itUpper = itLower;
-    itLower--;
+    return itUpper;
+  }
+
+  /**
+   * Gets the waypoint at the upper end of the subinterval containing a certain
+   * time, given the upper waypoint of a previous subinterval
+   *
+   * Walks from the hint to the subinterval containing the time, so if the time
+   * is within a few subintervals of the hint, then this takes constant time.
+   * Otherwise, it searches the whole map.
+   *
+   * @note Assumes that number of waypoints is greater than or equal to 2, and
+   * that the hint was obtained from getUpper(). If not, results in undefined
+   * behavior.
+   *
+   * @returns Iterator to the upper waypoint of the subinterval
+   */
+  WaypointIt getUpper(const double t, WaypointIt hint) const {
+    const std::size_t maxSteps = 4;
+    const auto tRound = roundTime(t);
+    const auto itFirst = std::next(m_waypoints.begin());
+    const auto itLast = std::prev(m_waypoints.end());
+
+    for (std::size_t step = 0; step <= maxSteps; step++) {
+      if (hint != itFirst && tRound < std::prev(hint)->first) {
+        hint--;
+      } else if (hint != itLast && tRound >= hint->first) {
+        hint++;
+      } else {
+        return hint;
+      }
+    }
 
-    const auto objUpper = itUpper->second;
-    const auto objLower = itLower->second;
+    // too far away from the hint
+    return getUpper(t);
+  }
+
+  /**
+   * Gets hermite subinterval that ends at a certain waypoint
+   *
+   * @note Assumes that itUpper is not the first waypoint. If it is, results in
+   * undefined behavior.
+   *
+   * @returns Hermite subinterval
+   */
+  HermiteSub<D, T> getSub(WaypointIt itUpper) const {
+    auto itLower = std::prev(itUpper);
+
+    const auto &objUpper = itUpper->second;
+    const auto &objLower = itLower->second;
 
-    const auto p0 = objLower.getPos();
-    const auto pf = objUpper.getPos();
-    const auto v0 = objLower.getVel();
-    const auto vf = objUpper.getVel();
+    const auto &p0 = objLower.getPosData();
+    const auto &pf = objUpper.getPosData();
+    const auto &v0 = objLower.getVelData();
+    const auto &vf = objUpper.getVelData();
     const auto lowerT = objLower.getTime();
     const auto upperT = objUpper.getTime();
 
-    HermiteSub<D> res{p0, pf, v0, vf, lowerT, upperT};
+    HermiteSub<D, T> res{p0, pf, v0, vf, lowerT, upperT};
     return res;
   }
+
+  /**
+   * Gets hermite subinterval given a certain time
+   *
+   * @note Assumes that number of waypoints is greater than or equal to 2. If
+   * not, results in undefined behavior.
+   *
+   * @returns Hermite subinterval
+   */
+  HermiteSub<D, T> getSub(const double t) const { return getSub(getUpper(t)); }
+
+  /**
+   * Gets the times of the waypoints and the coefficients of every subinterval
+   * in the power basis, laid out as in CompiledSpline::CompiledSpline()
+   */
+  void getTable(std::vector<double> &times, std::vector<double> &coefs) const {
+    times.clear();
+    times.reserve(m_waypoints.size());
+    for (const auto &it : m_waypoints) {
+      times.push_back(it.second.getTime());
+    }
+
+    coefs.clear();
+    if (m_waypoints.size() >= 2) {
+      coefs.resize(4 * D * (m_waypoints.size() - 1));
+
+      std::size_t seg = 0;
+      for (auto it = std::next(m_waypoints.begin()); it != m_waypoints.end();
+           it++) {
+        getSub(it).getPowerBasis(&coefs[4 * D * seg]);
+        seg++;
+      }
+    }
+  }
+
+  /**
+   * Records that the waypoint at a rounded time was replaced, so only the
+   * subintervals next to it are measured again
+   */
+  void patchCache(const std::int64_t tRounded) {
+    m_cacheCurrent = false;
+    if (!m_cacheValid) {
+      return;
+    }
+
+    // past this many, measuring the changed subintervals while rebuilding is
+    // just as fast
+    if (m_patches.size() >= m_waypoints.size() / 4) {
+      m_cacheValid = false;
+      return;
+    }
+
+    m_patches.push_back(tRounded);
+  }
+
+  /**
+   * Brings the measurements of the subintervals up to date, applying the
+   * patches. Several threads can call this at once, and only the first one
+   * measures.
+   *
+   * @returns The cache
+   */
+  const SegmentCache<D> &getCache() const {
+    if (m_cacheCurrent.load(std::memory_order_acquire)) {
+      return m_cache;
+    }
+
+    std::lock_guard<std::mutex> lock{m_cacheMutex};
+    if (m_cacheCurrent.load(std::memory_order_relaxed)) {
+      return m_cache;
+    }
+
+    if (!m_cacheValid) {
+      std::vector<double> times;
+      std::vector<double> coefs;
+      getTable(times, coefs);
+      m_cache.assign(std::move(times), std::move(coefs));
+      m_cacheValid = true;
+      m_patches.clear();
+      m_cacheCurrent.store(true, std::memory_order_release);
+      return m_cache;
+    }
+
+    const std::vector<double> &times = m_cache.getTimes();
+    double coefs[4 * D];
+    for (const auto tRounded : m_patches) {
+      const auto itKnot = std::lower_bound(
+          times.begin(), times.end(), tRounded,
+          [this](const double t, const std::int64_t key) {
+            return roundTime(t) < key;
+          });
+      const auto knot = static_cast<std::size_t>(itKnot - times.begin());
+      const auto it = m_waypoints.find(tRounded);
+
+      m_cache.setTime(knot, it->second.getTime());
+      if (it != m_waypoints.begin()) {
+        getSub(it).getPowerBasis(coefs);
+        m_cache.setSegment(knot - 1, coefs);
+      }
+      if (std::next(it) != m_waypoints.end()) {
+        getSub(std::next(it)).getPowerBasis(coefs);
+        m_cache.setSegment(knot, coefs);
+      }
+    }
+    m_patches.clear();
+    m_cacheCurrent.store(true, std::memory_order_release);
+
+    return m_cache;
+  }
+
+  /**
+   * Gets the largest magnitude of a derivative over all subintervals
+   *
+   * @param deriv 0 for position, 1 for velocity, 2 for acceleration
+   */
+  double getMaxMagn(const int deriv) const {
+    return getCache().getTree().getAll().maxMagn[deriv];
+  }
+
+  /**
+   * Checks if a time is in the subinterval ending at a certain waypoint, using
+   * the same rules as getUpper()
+   *
+   * @returns True if getUpper(t) would return itUpper
+   */
+  bool inSub(const double t, WaypointIt itUpper) const {
+    const auto tRound = roundTime(t);
+    const bool aboveLower = itUpper == std::next(m_waypoints.begin()) ||
+                            std::prev(itUpper)->first <= tRound;
+    const bool belowUpper =
+        itUpper == std::prev(m_waypoints.end()) || tRound < itUpper->first;
+    return aboveLower && belowUpper;
+  }
+
+  /**
+   * Evaluates a derivative at many times, handing each run of times in the
+   * same subinterval to HermiteSub at once
+   *
+   * @param deriv 0 for position, 1 for velocity, 2 for acceleration
+   * @param ts Array of times
+   * @param n Number of times
+   * @param out Output array
+   */
+  void evalRuns(const int deriv, const double ts[], const std::size_t n,
+                Vector<D> out[]) const {
+    if (m_waypoints.size() < 2) {
+      std::fill(out, out + n, Vector<D>{});
+      return;
+    }
+
+    if (n == 0) {
+      return;
+    }
+
+    auto itUpper = getUpper(ts[0]);
+    std::size_t i = 0;
+    while (i < n) {
+      itUpper = getUpper(ts[i], itUpper);
+
+      std::size_t j = i + 1;
+      while (j < n && inSub(ts[j], itUpper)) {
+        j++;
+      }
+
+      const auto func = getSub(itUpper);
+      if (deriv == 0) {
+        func.getPosBatch(ts + i, j - i, out + i);
+      } else if (deriv == 1) {
+        func.getVelBatch(ts + i, j - i, out + i);
+      } else {
+        func.getAccBatch(ts + i, j - i, out + i);
+      }
+
+      i = j;
+    }
+  }
+
+  /**
+   * Evaluates a function of the subinterval at many times, only rebuilding
+   * the subinterval when the time moves into another one.
+   *
+   * @param ts Array of times
+   * @param n Number of times
+   * @param out Output array
+   * @param eval Function taking a HermiteSub and a time, returning the
+   * output type
+   */
+  template <typename O, typename F>
+  void evalBatch(const double ts[], const std::size_t n, O out[],
+                 F eval) const {
+    if (m_waypoints.size() < 2) {
+      std::fill(out, out + n, O{});
+      return;
+    }
+
+    if (n == 0) {
+      return;
+    }
+
+    auto itUpper = getUpper(ts[0]);
+    auto func = getSub(itUpper);
+    for (std::size_t i = 0; i < n; i++) {
+      const auto itNext = getUpper(ts[i], itUpper);
+      if (itNext != itUpper) {
+        itUpper = itNext;
+        func = getSub(itUpper);
+      }
+
+      out[i] = eval(func, ts[i]);
+    }
+  }
 };
 } // namespace hermite
@@ -12,6 +12,9 @@
 #include "hermite/base_interpol.hpp"
 #include "hermite/hermite/constants.hpp"
 #include "hermite/hermite/hermite_unit.hpp"
+#include "hermite/pod_vector.hpp"
+#include "hermite/simd/simd.hpp"
+#include "hermite/state.hpp"
 
 namespace hermite {
 /**
@@ -19,8 +22,14 @@ namespace hermite {
  *
  * Allows for two points on an arbitrary interval to be interpolated, not just
  * at 0 and 1. It does this through an affline transformation.
+ *
+ * The end points and velocities are stored as T, which is double by default.
+ * The bounds are always stored as doubles, and the curve is evaluated in
+ * double from the offset of the time into the subinterval, so a float curve
+ * keeps its accuracy at large absolute times.
  */
-template <std::size_t D> class HermiteSub : public BaseInterpol<D> {
+template <std::size_t D, typename T = double>
+class HermiteSub : public BaseInterpol<D> {
 public:
   /**
    * @brief Default constructor
@@ -47,27 +56,33 @@ public:
       : m_lower{lower}, m_upper{upper}, m_unit{p0, pf, v0 * (upper - lower),
                                                vf * (upper - lower)} {};
 
+  /**
+   * @brief Constructor
+   *
+   * @param p0 Initial position vector
+   * @param pf Final position vector
+   * @param v0 Initial velocity vector
+   * @param vf Final velocity vector
+   * @param lower Lower bound
+   * @param upper Upper bound
+   *
+   * @note If lower >= upper, undefined behavior occurs.
+   */
+  HermiteSub(const PodVector<D, T> &p0, const PodVector<D, T> &pf,
+             const PodVector<D, T> &v0, const PodVector<D, T> &vf,
+             const double lower, const double upper)
+      : m_lower{lower}, m_upper{upper}, m_unit{p0, pf, v0 * (upper - lower),
+                                               vf * (upper - lower)} {};
+
   /**
    * @brief Copy constructor
    */
-  HermiteSub(const HermiteSub<D> &other)
-      : m_lower{other.m_lower}, m_upper{other.m_upper}, m_unit{other.m_unit} {}
+  HermiteSub(const HermiteSub<D, T> &other) = default;
 
   /**
    * @brief Assignment operator
    */
-  HermiteSub<D> &operator=(const HermiteSub<D> &other) {
-    // check if assigning to self
-    if (this == &other) {
-      return *this;
-    }
-
-    m_unit = other.m_unit;
-    m_lower = other.m_lower;
-    m_upper = other.m_upper;
-
-    return *this;
-  }
+  HermiteSub<D, T> &operator=(const HermiteSub<D, T> &other) = default;
 
   /**
    * @brief Destructor
@@ -130,9 +145,107 @@ public:
     return res;
   }
 
+  /**
+   * @brief Gets position, velocity, and acceleration at a certain time
+   *
+   * @note If t is outside of the given interval, then it still calculates
+   * the vectors.
+   *
+   * @param t Time
+   *
+   * @returns Position, velocity, and acceleration
+   */
+  State<D> getState(const double t) const override {
+    const double invH = 1 / (m_upper - m_lower);
+    const double tNew = (t - m_lower) * invH;
+
+    State<D> res = m_unit.getState(tNew);
+    res.vel *= invH;
+    res.acc *= invH * invH;
+    return res;
+  }
+
+  /**
+   * @brief Gets positions at many times at once
+   *
+   * Converts the curve into the power basis once and evaluates it with the
+   * vectorized kernels in simd.hpp.
+   *
+   * @note If a time is outside of the given interval, then it still calculates
+   * the vector.
+   *
+   * @param ts Array of times
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   */
+  void getPosBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const {
+    evalBatch(0, ts, n, out);
+  }
+
+  /**
+   * @brief Gets velocities at many times at once
+   *
+   * @param ts Array of times
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   *
+   * @see getPosBatch()
+   */
+  void getVelBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const {
+    evalBatch(1, ts, n, out);
+  }
+
+  /**
+   * @brief Gets accelerations at many times at once
+   *
+   * @param ts Array of times
+   * @param n Number of times in ts
+   * @param out Output array, must have room for n vectors
+   *
+   * @see getPosBatch()
+   */
+  void getAccBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const {
+    evalBatch(2, ts, n, out);
+  }
+
+  /**
+   * @brief Gets the coefficients of the curve in the power basis
+   *
+   * Writes a, b, c, and d such that the position is a + bu + cu^2 + du^3,
+   * where u = (t - lower) / (upper - lower) goes from 0 to 1 over the
+   * subinterval.
+   *
+   * @param coefs Output array of 4 * D numbers. The coefficient of u^j in
+   * dimension dim is written to coefs[j * D + dim].
+   */
+  void getPowerBasis(double coefs[]) const { m_unit.getPowerBasis(coefs); }
+
 private:
   double m_lower;
   double m_upper;
-  HermiteUnit<D> m_unit;
+  HermiteUnit<D, T> m_unit;
+
+  /**
+   * Evaluates a derivative of the curve at many times
+   */
+  void evalBatch(const int deriv, const double ts[], const std::size_t n,
+                 Vector<D> out[]) const {
+    if (n < simd::MIN_RUN) {
+      for (std::size_t i = 0; i < n; i++) {
+        out[i] = deriv == 0 ? getPos(ts[i])
+                 : deriv == 1 ? getVel(ts[i])
+                              : getAcc(ts[i]);
+      }
+      return;
+    }
+
+    double coefs[4 * D];
+    getPowerBasis(coefs);
+    simd::evalSegment<D>(coefs, m_lower, 1 / (m_upper - m_lower), deriv, ts, n,
+                         out);
+  }
 };
 } // namespace hermite
@@ -10,6 +10,8 @@
 
 #include "hermite/base_interpol.hpp"
 #include "hermite/hermite/constants.hpp"
+#include "hermite/pod_vector.hpp"
+#include "hermite/state.hpp"
 #include "hermite/thirdparty/simplevectors.hpp"
 
 namespace hermite {
@@ -25,8 +27,12 @@ using svector::Vector;
  * The template represents the number of dimensions to calculate in. For
  * example, for 2 dimensions, the position and velocity functions will output a
  * 2D vector.
+ *
+ * The end points and velocities are stored as T, which is double by default,
+ * and the curve is always evaluated in double.
  */
-template <std::size_t D> class HermiteUnit : public BaseInterpol<D> {
+template <std::size_t D, typename T = double>
+class HermiteUnit : public BaseInterpol<D> {
 public:
   /**
    * @brief Default constructor
@@ -48,29 +54,27 @@ public:
               const Vector<D> v1)
       : m_p0{p0}, m_p1{p1}, m_v0{v0}, m_v1{v1} {}
 
+  /**
+   * @brief Constructor
+   *
+   * @param p0 Initial position vector
+   * @param p1 Final position vector
+   * @param v0 Initial velocity vector
+   * @param v1 Final velocity vector
+   */
+  HermiteUnit(const PodVector<D, T> &p0, const PodVector<D, T> &p1,
+              const PodVector<D, T> &v0, const PodVector<D, T> &v1)
+      : m_p0{p0}, m_p1{p1}, m_v0{v0}, m_v1{v1} {}
+
   /**
    * @brief Copy constructor
    */
-  HermiteUnit(const HermiteUnit<D> &other)
-      : m_p0{other.m_p0}, m_p1{other.m_p1}, m_v0{other.m_v0}, m_v1{other.m_v1} {
-  }
+  HermiteUnit(const HermiteUnit<D, T> &other) = default;
 
   /**
    * @brief Assignment operator
    */
-  HermiteUnit<D> &operator=(const HermiteUnit<D> &other) {
-    // check if assigning to self
-    if (this == &other) {
-      return *this;
-    }
-
-    m_p0 = other.m_p0;
-    m_p1 = other.m_p1;
-    m_v0 = other.m_v0;
-    m_v1 = other.m_v1;
-
-    return *this;
-  }
+  HermiteUnit<D, T> &operator=(const HermiteUnit<D, T> &other) = default;
 
   /**
    * @brief Destructor
@@ -90,9 +94,7 @@ public:
    * @returns Position
    */
   Vector<D> getPos(const double t) const override {
-    Vector<D> res;
-    res = m_p0 * h00(t) + m_v0 * h10(t) + m_p1 * h01(t) + m_v1 * h11(t);
-    return res;
+    return combine(h00(t), h10(t), h01(t), h11(t));
   }
 
   /**
@@ -106,9 +108,7 @@ public:
    * @returns Velocity
    */
   Vector<D> getVel(const double t) const override {
-    Vector<D> res;
-    res = m_p0 * h00d(t) + m_v0 * h10d(t) + m_p1 * h01d(t) + m_v1 * h11d(t);
-    return res;
+    return combine(h00d(t), h10d(t), h01d(t), h11d(t));
   }
 
   /**
@@ -122,15 +122,99 @@ public:
    * @returns Acceleration
    */
   Vector<D> getAcc(const double t) const override {
-    Vector<D> res;
-    res = m_p0 * h00dd(t) + m_v0 * h10dd(t) + m_p1 * h01dd(t) + m_v1 * h11dd(t);
+    return combine(h00dd(t), h10dd(t), h01dd(t), h11dd(t));
+  }
+
+  /**
+   * @brief Gets position, velocity, and acceleration at a certain time
+   *
+   * Calculates the powers of t and the basis functions once for all three.
+   *
+   * @note If t is outside of [0, 1], then it still calculates the vectors at
+   * that time.
+   *
+   * @param t Time
+   *
+   * @returns Position, velocity, and acceleration
+   */
+  State<D> getState(const double t) const override {
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+
+    const double b00 = 2 * t3 - 3 * t2 + 1;
+    const double b10 = t3 - 2 * t2 + t;
+    const double b01 = -2 * t3 + 3 * t2;
+    const double b11 = t3 - t2;
+
+    const double b00d = 6 * t2 - 6 * t;
+    const double b10d = 3 * t2 - 4 * t + 1;
+    const double b01d = -b00d;
+    const double b11d = 3 * t2 - 2 * t;
+
+    const double b00dd = 12 * t - 6;
+    const double b10dd = 6 * t - 4;
+    const double b01dd = -b00dd;
+    const double b11dd = 6 * t - 2;
+
+    State<D> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      const double p0 = m_p0[dim];
+      const double p1 = m_p1[dim];
+      const double v0 = m_v0[dim];
+      const double v1 = m_v1[dim];
+
+      res.pos[dim] = p0 * b00 + v0 * b10 + p1 * b01 + v1 * b11;
+      res.vel[dim] = p0 * b00d + v0 * b10d + p1 * b01d + v1 * b11d;
+      res.acc[dim] = p0 * b00dd + v0 * b10dd + p1 * b01dd + v1 * b11dd;
+    }
+
     return res;
   }
 
+  /**
+   * @brief Gets the coefficients of the curve in the power basis
+   *
+   * Writes a, b, c, and d such that the position is a + bt + ct^2 + dt^3.
+   *
+   * @param coefs Output array of 4 * D numbers. The coefficient of t^j in
+   * dimension dim is written to coefs[j * D + dim].
+   */
+  void getPowerBasis(double coefs[]) const {
+    for (std::size_t dim = 0; dim < D; dim++) {
+      const double p0 = m_p0[dim];
+      const double p1 = m_p1[dim];
+      const double v0 = m_v0[dim];
+      const double v1 = m_v1[dim];
+
+      coefs[dim] = p0;
+      coefs[D + dim] = v0;
+      coefs[2 * D + dim] = -3 * p0 + 3 * p1 - 2 * v0 - v1;
+      coefs[3 * D + dim] = 2 * p0 - 2 * p1 + v0 + v1;
+    }
+  }
+
 private:
-  Vector<D> m_p0;
-  Vector<D> m_p1;
-  Vector<D> m_v0;
-  Vector<D> m_v1;
+  PodVector<D, T> m_p0;
+  PodVector<D, T> m_p1;
+  PodVector<D, T> m_v0;
+  PodVector<D, T> m_v1;
+
+  /**
+   * Adds up the four stored vectors, each multiplied by the value of its basis
+   * function
+   */
+  Vector<D> combine(const double b00, const double b10, const double b01,
+                    const double b11) const {
+    Vector<D> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      const double p0 = m_p0[dim];
+      const double p1 = m_p1[dim];
+      const double v0 = m_v0[dim];
+      const double v1 = m_v1[dim];
+      res[dim] = p0 * b00 + v0 * b10 + p1 * b01 + v1 * b11;
+    }
+
+    return res;
+  }
 };
 } // namespace hermite
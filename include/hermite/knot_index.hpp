@@ -0,0 +1,191 @@
+/**
+ * @file
+ *
+ * Cache-friendly search index over sorted knots
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace hermite {
+/**
+ * @brief Search index over sorted knots
+ *
+ * Stores a copy of the knots in Eytzinger (breadth-first) order, where the
+ * children of the element at index k are at 2k and 2k + 1. A search walks down
+ * the implicit tree without branching on the comparison, and the first few
+ * levels are shared by every search, so they stay in the cache. Since the
+ * descendants of k four levels down are stored next to each other at 16k, they
+ * can be prefetched before they are needed, which hides most of the memory
+ * latency of a search over millions of knots.
+ *
+ * A binary search over the sorted array, on the other hand, takes a cache
+ * miss on nearly every probe once the array does not fit in the cache, and
+ * every probe depends on the previous one.
+ *
+ * The index takes the same memory as the knots, and must be rebuilt if the
+ * knots change.
+ *
+ * @tparam T Type of the knots, such as double or std::int64_t
+ */
+template <typename T> class KnotIndex {
+public:
+  /**
+   * @brief Default constructor
+   *
+   * Initializes an empty index
+   */
+  KnotIndex() : m_n{0}, m_height{0}, m_leaves{0} {}
+
+  /**
+   * @brief Constructor
+   *
+   * Builds the index in linear time.
+   *
+   * @param knots Knots, sorted with no repeats
+   * @param n Number of knots
+   */
+  KnotIndex(const T knots[], const std::size_t n)
+      : m_n{n}, m_height{0}, m_leaves{0} {
+    m_tree.resize(n + 1);
+    if (n > 0) {
+      m_height = floorLog2(n) + 1;
+      m_leaves = n - (std::size_t{1} << (m_height - 1)) + 1;
+    }
+
+    std::size_t next = 0;
+    build(knots, 1, next);
+  }
+
+  /**
+   * @brief Checks if the index is empty
+   *
+   * @returns True if there are no knots in the index
+   */
+  bool empty() const { return m_n == 0; }
+
+  /**
+   * @brief Gets the number of knots
+   *
+   * @returns Number of knots in the index
+   */
+  std::size_t size() const { return m_n; }
+
+  /**
+   * @brief Counts the knots less than or equal to a value
+   *
+   * Same as std::upper_bound() on the sorted knots, returned as an index.
+   *
+   * @param x Value to search for
+   *
+   * @returns Index of the first knot greater than x, or n if there is none
+   */
+  std::size_t upperBound(const T x) const {
+    const T *tree = m_tree.data();
+    std::size_t k = 1;
+    while (k <= m_n) {
+#if defined(__GNUC__)
+      // the 16 descendants four levels down span at most three cache lines
+      __builtin_prefetch(tree + 16 * k);
+      __builtin_prefetch(tree + 16 * k + 8);
+      __builtin_prefetch(tree + 16 * k + 15);
+#endif
+      k = 2 * k + static_cast<std::size_t>(tree[k] <= x);
+    }
+
+    // undo the right turns after the last left turn, which was at the answer
+    k >>= countTrailingOnes(k) + 1;
+    return k == 0 ? m_n : getRank(k);
+  }
+
+  /**
+   * @brief Finds the segment containing a value
+   *
+   * Uses the same rules as splhunt(), so a value on a knot is in the later
+   * segment and values outside of the knots are in the first or last segment.
+   *
+   * @param x Value to search for
+   *
+   * @returns Index of the lower knot of the segment, between 0 and n - 2
+   *
+   * @note Assumes that there are at least 2 knots.
+   */
+  int findSegment(const T x) const {
+    const std::size_t upper = upperBound(x);
+    const std::size_t last = m_n - 2;
+    const std::size_t klo = upper == 0 ? 0 : upper - 1;
+    return static_cast<int>(klo < last ? klo : last);
+  }
+
+private:
+  std::size_t m_n;
+  int m_height;         // number of levels in the tree
+  std::size_t m_leaves; // number of nodes on the last level
+  std::vector<T> m_tree;
+
+  /**
+   * Fills the subtree rooted at index k with the next knots in sorted order,
+   * using an in-order traversal
+   */
+  void build(const T knots[], const std::size_t k, std::size_t &next) {
+    if (k > m_n) {
+      return;
+    }
+
+    build(knots, 2 * k, next);
+    m_tree[k] = knots[next];
+    next++;
+    build(knots, 2 * k + 1, next);
+  }
+
+  /**
+   * Gets the position of the node at index k in sorted order
+   *
+   * Computed from k instead of stored, since looking it up would take another
+   * cache miss. In a perfect tree, the node at depth d has position
+   * (2k + 1) * 2^(height - 1 - d) - 2^height - 1. The last level is filled from
+   * the left, so the missing leaves, which would be at every other position,
+   * are subtracted.
+   */
+  std::size_t getRank(const std::size_t k) const {
+    const int depth = floorLog2(k);
+    const std::size_t perfect = ((2 * k + 1) << (m_height - 1 - depth)) -
+                                (std::size_t{1} << m_height) - 1;
+    const std::size_t leavesBefore = (perfect + 1) / 2;
+    return leavesBefore > m_leaves ? perfect - (leavesBefore - m_leaves)
+                                   : perfect;
+  }
+
+  /**
+   * Gets the index of the highest set bit of a positive number
+   */
+  static int floorLog2(const std::size_t k) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(static_cast<unsigned long long>(k));
+#else
+    int res = 0;
+    for (std::size_t rest = k; rest > 1; rest >>= 1) {
+      res++;
+    }
+    return res;
+#endif
+  }
+
+  /**
+   * Counts the ones at the end of a number
+   */
+  static int countTrailingOnes(const std::size_t k) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(~static_cast<unsigned long long>(k));
+#else
+    int res = 0;
+    for (std::size_t rest = k; rest & 1; rest >>= 1) {
+      res++;
+    }
+    return res;
+#endif
+  }
+};
+} // namespace hermite
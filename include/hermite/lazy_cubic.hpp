@@ -0,0 +1,452 @@
+/**
+ * @file
+ *
+ * A natural cubic spline that is only solved when it is used
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "hermite/base_spline.hpp"
+#include "hermite/compiled.hpp"
+#include "hermite/cubic.hpp"
+#include "hermite/pose.hpp"
+#include "hermite/state.hpp"
+#include "hermite/thirdparty/simplevectors.hpp"
+
+namespace hermite {
+using svector::Vector;
+
+/**
+ * @brief A natural cubic spline that is solved once after many edits
+ *
+ * Gives the same spline as Cubic through the same waypoints, but waypoints
+ * can be inserted, replaced, and removed. Edits only change the list of
+ * waypoints and mark the spline as out of date, and the spline is solved again
+ * on the next evaluation or call to commit(). So a burst of edits followed by
+ * a query costs one solve instead of one for each edit.
+ *
+ * The solves reuse the memory of the previous ones, so once the spline has
+ * held as many waypoints, they do not allocate.
+ *
+ * @note Evaluating an out of date spline solves it, which changes this object
+ * even though the evaluation methods are const. Call commit() before sharing
+ * the object between threads that only read it.
+ * @note Times are compared exactly, so a waypoint is only replaced or removed
+ * if its time is the same double.
+ */
+template <std::size_t D> class LazyCubic : public BaseSpline<D> {
+public:
+  /**
+   * @brief Default constructor
+   *
+   * Initializes with zero waypoints
+   */
+  LazyCubic() : m_dirty{false}, m_solves{0}, m_avoided{0} {}
+
+  /**
+   * @brief Constructor
+   *
+   * Does not solve the spline until it is used.
+   *
+   * @param waypoints A list of waypoints, which is sorted
+   *
+   * @note Make sure that there are no two waypoints that share the same time,
+   * or there will be undefined behavior.
+   */
+  LazyCubic(const std::vector<Pose<D>> &waypoints)
+      : m_waypoints{waypoints}, m_dirty{true}, m_solves{0}, m_avoided{0} {
+    std::sort(m_waypoints.begin(), m_waypoints.end(), byTime);
+  }
+
+  /**
+   * @brief Copy constructor
+   */
+  LazyCubic(const LazyCubic<D> &other)
+      : m_waypoints{other.m_waypoints}, m_cubic{other.m_cubic},
+        m_dirty{other.m_dirty}, m_solves{other.m_solves},
+        m_avoided{other.m_avoided} {}
+
+  /**
+   * @brief Assignment operator
+   */
+  LazyCubic<D> &operator=(const LazyCubic<D> &other) {
+    if (this == &other) {
+      return *this;
+    }
+
+    m_waypoints = other.m_waypoints;
+    m_cubic = other.m_cubic;
+    m_dirty = other.m_dirty;
+    m_solves = other.m_solves;
+    m_avoided = other.m_avoided;
+
+    return *this;
+  }
+
+  /**
+   * @brief Destructor
+   */
+  ~LazyCubic() override = default;
+
+  /**
+   * @brief Reserves space for a number of waypoints
+   *
+   * @param n Number of waypoints to reserve space for
+   */
+  void reserve(const std::size_t n) { m_waypoints.reserve(n); }
+
+  /**
+   * @brief Gets the number of waypoints
+   *
+   * @returns Number of waypoints
+   */
+  std::size_t size() const { return m_waypoints.size(); }
+
+  /**
+   * @brief Inserts a waypoint
+   *
+   * @param waypoint Waypoint to insert
+   *
+   * @note If the waypoint's time exists, then this method does nothing.
+   */
+  void insert(const Pose<D> &waypoint) {
+    const auto it = lowerBound(waypoint.getTime());
+    if (it != m_waypoints.end() && it->getTime() == waypoint.getTime()) {
+      return;
+    }
+
+    m_waypoints.insert(it, waypoint);
+    markDirty();
+  }
+
+  /**
+   * @brief Replaces a waypoint
+   *
+   * @param waypoint Waypoint to replace
+   *
+   * @note Gets the time from the waypoint.
+   * @note If the waypoint does not exist, then this method does not change
+   * anything.
+   */
+  void replace(const Pose<D> &waypoint) {
+    const auto it = lowerBound(waypoint.getTime());
+    if (it == m_waypoints.end() || it->getTime() != waypoint.getTime()) {
+      return;
+    }
+
+    *it = waypoint;
+    markDirty();
+  }
+
+  /**
+   * @brief Inserts a waypoint if it doesn't exist, otherwise replaces the
+   * waypoint.
+   *
+   * @param waypoint Waypoint to insert or replace
+   */
+  void insertOrReplace(const Pose<D> &waypoint) {
+    const auto it = lowerBound(waypoint.getTime());
+    if (it != m_waypoints.end() && it->getTime() == waypoint.getTime()) {
+      *it = waypoint;
+    } else {
+      m_waypoints.insert(it, waypoint);
+    }
+
+    markDirty();
+  }
+
+  /**
+   * @brief Removes a waypoint
+   *
+   * @param waypoint Waypoint to remove
+   *
+   * @note Only the waypoint's time is used in this method.
+   */
+  void erase(const Pose<D> &waypoint) { erase(waypoint.getTime()); }
+
+  /**
+   * @brief Removes a waypoint
+   *
+   * @param time Time of waypoint to remove
+   *
+   * @note If there is no waypoint at the time, then this method does nothing.
+   */
+  void erase(const double time) {
+    const auto it = lowerBound(time);
+    if (it == m_waypoints.end() || it->getTime() != time) {
+      return;
+    }
+
+    m_waypoints.erase(it);
+    markDirty();
+  }
+
+  /**
+   * @brief Checks if a waypoint at a certain time exists
+   *
+   * @param time Checks if a waypoint exists at this time
+   *
+   * @returns If waypoint exists.
+   */
+  bool exists(const double time) const {
+    const auto it = std::lower_bound(
+        m_waypoints.begin(), m_waypoints.end(), time,
+        [](const Pose<D> &a, const double t) { return a.getTime() < t; });
+    return it != m_waypoints.end() && it->getTime() == time;
+  }
+
+  /**
+   * @brief Solves the spline now if it is out of date
+   *
+   * Evaluating the spline does this automatically, so this is only needed to
+   * choose when the solve happens.
+   */
+  void commit() { solve(); }
+
+  /**
+   * @brief Checks whether the spline has been edited since it was last solved
+   *
+   * @returns True if the next evaluation or commit() will solve the spline
+   */
+  bool isDirty() const { return m_dirty; }
+
+  /**
+   * @brief Gets the number of times the spline has been solved
+   *
+   * @returns Number of solves
+   */
+  std::size_t getSolveCount() const { return m_solves; }
+
+  /**
+   * @brief Gets the number of solves saved by batching edits
+   *
+   * Every edit made while the spline was already out of date would have
+   * needed its own solve if the spline was rebuilt after each edit.
+   *
+   * @returns Number of edits that did not cause a solve of their own
+   */
+  std::size_t getAvoidedSolveCount() const { return m_avoided; }
+
+  /**
+   * @brief Sets the solve counters back to zero
+   */
+  void resetCounters() {
+    m_solves = 0;
+    m_avoided = 0;
+  }
+
+  /**
+   * @brief Gets a list of all waypoints
+   *
+   * @returns A list of all waypoints, sorted in order of time.
+   */
+  std::vector<Pose<D>> getAllWaypoints() const { return m_waypoints; }
+
+  /**
+   * @brief Compiles the spline into a table of polynomial coefficients
+   *
+   * Solves the spline first if it is out of date.
+   *
+   * @tparam T Scalar type of the coefficients
+   *
+   * @returns Compiled spline
+   *
+   * @see Cubic::compile()
+   */
+  template <typename T = double> CompiledSpline<D, T> compile() const {
+    solve();
+    return m_cubic.template compile<T>();
+  }
+
+  /**
+   * @brief Gets the lower bound of the domain of the piecewise spline function,
+   * which is the first time.
+   *
+   * Does not solve the spline.
+   *
+   * @note If there are no waypoints, then returns 0
+   *
+   * @returns The first time
+   */
+  double getLowestTime() const override {
+    if (m_waypoints.size() == 0) {
+      return 0;
+    }
+
+    return m_waypoints[0].getTime();
+  }
+
+  /**
+   * @brief Gets the upper bound of the domain of the piecewise spline function,
+   * which is the last time.
+   *
+   * Does not solve the spline.
+   *
+   * @note If there are no waypoints, then returns 0
+   *
+   * @returns The last time
+   */
+  double getHighestTime() const override {
+    if (m_waypoints.size() == 0) {
+      return 0;
+    }
+
+    return m_waypoints[m_waypoints.size() - 1].getTime();
+  }
+
+  /**
+   * @brief Gets position at a certain time
+   *
+   * @param t Time
+   *
+   * @returns Same as Cubic::getPos()
+   */
+  Vector<D> getPos(const double t) const override {
+    solve();
+    return m_cubic.getPos(t);
+  }
+
+  /**
+   * @brief Gets velocity at a certain time
+   *
+   * @param t Time
+   *
+   * @returns Same as Cubic::getVel()
+   */
+  Vector<D> getVel(const double t) const override {
+    solve();
+    return m_cubic.getVel(t);
+  }
+
+  /**
+   * @brief Gets acceleration at a certain time
+   *
+   * @param t Time
+   *
+   * @returns Same as Cubic::getAcc()
+   */
+  Vector<D> getAcc(const double t) const override {
+    solve();
+    return m_cubic.getAcc(t);
+  }
+
+  /**
+   * @brief Gets position, velocity, and acceleration at a certain time
+   *
+   * @param t Time
+   *
+   * @returns Same as Cubic::getState()
+   */
+  State<D> getState(const double t) const override {
+    solve();
+    return m_cubic.getState(t);
+  }
+
+  /**
+   * @brief Gets positions at many times at once
+   *
+   * @see Cubic::getPosBatch()
+   */
+  void getPosBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    solve();
+    m_cubic.getPosBatch(ts, n, out);
+  }
+
+  /**
+   * @brief Gets velocities at many times at once
+   *
+   * @see Cubic::getVelBatch()
+   */
+  void getVelBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    solve();
+    m_cubic.getVelBatch(ts, n, out);
+  }
+
+  /**
+   * @brief Gets accelerations at many times at once
+   *
+   * @see Cubic::getAccBatch()
+   */
+  void getAccBatch(const double ts[], const std::size_t n,
+                   Vector<D> out[]) const override {
+    solve();
+    m_cubic.getAccBatch(ts, n, out);
+  }
+
+  /**
+   * @brief Gets positions, velocities, and accelerations at many times at once
+   *
+   * @see Cubic::getStateBatch()
+   */
+  void getStateBatch(const double ts[], const std::size_t n,
+                     State<D> out[]) const override {
+    solve();
+    m_cubic.getStateBatch(ts, n, out);
+  }
+
+  /**
+   * @brief Gets arc length
+   *
+   * @param timeStep The time step to try for the arc length
+   *
+   * @returns Same as Cubic::getLength()
+   */
+  double getLength(const double timeStep) const override {
+    solve();
+    return m_cubic.getLength(timeStep);
+  }
+
+private:
+  std::vector<Pose<D>> m_waypoints;
+  // solved from the waypoints on demand, so these change in const methods
+  mutable Cubic<D> m_cubic;
+  mutable bool m_dirty;
+  mutable std::size_t m_solves;
+  std::size_t m_avoided;
+
+  /**
+   * Compares waypoints by time
+   */
+  static bool byTime(const Pose<D> &a, const Pose<D> &b) {
+    return a.getTime() < b.getTime();
+  }
+
+  /**
+   * Gets the first waypoint at or after a time
+   */
+  typename std::vector<Pose<D>>::iterator lowerBound(const double time) {
+    return std::lower_bound(
+        m_waypoints.begin(), m_waypoints.end(), time,
+        [](const Pose<D> &a, const double t) { return a.getTime() < t; });
+  }
+
+  /**
+   * Records an edit, counting it as avoided if a solve was already pending
+   */
+  void markDirty() {
+    if (m_dirty) {
+      m_avoided++;
+    }
+    m_dirty = true;
+  }
+
+  /**
+   * Solves the spline if it is out of date
+   */
+  void solve() const {
+    if (!m_dirty) {
+      return;
+    }
+
+    m_cubic.rebuild(m_waypoints);
+    m_solves++;
+    m_dirty = false;
+  }
+};
+} // namespace hermite
@@ -0,0 +1,122 @@
+/**
+ * @file
+ *
+ * Plain vector type used to store waypoints and curves
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "hermite/thirdparty/simplevectors.hpp"
+
+namespace hermite {
+using svector::Vector;
+
+/**
+ * @brief A plain fixed-size vector of numbers
+ *
+ * Unlike svector::Vector, this has no virtual methods, so it is trivially
+ * copyable and holds nothing but its components. Arrays of it can be copied
+ * with memcpy, and the components start on a 16-byte boundary so that they can
+ * be loaded with aligned SSE instructions.
+ *
+ * It is used to store waypoints and curves inside the library. Methods that
+ * are part of the public interface still take and return svector::Vector, which
+ * converts to and from this type implicitly.
+ *
+ * The components are stored as T, which is double by default. With float, the
+ * vector takes half the memory, and each component is rounded to about 7
+ * significant digits when it is converted from an svector::Vector.
+ *
+ * @note 16 bytes is the largest alignment that std::vector honors before
+ * C++17, so the alignment is not raised any further for AVX.
+ */
+template <std::size_t D, typename T = double> class alignas(16) PodVector {
+public:
+  /**
+   * @brief Default constructor
+   *
+   * Initializes all components to zero
+   */
+  PodVector() : m_components{} {}
+
+  /**
+   * @brief Converts from an svector::Vector
+   *
+   * @param other Vector to copy the components from
+   */
+  PodVector(const Vector<D> &other) {
+    for (std::size_t dim = 0; dim < D; dim++) {
+      m_components[dim] = static_cast<T>(other[dim]);
+    }
+  }
+
+  /**
+   * @brief Converts to an svector::Vector
+   *
+   * @returns Vector with the same components
+   */
+  operator Vector<D>() const { return toVector(); }
+
+  /**
+   * @brief Converts to an svector::Vector
+   *
+   * @returns Vector with the same components
+   */
+  Vector<D> toVector() const {
+    Vector<D> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res[dim] = m_components[dim];
+    }
+
+    return res;
+  }
+
+  /**
+   * @brief Gets a component
+   *
+   * @param index Index of the component
+   *
+   * @returns Reference to the component
+   */
+  T &operator[](const std::size_t index) { return m_components[index]; }
+
+  /**
+   * @brief Gets a component
+   *
+   * @param index Index of the component
+   *
+   * @returns The component
+   */
+  T operator[](const std::size_t index) const { return m_components[index]; }
+
+  /**
+   * @brief Multiplies every component by a scalar
+   *
+   * The product is taken in double and then rounded to T.
+   *
+   * @param scalar Scalar to multiply by
+   *
+   * @returns The scaled vector
+   */
+  PodVector<D, T> operator*(const double scalar) const {
+    PodVector<D, T> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res.m_components[dim] = static_cast<T>(m_components[dim] * scalar);
+    }
+
+    return res;
+  }
+
+  /**
+   * @brief Gets a pointer to the components
+   *
+   * @returns Pointer to the first of D contiguous components
+   */
+  const T *data() const { return m_components; }
+
+private:
+  T m_components[D];
+};
+} // namespace hermite
@@ -0,0 +1,615 @@
+/**
+ * @file
+ *
+ * Roots and extrema of the polynomials that make up a spline segment
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace hermite {
+namespace poly {
+/**
+ * @brief Highest degree of polynomial handled by these functions
+ *
+ * The squared distance of a cubic segment from a point is degree 6, which is
+ * the highest needed by the splines.
+ */
+const int MAX_DEGREE = 6;
+
+/**
+ * @brief Most iterations used to refine one root
+ *
+ * Each iteration at least halves the bracket, so this is enough for any
+ * bracket of doubles.
+ */
+const int ROOT_ITERATIONS = 100;
+
+/**
+ * @brief Relative tolerance of arc lengths
+ *
+ * A piece of a segment is split in half until its 5 point Gauss-Legendre
+ * estimate agrees with the sum of the estimates of its halves to within this
+ * fraction.
+ */
+const double LENGTH_TOLERANCE = 1e-12;
+
+/**
+ * @brief Most times a piece of a segment is split in half when finding its arc
+ * length
+ */
+const int LENGTH_DEPTH = 16;
+
+/**
+ * @brief Evaluates a polynomial
+ *
+ * @param c Coefficients, lowest power first
+ * @param degree Degree of the polynomial, so there are degree + 1 coefficients
+ * @param x Input
+ *
+ * @returns c[0] + c[1]x + ... + c[degree]x^degree
+ */
+inline double evaluate(const double c[], const int degree, const double x) {
+  double res = c[degree];
+  for (int j = degree - 1; j >= 0; j--) {
+    res = res * x + c[j];
+  }
+
+  return res;
+}
+
+/**
+ * @brief Differentiates a polynomial
+ *
+ * @param c Coefficients, lowest power first
+ * @param degree Degree of the polynomial, at least 1
+ * @param out Output array of degree coefficients, lowest power first
+ */
+inline void differentiate(const double c[], const int degree, double out[]) {
+  for (int j = 1; j <= degree; j++) {
+    out[j - 1] = j * c[j];
+  }
+}
+
+/**
+ * @brief Finds the root of a polynomial in a bracket
+ *
+ * Takes Newton steps, falling back to bisection whenever a step would leave
+ * the bracket, so it always converges.
+ *
+ * @param c Coefficients, lowest power first
+ * @param degree Degree of the polynomial
+ * @param lo Lower end of the bracket
+ * @param hi Upper end of the bracket
+ *
+ * @note The polynomial must change sign between lo and hi. If not, then the
+ * result is one of the ends or somewhere in between.
+ *
+ * @returns Root
+ */
+inline double refineRoot(const double c[], const int degree, double lo,
+                         double hi) {
+  const bool rising = evaluate(c, degree, lo) < 0;
+  double x = 0.5 * (lo + hi);
+
+  for (int iter = 0; iter < ROOT_ITERATIONS; iter++) {
+    // value and derivative in one Horner pass
+    double val = c[degree];
+    double der = 0;
+    for (int j = degree - 1; j >= 0; j--) {
+      der = der * x + val;
+      val = val * x + c[j];
+    }
+
+    if (val == 0) {
+      return x;
+    }
+
+    if ((val < 0) == rising) {
+      lo = x;
+    } else {
+      hi = x;
+    }
+
+    double next = x - val / der;
+    if (!(next > lo && next < hi)) {
+      next = 0.5 * (lo + hi);
+    }
+
+    if (next == x) {
+      return next;
+    }
+    x = next;
+  }
+
+  return x;
+}
+
+/**
+ * @brief Finds the real roots of a polynomial in an interval
+ *
+ * Finds the roots of the derivative first, which split the interval into
+ * pieces where the polynomial is monotonic, and then refines the root of each
+ * piece that changes sign. This is slower than a closed form, but it does not
+ * lose precision when the leading coefficients are small or roots are close
+ * together.
+ *
+ * @param c Coefficients, lowest power first
+ * @param degree Degree of the polynomial, at most MAX_DEGREE
+ * @param lo Lower end of the interval
+ * @param hi Upper end of the interval
+ * @param roots Output array, must have room for degree numbers
+ *
+ * @note Roots where the polynomial touches zero without changing sign are
+ * only found if they are exactly zero, which is enough for finding extrema.
+ * @note A polynomial that is zero everywhere has no roots.
+ *
+ * @returns Number of roots, which are written in ascending order
+ */
+inline int findRoots(const double c[], const int degree, const double lo,
+                     const double hi, double roots[]) {
+  if (degree <= 0 ||
+      std::all_of(c, c + degree + 1, [](const double x) { return x == 0; })) {
+    return 0;
+  }
+
+  if (degree == 1) {
+    if (c[1] == 0) {
+      return 0;
+    }
+
+    const double root = -c[0] / c[1];
+    if (root < lo || root > hi) {
+      return 0;
+    }
+
+    roots[0] = root;
+    return 1;
+  }
+
+  double der[MAX_DEGREE];
+  differentiate(c, degree, der);
+
+  // ends of the monotonic pieces
+  double ends[MAX_DEGREE + 1];
+  ends[0] = lo;
+  const int crit = findRoots(der, degree - 1, lo, hi, ends + 1);
+  ends[crit + 1] = hi;
+
+  int count = 0;
+  double prev = evaluate(c, degree, lo);
+  if (prev == 0) {
+    roots[count++] = lo;
+  }
+
+  for (int k = 1; k <= crit + 1; k++) {
+    const double val = evaluate(c, degree, ends[k]);
+    if (val == 0) {
+      if (count == 0 || ends[k] > roots[count - 1]) {
+        roots[count++] = ends[k];
+      }
+    } else if (prev != 0 && (prev < 0) != (val < 0)) {
+      roots[count++] = refineRoot(c, degree, ends[k - 1], ends[k]);
+    }
+
+    prev = val;
+  }
+
+  return count;
+}
+
+/**
+ * @brief Finds the maximum of a polynomial on an interval
+ *
+ * @param c Coefficients, lowest power first
+ * @param degree Degree of the polynomial, at most MAX_DEGREE
+ * @param lo Lower end of the interval
+ * @param hi Upper end of the interval
+ * @param at Output for where the maximum is, if not null
+ *
+ * @returns Maximum value
+ */
+inline double findMax(const double c[], const int degree, const double lo,
+                      const double hi, double *at = nullptr) {
+  double res = evaluate(c, degree, lo);
+  double arg = lo;
+
+  const double valHi = evaluate(c, degree, hi);
+  if (valHi > res) {
+    res = valHi;
+    arg = hi;
+  }
+
+  if (degree >= 2) {
+    double der[MAX_DEGREE];
+    double crit[MAX_DEGREE];
+    differentiate(c, degree, der);
+    const int count = findRoots(der, degree - 1, lo, hi, crit);
+    for (int k = 0; k < count; k++) {
+      const double val = evaluate(c, degree, crit[k]);
+      if (val > res) {
+        res = val;
+        arg = crit[k];
+      }
+    }
+  }
+
+  if (at != nullptr) {
+    *at = arg;
+  }
+  return res;
+}
+
+/**
+ * @brief Differentiates a segment with respect to time
+ *
+ * The segment is given in the power basis, laid out as the output of
+ * HermiteSub::getPowerBasis(), so c[j * D + dim] is the coefficient of u^j in
+ * dimension dim, where u = (t - t0) * invH.
+ *
+ * @param c Coefficients of the segment
+ * @param degree Degree of the segment, at least 1
+ * @param invH Reciprocal of the length of the segment
+ * @param out Output array of degree * D coefficients in the same layout
+ */
+template <std::size_t D>
+void differentiate(const double c[], const int degree, const double invH,
+                   double out[]) {
+  for (int j = 1; j <= degree; j++) {
+    for (std::size_t dim = 0; dim < D; dim++) {
+      out[(j - 1) * D + dim] = j * c[j * D + dim] * invH;
+    }
+  }
+}
+
+/**
+ * @brief Gets part of a cubic segment as a segment of its own
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param u0 Start of the part
+ * @param u1 End of the part
+ * @param out Output array of 4 * D coefficients in the same layout, as a
+ * polynomial in v, where u = u0 + (u1 - u0)v
+ */
+template <std::size_t D>
+void getSubSegment(const double c[], const double u0, const double u1,
+                   double out[]) {
+  const double scale = u1 - u0;
+  for (std::size_t dim = 0; dim < D; dim++) {
+    const double c0 = c[dim];
+    const double c1 = c[D + dim];
+    const double c2 = c[2 * D + dim];
+    const double c3 = c[3 * D + dim];
+
+    // Taylor expansion about u0
+    out[dim] = c0 + u0 * (c1 + u0 * (c2 + u0 * c3));
+    out[D + dim] = (c1 + u0 * (2 * c2 + 3 * u0 * c3)) * scale;
+    out[2 * D + dim] = (c2 + 3 * u0 * c3) * scale * scale;
+    out[3 * D + dim] = c3 * scale * scale * scale;
+  }
+}
+
+/**
+ * @brief Gets the squared magnitude of a segment as one polynomial in u
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param degree Degree of the segment, at most MAX_DEGREE / 2
+ * @param out Output array of 2 * degree + 1 coefficients, lowest power first
+ */
+template <std::size_t D>
+void getSquaredMagn(const double c[], const int degree, double out[]) {
+  std::fill(out, out + 2 * degree + 1, 0.0);
+  for (int i = 0; i <= degree; i++) {
+    for (int j = 0; j <= degree; j++) {
+      double dot = 0;
+      for (std::size_t dim = 0; dim < D; dim++) {
+        dot += c[i * D + dim] * c[j * D + dim];
+      }
+      out[i + j] += dot;
+    }
+  }
+}
+
+/**
+ * @brief Gets the largest magnitude of a segment
+ *
+ * Exact up to rounding: the squared magnitude is a polynomial, whose maximum
+ * is at an end of the segment or at a root of its derivative.
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param degree Degree of the segment, at most MAX_DEGREE / 2
+ * @param u0 Start of the part of the segment to check
+ * @param u1 End of the part of the segment to check, at least u0
+ *
+ * @returns Largest squared magnitude over u in [u0, u1]
+ */
+template <std::size_t D>
+double getMaxSquaredMagn(const double c[], const int degree,
+                         const double u0 = 0, const double u1 = 1) {
+  double sq[MAX_DEGREE + 1];
+  getSquaredMagn<D>(c, degree, sq);
+  return std::max(findMax(sq, 2 * degree, u0, u1), 0.0);
+}
+
+/**
+ * @brief Gets the largest magnitude of a derivative of a cubic segment
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param invH Reciprocal of the length of the segment
+ * @param deriv 0 for distance from the origin, 1 for speed, 2 for magnitude
+ * of acceleration
+ * @param u0 Start of the part of the segment to check
+ * @param u1 End of the part of the segment to check, at least u0
+ *
+ * @returns Square of the largest magnitude over u in [u0, u1]
+ */
+template <std::size_t D>
+double getSegmentMax(const double c[], const double invH, const int deriv,
+                     const double u0 = 0, const double u1 = 1) {
+  if (deriv == 0) {
+    return getMaxSquaredMagn<D>(c, 3, u0, u1);
+  }
+
+  double vel[3 * D];
+  differentiate<D>(c, 3, invH, vel);
+  if (deriv == 1) {
+    return getMaxSquaredMagn<D>(vel, 2, u0, u1);
+  }
+
+  double acc[2 * D];
+  differentiate<D>(vel, 2, invH, acc);
+  return getMaxSquaredMagn<D>(acc, 1, u0, u1);
+}
+
+/**
+ * @brief Gets the smallest and largest coordinates of a cubic segment
+ *
+ * Exact up to rounding: each coordinate is a cubic, whose extrema are at the
+ * ends or at the roots of its quadratic derivative.
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param u0 Start of the part of the segment to bound
+ * @param u1 End of the part of the segment to bound, at least u0
+ * @param lower Output array of D smallest coordinates
+ * @param upper Output array of D largest coordinates
+ */
+template <std::size_t D>
+void getSegmentBounds(const double c[], const double u0, const double u1,
+                      double lower[], double upper[]) {
+  for (std::size_t dim = 0; dim < D; dim++) {
+    const double cubic[4] = {c[dim], c[D + dim], c[2 * D + dim],
+                             c[3 * D + dim]};
+    const double quad[3] = {cubic[1], 2 * cubic[2], 3 * cubic[3]};
+
+    const double a = evaluate(cubic, 3, u0);
+    const double b = evaluate(cubic, 3, u1);
+    lower[dim] = std::min(a, b);
+    upper[dim] = std::max(a, b);
+
+    double crit[2];
+    const int count = findRoots(quad, 2, u0, u1, crit);
+    for (int k = 0; k < count; k++) {
+      const double val = evaluate(cubic, 3, crit[k]);
+      lower[dim] = std::min(lower[dim], val);
+      upper[dim] = std::max(upper[dim], val);
+    }
+  }
+}
+
+/**
+ * @brief Finds the point of a cubic segment closest to another point
+ *
+ * The squared distance is a polynomial of degree 6, so its minimum is at an
+ * end of the segment or at a root of its quintic derivative, which is found by
+ * findRoots().
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param point Array of D coordinates of the other point
+ * @param sqDist Output for the squared distance at the closest point, if not
+ * null
+ *
+ * @returns u of the closest point, from 0 to 1
+ */
+template <std::size_t D>
+double getClosestU(const double c[], const double point[],
+                   double *sqDist = nullptr) {
+  double shifted[4 * D];
+  std::copy(c, c + 4 * D, shifted);
+  for (std::size_t dim = 0; dim < D; dim++) {
+    shifted[dim] -= point[dim];
+  }
+
+  // the minimum of the squared distance is the maximum of its negation
+  double sq[MAX_DEGREE + 1];
+  getSquaredMagn<D>(shifted, 3, sq);
+  for (int j = 0; j <= MAX_DEGREE; j++) {
+    sq[j] = -sq[j];
+  }
+
+  double u = 0;
+  const double res = -findMax(sq, MAX_DEGREE, 0, 1, &u);
+  if (sqDist != nullptr) {
+    *sqDist = std::max(res, 0.0);
+  }
+  return u;
+}
+
+/**
+ * @brief Gets the magnitude of a quadratic segment
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param u Input
+ *
+ * @returns Magnitude at u
+ */
+template <std::size_t D> double getMagn(const double c[], const double u) {
+  double res = 0;
+  for (std::size_t dim = 0; dim < D; dim++) {
+    const double val = c[dim] + u * (c[D + dim] + u * c[2 * D + dim]);
+    res += val * val;
+  }
+
+  return std::sqrt(res);
+}
+
+/**
+ * @brief Integrates the magnitude of a quadratic segment with 5 point
+ * Gauss-Legendre quadrature
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param u0 Lower limit
+ * @param u1 Upper limit
+ *
+ * @returns Estimate of the integral
+ */
+template <std::size_t D>
+double estimateMagnIntegral(const double c[], const double u0,
+                            const double u1) {
+  static const double nodes[5] = {0, 0.5384693101056831, -0.5384693101056831,
+                                  0.9061798459386640, -0.9061798459386640};
+  static const double weights[5] = {0.5688888888888889, 0.4786286704993665,
+                                    0.4786286704993665, 0.2369268850561891,
+                                    0.2369268850561891};
+
+  const double mid = 0.5 * (u0 + u1);
+  const double half = 0.5 * (u1 - u0);
+  double res = 0;
+  for (int k = 0; k < 5; k++) {
+    res += weights[k] * getMagn<D>(c, mid + half * nodes[k]);
+  }
+
+  return res * half;
+}
+
+/**
+ * @brief Integrates the magnitude of a quadratic segment adaptively
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param u0 Lower limit
+ * @param u1 Upper limit
+ * @param whole Estimate of the integral over the whole range, from
+ * estimateMagnIntegral()
+ * @param depth Number of times the range may still be split
+ *
+ * @returns Integral
+ */
+template <std::size_t D>
+double refineMagnIntegral(const double c[], const double u0, const double u1,
+                          const double whole, const int depth) {
+  const double mid = 0.5 * (u0 + u1);
+  const double left = estimateMagnIntegral<D>(c, u0, mid);
+  const double right = estimateMagnIntegral<D>(c, mid, u1);
+  const double res = left + right;
+
+  if (depth <= 0 ||
+      std::abs(res - whole) <= LENGTH_TOLERANCE * std::abs(res)) {
+    return res;
+  }
+
+  return refineMagnIntegral<D>(c, u0, mid, left, depth - 1) +
+         refineMagnIntegral<D>(c, mid, u1, right, depth - 1);
+}
+
+/**
+ * @brief Integrates the magnitude of a quadratic segment to within
+ * LENGTH_TOLERANCE
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param u0 Lower limit
+ * @param u1 Upper limit
+ *
+ * @returns Integral, which is negative if u1 < u0
+ */
+template <std::size_t D>
+double integrateMagn(const double c[], const double u0, const double u1) {
+  return refineMagnIntegral<D>(c, u0, u1, estimateMagnIntegral<D>(c, u0, u1),
+                               LENGTH_DEPTH);
+}
+
+/**
+ * @brief Gets the arc length of part of a cubic segment
+ *
+ * Integrates the speed with adaptive Gauss-Legendre quadrature. The speed of a
+ * cubic is the square root of a quartic, which is smooth except where the
+ * speed is zero, so most segments take one or two levels of splitting.
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param u0 Lower limit, from 0 to 1
+ * @param u1 Upper limit, from 0 to 1
+ *
+ * @returns Arc length from u0 to u1, which is negative if u1 < u0
+ */
+template <std::size_t D>
+double getSegmentLength(const double c[], const double u0, const double u1) {
+  // the length does not depend on how fast the segment is traversed, so the
+  // derivative is taken with respect to u
+  double vel[3 * D];
+  differentiate<D>(c, 3, 1, vel);
+  return integrateMagn<D>(vel, u0, u1);
+}
+
+/**
+ * @brief Finds where a cubic segment reaches a certain arc length
+ *
+ * The arc length is increasing in u, and its derivative is the speed, so this
+ * takes Newton steps on the speed, falling back to bisection whenever a step
+ * would leave the bracket or the speed is zero. Each step only integrates from
+ * the start point to the current guess.
+ *
+ * @param c Coefficients of the segment, laid out as in differentiate()
+ * @param u0 Start point, from 0 to 1
+ * @param length Arc length to travel from u0, which is negative to travel
+ * backward
+ *
+ * @note The arc length must be reachable before the end of the segment. If
+ * not, then this slowly converges to 0 or 1.
+ *
+ * @returns u, from 0 to 1, where the arc length from u0 is length
+ */
+template <std::size_t D>
+double getUAtLength(const double c[], const double u0, const double length) {
+  if (length == 0) {
+    return u0;
+  }
+
+  double vel[3 * D];
+  differentiate<D>(c, 3, 1, vel);
+
+  double lo = length > 0 ? u0 : 0;
+  double hi = length > 0 ? 1 : u0;
+  const double speed0 = getMagn<D>(vel, u0);
+  double u = speed0 > 0 ? u0 + length / speed0 : 0.5 * (lo + hi);
+  if (!(u > lo && u < hi)) {
+    u = 0.5 * (lo + hi);
+  }
+
+  for (int iter = 0; iter < ROOT_ITERATIONS; iter++) {
+    const double err = integrateMagn<D>(vel, u0, u) - length;
+    if (std::abs(err) <= LENGTH_TOLERANCE * std::abs(length)) {
+      return u;
+    }
+
+    if (err < 0) {
+      lo = u;
+    } else {
+      hi = u;
+    }
+
+    double next = u - err / getMagn<D>(vel, u);
+    if (!(next > lo && next < hi)) {
+      next = 0.5 * (lo + hi);
+    }
+
+    if (next == u) {
+      return u;
+    }
+    u = next;
+  }
+
+  return u;
+}
+} // namespace poly
+} // namespace hermite
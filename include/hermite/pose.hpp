@@ -8,6 +8,7 @@
 
 #include <cstddef>
 
+#include "hermite/pod_vector.hpp"
 #include "hermite/thirdparty/simplevectors.hpp"
 
 namespace hermite {
@@ -19,8 +20,16 @@ using svector::Vector;
  * Poses in multiple dimensions can use multiple Pose objects.
  *
  * It is recommended to create a pose using makePose().
+ *
+ * The vectors are stored as PodVector, so a pose is trivially copyable and
+ * lists of poses can be copied with memcpy.
+ *
+ * The position and velocity are stored as T, which is double by default.
+ * With float, a pose takes about half the memory, and the vectors are rounded
+ * to about 7 significant digits. The time is always stored as a double, so
+ * large absolute timestamps keep their precision.
  */
-template <std::size_t D> class Pose {
+template <std::size_t D, typename T = double> class Pose {
 public:
   /**
    * @brief Default constructor
@@ -39,27 +48,26 @@ public:
   Pose(const double time, const Vector<D> pos, const Vector<D> vel)
       : m_time{time}, m_pos{pos}, m_vel{vel} {}
 
+  /**
+   * @brief Constructor
+   *
+   * @param time Time to reach this pose
+   * @param pos Position vector
+   * @param vel Velocity vector
+   */
+  Pose(const double time, const PodVector<D, T> &pos,
+       const PodVector<D, T> &vel)
+      : m_time{time}, m_pos{pos}, m_vel{vel} {}
+
   /**
    * @brief Copy constructor
    */
-  Pose(const Pose<D> &other)
-      : m_time{other.m_time}, m_pos{other.m_pos}, m_vel{other.m_vel} {}
+  Pose(const Pose<D, T> &other) = default;
 
   /**
    * @brief Assignment operator
    */
-  Pose<D> &operator=(const Pose<D> &other) {
-    // check if assigning to self
-    if (this == &other) {
-      return *this;
-    }
-
-    m_pos = other.m_pos;
-    m_vel = other.m_vel;
-    m_time = other.m_time;
-
-    return *this;
-  }
+  Pose<D, T> &operator=(const Pose<D, T> &other) = default;
 
   /**
    * @brief Destructor
@@ -80,6 +88,20 @@ public:
    */
   Vector<D> getVel() const { return m_vel; }
 
+  /**
+   * @brief Gets position vector without converting it
+   *
+   * @returns Reference to the stored position vector
+   */
+  const PodVector<D, T> &getPosData() const { return m_pos; }
+
+  /**
+   * @brief Gets velocity vector without converting it
+   *
+   * @returns Reference to the stored velocity vector
+   */
+  const PodVector<D, T> &getVelData() const { return m_vel; }
+
   /**
    * @brief Gets time
    *
@@ -110,7 +132,7 @@ public:
 
 private:
   double m_time;
-  Vector<D> m_pos;
-  Vector<D> m_vel;
+  PodVector<D, T> m_pos;
+  PodVector<D, T> m_vel;
 };
 } // namespace hermite
@@ -0,0 +1,917 @@
+/**
+ * @file
+ *
+ * Cached measurements of every segment of a spline
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "hermite/bounding_box.hpp"
+#include "hermite/poly/poly.hpp"
+#include "hermite/segment_tree.hpp"
+#include "hermite/separation.hpp"
+#include "hermite/thirdparty/simplevectors.hpp"
+
+namespace hermite {
+using svector::Vector;
+
+/**
+ * @brief Measurements of one segment, or of a run of segments
+ */
+template <std::size_t D> struct SegmentSummary {
+  /**
+   * @brief Arc length
+   */
+  double length;
+
+  /**
+   * @brief Largest magnitudes, indexed by derivative
+   *
+   * maxMagn[0] is the largest distance from the origin, maxMagn[1] is the
+   * largest speed, and maxMagn[2] is the largest magnitude of acceleration.
+   */
+  double maxMagn[3];
+
+  /**
+   * @brief Smallest box that contains the segments
+   */
+  BoundingBox<D> box;
+
+  /**
+   * @brief Default constructor
+   *
+   * Initializes the summary of zero segments
+   */
+  SegmentSummary() : length{0}, maxMagn{0, 0, 0} {}
+
+  /**
+   * @brief Measures one segment
+   *
+   * @param coefs Coefficients of the segment, laid out as the output of
+   * HermiteSub::getPowerBasis()
+   * @param h Length of time of the segment
+   *
+   * @returns Summary of the segment
+   */
+  static SegmentSummary<D> measure(const double coefs[], const double h) {
+    SegmentSummary<D> res;
+    res.length = poly::getSegmentLength<D>(coefs, 0, 1);
+    for (int deriv = 0; deriv < 3; deriv++) {
+      res.maxMagn[deriv] =
+          std::sqrt(poly::getSegmentMax<D>(coefs, 1 / h, deriv));
+    }
+    res.box = getBox(coefs, 0, 1);
+    return res;
+  }
+
+  /**
+   * @brief Combines the summaries of two runs of segments
+   *
+   * @param a Summary of the earlier run
+   * @param b Summary of the later run
+   *
+   * @returns Summary of both runs
+   */
+  static SegmentSummary<D> merge(const SegmentSummary<D> &a,
+                                 const SegmentSummary<D> &b) {
+    SegmentSummary<D> res;
+    res.length = a.length + b.length;
+    for (int deriv = 0; deriv < 3; deriv++) {
+      res.maxMagn[deriv] = std::max(a.maxMagn[deriv], b.maxMagn[deriv]);
+    }
+    res.box = BoundingBox<D>::merge(a.box, b.box);
+    return res;
+  }
+
+  /**
+   * @brief Bounds part of one segment
+   *
+   * @param coefs Coefficients of the segment
+   * @param u0 Start of the part to bound
+   * @param u1 End of the part to bound, at least u0
+   *
+   * @returns Smallest box that contains the part
+   */
+  static BoundingBox<D> getBox(const double coefs[], const double u0,
+                               const double u1) {
+    double lower[D];
+    double upper[D];
+    poly::getSegmentBounds<D>(coefs, u0, u1, lower, upper);
+
+    BoundingBox<D> res;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      res.lower[dim] = lower[dim];
+      res.upper[dim] = upper[dim];
+    }
+    return res;
+  }
+};
+
+/**
+ * @brief Cached measurements of every segment of a spline
+ *
+ * Keeps each segment in the power basis, along with a SegmentTree of their
+ * summaries, so questions about the whole spline or a range of time, such as
+ * its arc length or largest speed, only measure the partial segments at the
+ * ends, and look up the rest in logarithmic time.
+ *
+ * Measuring a segment is much slower than converting it to the power basis, so
+ * when the whole cache is replaced, the summaries of segments that did not
+ * change are kept.
+ */
+template <std::size_t D> class SegmentCache {
+public:
+  /**
+   * @brief Where the last search by arc length ended
+   *
+   * Lets a search start from the answer to the previous one, which takes
+   * constant time if the arc length moved by less than a few segments.
+   */
+  struct Hint {
+    /**
+     * @brief Index of the segment
+     */
+    std::size_t seg;
+
+    /**
+     * @brief Arc length at the start of the segment
+     */
+    double start;
+
+    /**
+     * @brief u of the answer
+     */
+    double u;
+
+    /**
+     * @brief Arc length of the answer
+     */
+    double dist;
+
+    /**
+     * @brief Version of the cache that the hint came from
+     */
+    std::size_t version;
+
+    /**
+     * @brief Default constructor
+     *
+     * Initializes a hint that is not used by the next search
+     */
+    Hint() : seg{0}, start{0}, u{0}, dist{0}, version{0} {}
+  };
+
+  /**
+   * @brief Default constructor
+   *
+   * Initializes with zero segments
+   */
+  SegmentCache() : m_version{nextVersion()} {}
+
+  /**
+   * @brief Replaces every segment
+   *
+   * Only measures the segments that are not already in the cache with the
+   * same times and coefficients.
+   *
+   * @param times Knot times, sorted with no repeats
+   * @param coefs Coefficients of each segment, laid out as in
+   * CompiledSpline::CompiledSpline()
+   */
+  void assign(std::vector<double> times, std::vector<double> coefs) {
+    std::swap(m_times, times);
+    std::swap(m_coefs, coefs);
+
+    const std::size_t segs = getSegmentCount();
+    std::vector<SegmentSummary<D>> summaries(segs);
+
+    // the old segments are walked alongside the new ones
+    std::size_t old = 0;
+    for (std::size_t seg = 0; seg < segs; seg++) {
+      while (old + 1 < times.size() && times[old] < m_times[seg]) {
+        old++;
+      }
+
+      const double *c = &m_coefs[4 * D * seg];
+      if (old + 1 < times.size() && times[old] == m_times[seg] &&
+          times[old + 1] == m_times[seg + 1] &&
+          std::equal(c, c + 4 * D, &coefs[4 * D * old])) {
+        summaries[seg] = m_tree.get(old);
+      } else {
+        summaries[seg] = SegmentSummary<D>::measure(c, getDuration(seg));
+      }
+    }
+
+    m_tree.assign(summaries);
+    m_version = nextVersion();
+  }
+
+  /**
+   * @brief Removes every segment
+   */
+  void clear() { assign({}, {}); }
+
+  /**
+   * @brief Moves a knot
+   *
+   * @param knot Index of the knot
+   * @param time New time, which must keep the knots sorted
+   *
+   * @note Call setSegment() on the segments on either side afterward.
+   */
+  void setTime(const std::size_t knot, const double time) {
+    m_times[knot] = time;
+    m_version = nextVersion();
+  }
+
+  /**
+   * @brief Replaces one segment, and measures it again
+   *
+   * Takes logarithmic time, plus the time to measure the segment.
+   *
+   * @param seg Index of the segment
+   * @param coefs New coefficients of the segment
+   *
+   * @note Uses the current times of the knots on either side.
+   */
+  void setSegment(const std::size_t seg, const double coefs[]) {
+    std::copy(coefs, coefs + 4 * D, &m_coefs[4 * D * seg]);
+    m_tree.set(seg, SegmentSummary<D>::measure(coefs, getDuration(seg)));
+    m_version = nextVersion();
+  }
+
+  /**
+   * @brief Gets the number of segments
+   *
+   * @returns Number of segments, which is one less than the number of knots
+   */
+  std::size_t getSegmentCount() const {
+    return m_times.size() < 2 ? 0 : m_times.size() - 1;
+  }
+
+  /**
+   * @brief Gets the knot times
+   *
+   * @returns Knot times, sorted
+   */
+  const std::vector<double> &getTimes() const { return m_times; }
+
+  /**
+   * @brief Gets the coefficients of a segment
+   *
+   * @param seg Index of the segment
+   *
+   * @returns Pointer to 4 * D coefficients
+   */
+  const double *getCoefficients(const std::size_t seg) const {
+    return &m_coefs[4 * D * seg];
+  }
+
+  /**
+   * @brief Gets the summaries of the segments
+   *
+   * @returns Tree of summaries, where value i is the summary of segment i
+   */
+  const SegmentTree<SegmentSummary<D>> &getTree() const { return m_tree; }
+
+  /**
+   * @brief Finds the segment containing a time
+   *
+   * Times on a knot get the later segment, and times outside of the knots get
+   * the first or last segment.
+   *
+   * @param t Time
+   *
+   * @returns Index of the segment. There must be at least one segment.
+   */
+  std::size_t findSegment(const double t) const {
+    const auto it = std::upper_bound(m_times.begin(), m_times.end(), t);
+    const std::size_t upper = static_cast<std::size_t>(it - m_times.begin());
+    return std::min(std::max(upper, std::size_t{1}), m_times.size() - 1) - 1;
+  }
+
+  /**
+   * @brief Gets the position of a time within a segment
+   *
+   * @param seg Index of the segment
+   * @param t Time
+   *
+   * @returns u, which is 0 at the start of the segment and 1 at the end
+   */
+  double getU(const std::size_t seg, const double t) const {
+    return (t - m_times[seg]) / getDuration(seg);
+  }
+
+  /**
+   * @brief Gets the length of time of a segment
+   *
+   * @param seg Index of the segment
+   *
+   * @returns Time between the knots on either side
+   */
+  double getDuration(const std::size_t seg) const {
+    return m_times[seg + 1] - m_times[seg];
+  }
+
+  /**
+   * @brief Gets the arc length of every segment
+   *
+   * @returns Arc length
+   */
+  double getLength() const { return m_tree.getAll().length; }
+
+  /**
+   * @brief Gets the arc length between two times
+   *
+   * Takes logarithmic time, plus the time to measure the partial segments at
+   * the ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the knots.
+   *
+   * @returns Arc length, which is negative if t1 < t0
+   */
+  double getLength(double t0, double t1) const {
+    if (getSegmentCount() == 0) {
+      return 0;
+    }
+
+    if (t1 < t0) {
+      return -getLength(t1, t0);
+    }
+
+    t0 = std::max(t0, m_times.front());
+    t1 = std::min(t1, m_times.back());
+    if (t1 <= t0) {
+      return 0;
+    }
+
+    const std::size_t seg0 = findSegment(t0);
+    const std::size_t seg1 = findSegment(t1);
+    const double u0 = getU(seg0, t0);
+    const double u1 = getU(seg1, t1);
+
+    if (seg0 == seg1) {
+      return poly::getSegmentLength<D>(getCoefficients(seg0), u0, u1);
+    }
+
+    return poly::getSegmentLength<D>(getCoefficients(seg0), u0, 1) +
+           m_tree.query(seg0 + 1, seg1).length +
+           poly::getSegmentLength<D>(getCoefficients(seg1), 0, u1);
+  }
+
+  /**
+   * @brief Gets the largest magnitude of a derivative between two times
+   *
+   * Takes logarithmic time, plus the time to check the partial segments at the
+   * ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   * @param deriv 0 for distance from the origin, 1 for speed, 2 for magnitude
+   * of acceleration
+   *
+   * @note The times are clamped to the knots, and may be in either order.
+   *
+   * @returns Largest magnitude, or 0 if there are no segments
+   */
+  double getMax(double t0, double t1, const int deriv) const {
+    if (getSegmentCount() == 0) {
+      return 0;
+    }
+
+    if (t1 < t0) {
+      std::swap(t0, t1);
+    }
+
+    t0 = std::min(std::max(t0, m_times.front()), m_times.back());
+    t1 = std::min(std::max(t1, m_times.front()), m_times.back());
+
+    const std::size_t seg0 = findSegment(t0);
+    const std::size_t seg1 = findSegment(t1);
+    const double u0 = getU(seg0, t0);
+    const double u1 = getU(seg1, t1);
+
+    if (seg0 == seg1) {
+      return std::sqrt(poly::getSegmentMax<D>(
+          getCoefficients(seg0), 1 / getDuration(seg0), deriv, u0, u1));
+    }
+
+    const double ends = std::max(
+        poly::getSegmentMax<D>(getCoefficients(seg0), 1 / getDuration(seg0),
+                               deriv, u0, 1),
+        poly::getSegmentMax<D>(getCoefficients(seg1), 1 / getDuration(seg1),
+                               deriv, 0, u1));
+    return std::max(std::sqrt(ends),
+                    m_tree.query(seg0 + 1, seg1).maxMagn[deriv]);
+  }
+
+  /**
+   * @brief Gets the smallest box that contains the spline between two times
+   *
+   * Takes logarithmic time, plus the time to bound the partial segments at the
+   * ends.
+   *
+   * @param t0 Start time
+   * @param t1 End time
+   *
+   * @note The times are clamped to the knots, and may be in either order.
+   *
+   * @returns Box, which is empty if there are no segments
+   */
+  BoundingBox<D> getBox(double t0, double t1) const {
+    if (getSegmentCount() == 0) {
+      return BoundingBox<D>{};
+    }
+
+    if (t1 < t0) {
+      std::swap(t0, t1);
+    }
+
+    t0 = std::min(std::max(t0, m_times.front()), m_times.back());
+    t1 = std::min(std::max(t1, m_times.front()), m_times.back());
+
+    const std::size_t seg0 = findSegment(t0);
+    const std::size_t seg1 = findSegment(t1);
+    const double u0 = getU(seg0, t0);
+    const double u1 = getU(seg1, t1);
+
+    if (seg0 == seg1) {
+      return SegmentSummary<D>::getBox(getCoefficients(seg0), u0, u1);
+    }
+
+    const BoundingBox<D> ends = BoundingBox<D>::merge(
+        SegmentSummary<D>::getBox(getCoefficients(seg0), u0, 1),
+        SegmentSummary<D>::getBox(getCoefficients(seg1), 0, u1));
+    return BoundingBox<D>::merge(ends, m_tree.query(seg0 + 1, seg1).box);
+  }
+
+  /**
+   * @brief Finds the time at which the spline is closest to a point
+   *
+   * Uses the tree of bounding boxes as a bounding volume hierarchy: it is
+   * searched nearer child first, and a node is skipped if its box is no closer
+   * than the best point found so far. Each segment that is not skipped is
+   * solved exactly with getClosestU(). Usually only a few segments near the
+   * point are solved, so this takes about logarithmic time.
+   *
+   * @param point Point
+   *
+   * @returns Time of the closest point, or 0 if there are no segments. If
+   * several points are equally close, then any of them may be returned.
+   */
+  double getClosestTime(const Vector<D> &point) const {
+    if (getSegmentCount() == 0) {
+      return 0;
+    }
+
+    Closest best;
+    searchClosest(point, 1, best);
+    return m_times[best.seg] + best.u * getDuration(best.seg);
+  }
+
+  /**
+   * @brief Finds the time at which the spline is closest to a point, starting
+   * from a nearby time
+   *
+   * Solves the segment containing the hint first, so if the answer is near it,
+   * such as when tracking a robot that moves a little between queries, most of
+   * the tree is skipped right away.
+   *
+   * @param point Point
+   * @param hint Time to start from, usually the previous answer
+   *
+   * @returns Same as getClosestTime(const Vector<D> &)
+   */
+  double getClosestTime(const Vector<D> &point, const double hint) const {
+    if (getSegmentCount() == 0) {
+      return 0;
+    }
+
+    Closest best;
+    measureClosest(point, findSegment(hint), best);
+    searchClosest(point, 1, best);
+    return m_times[best.seg] + best.u * getDuration(best.seg);
+  }
+
+  /**
+   * @brief Finds the closest approach of two splines at the same times
+   *
+   * The knots of both splines are merged, so that on each interval between
+   * them, the difference of the splines is one cubic. An interval is skipped
+   * if a lower bound on its distance is no less than the best distance so far
+   * and greater than the threshold. The bound is the larger of the gap between
+   * the bounding boxes of the two segments, and the distance at the nearer end
+   * of the interval minus the most that the distance can change on the way
+   * there, from the largest speeds of the segments. The distances at the knots
+   * give the first best distance, so usually only the intervals near the
+   * closest approach and near the threshold are solved exactly, from the
+   * squared distance, which is a polynomial of degree 6.
+   *
+   * @param other Other spline
+   * @param threshold Distance whose crossings are found. Pass a negative number
+   * if they are not needed.
+   *
+   * @returns Closest approach over the times shared by the knots of both
+   * splines
+   */
+  Separation getSeparation(const SegmentCache<D> &other,
+                           const double threshold) const {
+    Separation res;
+    res.distance = std::numeric_limits<double>::infinity();
+    res.time = 0;
+    res.startsBelow = false;
+    if (getSegmentCount() == 0 || other.getSegmentCount() == 0) {
+      return res;
+    }
+
+    const double start = std::max(m_times.front(), other.m_times.front());
+    const double end = std::min(m_times.back(), other.m_times.back());
+    if (end < start) {
+      return res;
+    }
+
+    const std::vector<double> knots = mergeKnots(other, start, end);
+    std::vector<double> dists(knots.size());
+    double best = std::numeric_limits<double>::infinity();
+    for (std::size_t k = 0; k < knots.size(); k++) {
+      dists[k] = std::sqrt(getSquaredDistance(other, knots[k]));
+      if (dists[k] < best) {
+        best = dists[k];
+        res.time = knots[k];
+      }
+    }
+
+    const double sqThreshold = threshold < 0 ? -1 : threshold * threshold;
+    res.startsBelow = dists[0] < threshold;
+    bool below = res.startsBelow;
+
+    for (std::size_t k = 0; k + 1 < knots.size(); k++) {
+      const double ta = knots[k];
+      const double tb = knots[k + 1];
+      const std::size_t seg = findSegment(0.5 * (ta + tb));
+      const std::size_t otherSeg = other.findSegment(0.5 * (ta + tb));
+
+      const SegmentSummary<D> &summary = m_tree.get(seg);
+      const SegmentSummary<D> &otherSummary = other.m_tree.get(otherSeg);
+      const double boxGap =
+          std::sqrt(summary.box.getSquaredDistance(otherSummary.box));
+      const double maxChange = (summary.maxMagn[1] + otherSummary.maxMagn[1]) *
+                               0.5 * (tb - ta);
+      const double bound =
+          std::max(boxGap, std::min(dists[k], dists[k + 1]) - maxChange);
+
+      const bool mayCross = bound <= threshold;
+      if (bound >= best && !mayCross) {
+        continue;
+      }
+
+      // the difference of the splines over the interval, in v from 0 to 1
+      double diff[4 * D];
+      double otherCoefs[4 * D];
+      poly::getSubSegment<D>(getCoefficients(seg), getU(seg, ta),
+                             getU(seg, tb), diff);
+      poly::getSubSegment<D>(other.getCoefficients(otherSeg),
+                             other.getU(otherSeg, ta),
+                             other.getU(otherSeg, tb), otherCoefs);
+      for (std::size_t j = 0; j < 4 * D; j++) {
+        diff[j] -= otherCoefs[j];
+      }
+
+      double sq[poly::MAX_DEGREE + 1];
+      poly::getSquaredMagn<D>(diff, 3, sq);
+
+      double neg[poly::MAX_DEGREE + 1];
+      for (int j = 0; j <= poly::MAX_DEGREE; j++) {
+        neg[j] = -sq[j];
+      }
+      double v = 0;
+      const double dist =
+          std::sqrt(std::max(-poly::findMax(neg, poly::MAX_DEGREE, 0, 1, &v),
+                             0.0));
+      if (dist < best) {
+        best = dist;
+        res.time = ta + v * (tb - ta);
+      }
+
+      if (mayCross) {
+        sq[0] -= sqThreshold;
+        double roots[poly::MAX_DEGREE];
+        const int count = poly::findRoots(sq, poly::MAX_DEGREE, 0, 1, roots);
+        for (int r = 0; r < count; r++) {
+          // a root on a knot is checked by the interval that starts there,
+          // and one at the end of the window is not followed by anything
+          if (roots[r] >= 1) {
+            continue;
+          }
+
+          // touching the threshold without passing it is not a crossing
+          const double next = r + 1 < count ? roots[r + 1] : 1;
+          const bool after =
+              poly::evaluate(sq, poly::MAX_DEGREE, 0.5 * (roots[r] + next)) <
+              0;
+          if (after != below) {
+            res.crossings.push_back(ta + roots[r] * (tb - ta));
+            below = after;
+          }
+        }
+      }
+    }
+
+    res.distance = best;
+    return res;
+  }
+
+  /**
+   * @brief Finds the time at which the arc length from the first knot reaches
+   * a certain distance
+   *
+   * Finds the segment by walking down the tree of lengths, and then finds u
+   * within it with getUAtLength().
+   *
+   * @param dist Arc length from the first knot. It is clamped to the length of
+   * every segment.
+   *
+   * @returns Time, or 0 if there are no segments
+   */
+  double getTimeAtDistance(const double dist) const {
+    Hint hint;
+    return getTimeAtDistance(dist, hint);
+  }
+
+  /**
+   * @brief Finds the time at which the arc length from the first knot reaches
+   * a certain distance, starting from the previous answer
+   *
+   * If the hint came from this cache, and it has not changed since, then the
+   * search walks from the hint's segment and integrates only from the hint's
+   * answer, so nearby distances take amortized constant time. Otherwise, the
+   * search takes logarithmic time.
+   *
+   * @param dist Arc length from the first knot
+   * @param hint Answer to the previous search, which is updated to this one
+   *
+   * @returns Time, or 0 if there are no segments
+   */
+  double getTimeAtDistance(double dist, Hint &hint) const {
+    const std::size_t segs = getSegmentCount();
+    if (segs == 0) {
+      return 0;
+    }
+
+    const double total = getLength();
+    dist = std::min(std::max(dist, 0.0), total);
+
+    std::size_t seg = hint.seg;
+    double start = hint.start;
+    double u0 = hint.u;
+    double dist0 = hint.dist;
+    if (dist >= total) {
+      // the spline can end at a stop, where a tiny error in the length moves
+      // the answer a long way
+      seg = segs - 1;
+      start = total - m_tree.get(seg).length;
+    } else if (hint.version != m_version || !walk(dist, seg, start)) {
+      seg = descend(dist, start);
+      u0 = 0;
+      dist0 = start;
+    } else if (seg != hint.seg) {
+      u0 = 0;
+      dist0 = start;
+    }
+
+    // rounding in the running sums can leave the distance just outside
+    const double len = m_tree.get(seg).length;
+    const double target = std::min(std::max(dist - start, 0.0), len);
+    double u = 0;
+    if (target >= len || dist >= total) {
+      u = 1;
+    } else if (target > 0) {
+      u = poly::getUAtLength<D>(getCoefficients(seg), u0,
+                                target - (dist0 - start));
+    }
+
+    hint.seg = seg;
+    hint.start = start;
+    hint.u = u;
+    hint.dist = start + target;
+    hint.version = m_version;
+
+    return m_times[seg] + u * getDuration(seg);
+  }
+
+private:
+  std::vector<double> m_times;
+  std::vector<double> m_coefs;
+  SegmentTree<SegmentSummary<D>> m_tree;
+  std::size_t m_version;
+
+  /**
+   * Gets the sorted knots of two caches from start to end, including both
+   */
+  std::vector<double> mergeKnots(const SegmentCache<D> &other,
+                                 const double start, const double end) const {
+    std::vector<double> res{start};
+    auto it = std::upper_bound(m_times.begin(), m_times.end(), start);
+    auto otherIt =
+        std::upper_bound(other.m_times.begin(), other.m_times.end(), start);
+    while (true) {
+      double next = end;
+      if (it != m_times.end()) {
+        next = std::min(next, *it);
+      }
+      if (otherIt != other.m_times.end()) {
+        next = std::min(next, *otherIt);
+      }
+      if (next >= end) {
+        break;
+      }
+
+      res.push_back(next);
+      if (it != m_times.end() && *it == next) {
+        it++;
+      }
+      if (otherIt != other.m_times.end() && *otherIt == next) {
+        otherIt++;
+      }
+    }
+
+    if (end > start) {
+      res.push_back(end);
+    }
+    return res;
+  }
+
+  /**
+   * Gets the squared distance between two caches at a time
+   */
+  double getSquaredDistance(const SegmentCache<D> &other,
+                            const double t) const {
+    const std::size_t seg = findSegment(t);
+    const std::size_t otherSeg = other.findSegment(t);
+    const double u = getU(seg, t);
+    const double otherU = other.getU(otherSeg, t);
+    const double *c = getCoefficients(seg);
+    const double *otherC = other.getCoefficients(otherSeg);
+
+    double res = 0;
+    for (std::size_t dim = 0; dim < D; dim++) {
+      const double pos = getCoordinate(c, u, dim);
+      const double otherPos = getCoordinate(otherC, otherU, dim);
+      res += (pos - otherPos) * (pos - otherPos);
+    }
+    return res;
+  }
+
+  /**
+   * Evaluates one coordinate of a segment
+   */
+  static double getCoordinate(const double c[], const double u,
+                              const std::size_t dim) {
+    return c[dim] +
+           u * (c[D + dim] + u * (c[2 * D + dim] + u * c[3 * D + dim]));
+  }
+
+  /**
+   * Closest point found so far by a search
+   */
+  struct Closest {
+    std::size_t seg = 0;
+    double u = 0;
+    double sqDist = std::numeric_limits<double>::infinity();
+  };
+
+  /**
+   * Solves one segment for its closest point, and keeps it if it is the
+   * closest so far
+   */
+  void measureClosest(const Vector<D> &point, const std::size_t seg,
+                      Closest &best) const {
+    // the hint's segment is found again by the search
+    if (seg == best.seg &&
+        best.sqDist < std::numeric_limits<double>::infinity()) {
+      return;
+    }
+
+    double coords[D];
+    for (std::size_t dim = 0; dim < D; dim++) {
+      coords[dim] = point[dim];
+    }
+
+    double sqDist = 0;
+    const double u =
+        poly::getClosestU<D>(getCoefficients(seg), coords, &sqDist);
+    if (sqDist < best.sqDist) {
+      best.seg = seg;
+      best.u = u;
+      best.sqDist = sqDist;
+    }
+  }
+
+  /**
+   * Searches the node at index k of the tree for a point closer than the best
+   * so far
+   */
+  void searchClosest(const Vector<D> &point, const std::size_t k,
+                     Closest &best) const {
+    // the padding has an empty box, which is infinitely far away
+    if (m_tree.getNode(k).box.getSquaredDistance(point) >= best.sqDist) {
+      return;
+    }
+
+    const std::size_t leaves = m_tree.getLeafCount();
+    if (k >= leaves) {
+      measureClosest(point, k - leaves, best);
+      return;
+    }
+
+    const double left = m_tree.getNode(2 * k).box.getSquaredDistance(point);
+    const double right =
+        m_tree.getNode(2 * k + 1).box.getSquaredDistance(point);
+    if (left <= right) {
+      searchClosest(point, 2 * k, best);
+      searchClosest(point, 2 * k + 1, best);
+    } else {
+      searchClosest(point, 2 * k + 1, best);
+      searchClosest(point, 2 * k, best);
+    }
+  }
+
+  /**
+   * Gets a number that no other version of any cache has had, so a hint from
+   * one cache is not mistaken for a hint from another
+   */
+  static std::size_t nextVersion() {
+    static std::atomic<std::size_t> counter{1};
+    return counter++;
+  }
+
+  /**
+   * Moves a few segments from a hint toward the segment containing a distance
+   *
+   * @returns False if the segment is too far away
+   */
+  bool walk(const double dist, std::size_t &seg, double &start) const {
+    const std::size_t maxSteps = 4;
+    const std::size_t last = getSegmentCount() - 1;
+
+    for (std::size_t step = 0; step <= maxSteps; step++) {
+      if (seg > 0 && dist < start) {
+        seg--;
+        start -= m_tree.get(seg).length;
+      } else if (seg < last && dist >= start + m_tree.get(seg).length) {
+        start += m_tree.get(seg).length;
+        seg++;
+      } else {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * Walks down the tree of lengths to the segment containing a distance
+   *
+   * @param dist Distance, from 0 to the length of every segment
+   * @param start Output for the arc length at the start of the segment
+   *
+   * @returns Index of the segment
+   */
+  std::size_t descend(const double dist, double &start) const {
+    const std::size_t leaves = m_tree.getLeafCount();
+    const std::size_t last = getSegmentCount() - 1;
+
+    std::size_t k = 1;
+    start = 0;
+    while (k < leaves) {
+      const double left = m_tree.getNode(2 * k).length;
+      if (dist < start + left) {
+        k = 2 * k;
+      } else {
+        start += left;
+        k = 2 * k + 1;
+      }
+    }
+
+    std::size_t seg = k - leaves;
+    if (seg > last) {
+      // the padding has zero length, so this is only reachable through
+      // rounding at the end
+      start -= m_tree.get(last).length;
+      seg = last;
+    }
+    return seg;
+  }
+};
+} // namespace hermite
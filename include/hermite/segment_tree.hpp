@@ -0,0 +1,156 @@
+/**
+ * @file
+ *
+ * A segment tree for range queries over per-segment values
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace hermite {
+/**
+ * @brief A complete binary tree over an array, where each node holds the
+ * merge of the values below it
+ *
+ * Changing one value updates its ancestors in logarithmic time, and merging a
+ * range of values also takes logarithmic time. The number of leaves is rounded
+ * up to a power of 2, so the node at index k always has children 2k and
+ * 2k + 1, and the root is at index 1. This lets callers walk down the tree,
+ * for example to find where a running sum passes a value.
+ *
+ * @tparam T Type of the values. It must have a static member function
+ * T merge(const T &, const T &), which is associative, and T{} must be the
+ * identity of merge().
+ */
+template <typename T> class SegmentTree {
+public:
+  /**
+   * @brief Default constructor
+   *
+   * Initializes with zero values
+   */
+  SegmentTree() : m_n{0}, m_leaves{0} {}
+
+  /**
+   * @brief Constructor
+   *
+   * Builds the tree in linear time.
+   *
+   * @param values Value of each leaf
+   */
+  explicit SegmentTree(const std::vector<T> &values) : SegmentTree{} {
+    assign(values);
+  }
+
+  /**
+   * @brief Replaces all of the values
+   *
+   * Builds the tree in linear time, reusing its memory.
+   *
+   * @param values Value of each leaf
+   */
+  void assign(const std::vector<T> &values) {
+    m_n = values.size();
+    m_leaves = 1;
+    while (m_leaves < m_n) {
+      m_leaves *= 2;
+    }
+
+    m_nodes.assign(2 * m_leaves, T{});
+    for (std::size_t i = 0; i < m_n; i++) {
+      m_nodes[m_leaves + i] = values[i];
+    }
+    for (std::size_t k = m_leaves - 1; k >= 1; k--) {
+      m_nodes[k] = T::merge(m_nodes[2 * k], m_nodes[2 * k + 1]);
+    }
+  }
+
+  /**
+   * @brief Gets the number of values
+   *
+   * @returns Number of leaves that hold values
+   */
+  std::size_t size() const { return m_n; }
+
+  /**
+   * @brief Gets the number of leaves, including the padding
+   *
+   * @returns Number of leaves, which is a power of 2
+   */
+  std::size_t getLeafCount() const { return m_leaves; }
+
+  /**
+   * @brief Gets a value
+   *
+   * @param i Index of the value. Must be less than size().
+   *
+   * @returns Value of the leaf
+   */
+  const T &get(const std::size_t i) const { return m_nodes[m_leaves + i]; }
+
+  /**
+   * @brief Changes a value and updates its ancestors
+   *
+   * @param i Index of the value. Must be less than size().
+   * @param value New value
+   */
+  void set(const std::size_t i, const T &value) {
+    std::size_t k = m_leaves + i;
+    m_nodes[k] = value;
+    for (k /= 2; k >= 1; k /= 2) {
+      m_nodes[k] = T::merge(m_nodes[2 * k], m_nodes[2 * k + 1]);
+    }
+  }
+
+  /**
+   * @brief Gets a node of the tree
+   *
+   * Index 1 is the root, the children of index k are 2k and 2k + 1, and the
+   * leaf of value i is at getLeafCount() + i.
+   *
+   * @param k Index of the node, from 1 to 2 * getLeafCount() - 1
+   *
+   * @returns Merge of the values below the node
+   */
+  const T &getNode(const std::size_t k) const { return m_nodes[k]; }
+
+  /**
+   * @brief Merges all of the values
+   *
+   * @returns Merge of every value, or T{} if there are none
+   */
+  T getAll() const { return m_n == 0 ? T{} : m_nodes[1]; }
+
+  /**
+   * @brief Merges a range of values
+   *
+   * @param first Index of the first value
+   * @param last One past the index of the last value. Must not be more than
+   * size().
+   *
+   * @returns Merge of the values in order, or T{} if the range is empty
+   */
+  T query(std::size_t first, std::size_t last) const {
+    T left{};
+    T right{};
+    for (first += m_leaves, last += m_leaves; first < last;
+         first /= 2, last /= 2) {
+      if (first % 2 == 1) {
+        left = T::merge(left, m_nodes[first++]);
+      }
+      if (last % 2 == 1) {
+        right = T::merge(m_nodes[--last], right);
+      }
+    }
+
+    return T::merge(left, right);
+  }
+
+private:
+  std::size_t m_n;
+  std::size_t m_leaves;
+  std::vector<T> m_nodes;
+};
+} // namespace hermite
@@ -0,0 +1,33 @@
+/**
+ * @file
+ *
+ * Contains the separation data structure
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace hermite {
+/**
+ * @brief Closest approach of two trajectories over their common time window
+ *
+ * Returned by Hermite::getSeparation().
+ */
+struct Separation {
+  //! Smallest distance between the trajectories at the same time, or infinity
+  //! if they share no time window
+  double distance;
+
+  //! Time of the smallest distance
+  double time;
+
+  //! Times at which the distance passes through the threshold, sorted. Only
+  //! touching the threshold is not a crossing.
+  std::vector<double> crossings;
+
+  //! Whether the distance is below the threshold at the start of the common
+  //! time window, so the crossings alternate between leaving and entering
+  bool startsBelow;
+};
+} // namespace hermite
@@ -0,0 +1,463 @@
+/**
+ * @file
+ *
+ * Vectorized kernels for evaluating one segment at many times
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "hermite/thirdparty/simplevectors.hpp"
+
+#if !defined(HERMITE_NO_SIMD) && defined(__GNUC__) &&                         \
+    (defined(__x86_64__) || defined(__i386__))
+#define HERMITE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace hermite {
+namespace simd {
+using svector::Vector;
+
+/**
+ * @brief Fewest times in one segment that are worth handing to the kernels
+ *
+ * Shorter runs are evaluated one time at a time, since converting the segment
+ * and dispatching would cost more than it saves.
+ */
+const std::size_t MIN_RUN = 8;
+
+/**
+ * @brief Instruction set used by the kernels
+ */
+enum Level {
+  SCALAR, //!< Plain C++, used on every platform
+  SSE2,   //!< 2 doubles per instruction
+  AVX2,   //!< 4 doubles per instruction, with fused multiply-add
+  AVX512  //!< 8 doubles per instruction, with fused multiply-add
+};
+
+/**
+ * @brief Signature of a cubic polynomial kernel
+ *
+ * Evaluates c[0] + c[1]u + c[2]u^2 + c[3]u^3, where u = (t - t0) * invH, for
+ * every t in ts and writes the results to out.
+ */
+typedef void (*CubicKernel)(const double c[], const double t0,
+                            const double invH, const double ts[],
+                            const std::size_t n, double out[]);
+
+/**
+ * @brief Signature of a cubic polynomial kernel with float coefficients
+ *
+ * Same as CubicKernel, but u is rounded to float after it is found in double,
+ * and the polynomial is evaluated in float.
+ */
+typedef void (*FloatCubicKernel)(const float c[], const double t0,
+                                 const double invH, const double ts[],
+                                 const std::size_t n, float out[]);
+
+/**
+ * @brief Cubic polynomial kernel without intrinsics
+ *
+ * @see CubicKernel
+ */
+inline void cubicScalar(const double c[], const double t0, const double invH,
+                        const double ts[], const std::size_t n, double out[]) {
+  for (std::size_t i = 0; i < n; i++) {
+    const double u = (ts[i] - t0) * invH;
+    out[i] = c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+  }
+}
+
+/**
+ * @brief Cubic polynomial kernel with float coefficients without intrinsics
+ *
+ * @see FloatCubicKernel
+ */
+inline void cubicScalarFloat(const float c[], const double t0,
+                             const double invH, const double ts[],
+                             const std::size_t n, float out[]) {
+  for (std::size_t i = 0; i < n; i++) {
+    const float u = static_cast<float>((ts[i] - t0) * invH);
+    out[i] = c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+  }
+}
+
+#ifdef HERMITE_SIMD_X86
+/**
+ * @brief Cubic polynomial kernel using SSE2
+ *
+ * @see CubicKernel
+ */
+__attribute__((target("sse2"))) inline void
+cubicSse2(const double c[], const double t0, const double invH,
+          const double ts[], const std::size_t n, double out[]) {
+  const __m128d vt0 = _mm_set1_pd(t0);
+  const __m128d vinvH = _mm_set1_pd(invH);
+  const __m128d c0 = _mm_set1_pd(c[0]);
+  const __m128d c1 = _mm_set1_pd(c[1]);
+  const __m128d c2 = _mm_set1_pd(c[2]);
+  const __m128d c3 = _mm_set1_pd(c[3]);
+
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const __m128d u = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(ts + i), vt0), vinvH);
+    __m128d res = _mm_add_pd(_mm_mul_pd(c3, u), c2);
+    res = _mm_add_pd(_mm_mul_pd(res, u), c1);
+    res = _mm_add_pd(_mm_mul_pd(res, u), c0);
+    _mm_storeu_pd(out + i, res);
+  }
+
+  cubicScalar(c, t0, invH, ts + i, n - i, out + i);
+}
+
+/**
+ * @brief Cubic polynomial kernel using AVX2 and FMA
+ *
+ * @see CubicKernel
+ */
+__attribute__((target("avx2,fma"))) inline void
+cubicAvx2(const double c[], const double t0, const double invH,
+          const double ts[], const std::size_t n, double out[]) {
+  const __m256d vt0 = _mm256_set1_pd(t0);
+  const __m256d vinvH = _mm256_set1_pd(invH);
+  const __m256d c0 = _mm256_set1_pd(c[0]);
+  const __m256d c1 = _mm256_set1_pd(c[1]);
+  const __m256d c2 = _mm256_set1_pd(c[2]);
+  const __m256d c3 = _mm256_set1_pd(c[3]);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d u =
+        _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(ts + i), vt0), vinvH);
+    __m256d res = _mm256_fmadd_pd(c3, u, c2);
+    res = _mm256_fmadd_pd(res, u, c1);
+    res = _mm256_fmadd_pd(res, u, c0);
+    _mm256_storeu_pd(out + i, res);
+  }
+
+  cubicScalar(c, t0, invH, ts + i, n - i, out + i);
+}
+
+/**
+ * @brief Cubic polynomial kernel using AVX-512
+ *
+ * @see CubicKernel
+ */
+__attribute__((target("avx512f"))) inline void
+cubicAvx512(const double c[], const double t0, const double invH,
+            const double ts[], const std::size_t n, double out[]) {
+  const __m512d vt0 = _mm512_set1_pd(t0);
+  const __m512d vinvH = _mm512_set1_pd(invH);
+  const __m512d c0 = _mm512_set1_pd(c[0]);
+  const __m512d c1 = _mm512_set1_pd(c[1]);
+  const __m512d c2 = _mm512_set1_pd(c[2]);
+  const __m512d c3 = _mm512_set1_pd(c[3]);
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m512d u =
+        _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(ts + i), vt0), vinvH);
+    __m512d res = _mm512_fmadd_pd(c3, u, c2);
+    res = _mm512_fmadd_pd(res, u, c1);
+    res = _mm512_fmadd_pd(res, u, c0);
+    _mm512_storeu_pd(out + i, res);
+  }
+
+  // the remainder is done with a mask rather than falling back to scalar
+  if (i < n) {
+    const __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+    const __m512d u = _mm512_mul_pd(
+        _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, ts + i), vt0), vinvH);
+    __m512d res = _mm512_fmadd_pd(c3, u, c2);
+    res = _mm512_fmadd_pd(res, u, c1);
+    res = _mm512_fmadd_pd(res, u, c0);
+    _mm512_mask_storeu_pd(out + i, mask, res);
+  }
+}
+
+/**
+ * @brief Cubic polynomial kernel with float coefficients using SSE2
+ *
+ * @see FloatCubicKernel
+ */
+__attribute__((target("sse2"))) inline void
+cubicSse2Float(const float c[], const double t0, const double invH,
+               const double ts[], const std::size_t n, float out[]) {
+  const __m128d vt0 = _mm_set1_pd(t0);
+  const __m128d vinvH = _mm_set1_pd(invH);
+  const __m128 c0 = _mm_set1_ps(c[0]);
+  const __m128 c1 = _mm_set1_ps(c[1]);
+  const __m128 c2 = _mm_set1_ps(c[2]);
+  const __m128 c3 = _mm_set1_ps(c[3]);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128d lo = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(ts + i), vt0), vinvH);
+    const __m128d hi =
+        _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(ts + i + 2), vt0), vinvH);
+    const __m128 u = _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+    __m128 res = _mm_add_ps(_mm_mul_ps(c3, u), c2);
+    res = _mm_add_ps(_mm_mul_ps(res, u), c1);
+    res = _mm_add_ps(_mm_mul_ps(res, u), c0);
+    _mm_storeu_ps(out + i, res);
+  }
+
+  cubicScalarFloat(c, t0, invH, ts + i, n - i, out + i);
+}
+
+/**
+ * @brief Cubic polynomial kernel with float coefficients using AVX2 and FMA
+ *
+ * @see FloatCubicKernel
+ */
+__attribute__((target("avx2,fma"))) inline void
+cubicAvx2Float(const float c[], const double t0, const double invH,
+               const double ts[], const std::size_t n, float out[]) {
+  const __m256d vt0 = _mm256_set1_pd(t0);
+  const __m256d vinvH = _mm256_set1_pd(invH);
+  const __m256 c0 = _mm256_set1_ps(c[0]);
+  const __m256 c1 = _mm256_set1_ps(c[1]);
+  const __m256 c2 = _mm256_set1_ps(c[2]);
+  const __m256 c3 = _mm256_set1_ps(c[3]);
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256d lo =
+        _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(ts + i), vt0), vinvH);
+    const __m256d hi =
+        _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(ts + i + 4), vt0), vinvH);
+    const __m256 u = _mm256_insertf128_ps(
+        _mm256_castps128_ps256(_mm256_cvtpd_ps(lo)), _mm256_cvtpd_ps(hi), 1);
+    __m256 res = _mm256_fmadd_ps(c3, u, c2);
+    res = _mm256_fmadd_ps(res, u, c1);
+    res = _mm256_fmadd_ps(res, u, c0);
+    _mm256_storeu_ps(out + i, res);
+  }
+
+  cubicScalarFloat(c, t0, invH, ts + i, n - i, out + i);
+}
+
+/**
+ * @brief Cubic polynomial kernel with float coefficients using AVX-512
+ *
+ * @see FloatCubicKernel
+ */
+__attribute__((target("avx512f"))) inline void
+cubicAvx512Float(const float c[], const double t0, const double invH,
+                 const double ts[], const std::size_t n, float out[]) {
+  const __m512d vt0 = _mm512_set1_pd(t0);
+  const __m512d vinvH = _mm512_set1_pd(invH);
+  const __m512 c0 = _mm512_set1_ps(c[0]);
+  const __m512 c1 = _mm512_set1_ps(c[1]);
+  const __m512 c2 = _mm512_set1_ps(c[2]);
+  const __m512 c3 = _mm512_set1_ps(c[3]);
+
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512d lo =
+        _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(ts + i), vt0), vinvH);
+    const __m512d hi =
+        _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(ts + i + 8), vt0), vinvH);
+    // joins the two halves as doubles, since inserting 8 floats needs DQ. The
+    // zero-masked forms are used because the unmasked ones pass an undefined
+    // vector through, which GCC warns about in every file that includes this.
+    const __mmask8 all = 0xFF;
+    const __m256d lo32 = _mm256_castps_pd(_mm512_maskz_cvtpd_ps(all, lo));
+    const __m256d hi32 = _mm256_castps_pd(_mm512_maskz_cvtpd_ps(all, hi));
+    const __m512d joined = _mm512_maskz_insertf64x4(
+        all, _mm512_maskz_insertf64x4(all, _mm512_setzero_pd(), lo32, 0),
+        hi32, 1);
+    const __m512 u = _mm512_castpd_ps(joined);
+    __m512 res = _mm512_fmadd_ps(c3, u, c2);
+    res = _mm512_fmadd_ps(res, u, c1);
+    res = _mm512_fmadd_ps(res, u, c0);
+    _mm512_storeu_ps(out + i, res);
+  }
+
+  cubicScalarFloat(c, t0, invH, ts + i, n - i, out + i);
+}
+#endif
+
+/**
+ * @brief Checks whether a level can run on this CPU
+ *
+ * @param level Level to check
+ *
+ * @returns True if the CPU and the compiler support the level
+ */
+inline bool isSupported(const Level level) {
+#ifdef HERMITE_SIMD_X86
+  __builtin_cpu_init();
+#endif
+
+  switch (level) {
+  case SCALAR:
+    return true;
+#ifdef HERMITE_SIMD_X86
+  case SSE2:
+    return __builtin_cpu_supports("sse2");
+  case AVX2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case AVX512:
+    return __builtin_cpu_supports("avx512f");
+#endif
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Gets the best level supported by this CPU
+ *
+ * The CPU is only checked on the first call.
+ *
+ * @returns Best supported level
+ */
+inline Level getLevel() {
+  static const Level level = isSupported(AVX512) ? AVX512
+                             : isSupported(AVX2) ? AVX2
+                             : isSupported(SSE2) ? SSE2
+                                                 : SCALAR;
+  return level;
+}
+
+/**
+ * @brief Gets the cubic polynomial kernel of a certain level
+ *
+ * @param level Level of the kernel. Make sure that it is supported with
+ * isSupported() first.
+ *
+ * @returns The kernel, or the scalar kernel if the level was not compiled in
+ */
+inline CubicKernel getCubicKernel(const Level level) {
+  switch (level) {
+#ifdef HERMITE_SIMD_X86
+  case SSE2:
+    return cubicSse2;
+  case AVX2:
+    return cubicAvx2;
+  case AVX512:
+    return cubicAvx512;
+#endif
+  default:
+    return cubicScalar;
+  }
+}
+
+/**
+ * @brief Gets the cubic polynomial kernel with float coefficients of a certain
+ * level
+ *
+ * @param level Level of the kernel. Make sure that it is supported with
+ * isSupported() first.
+ *
+ * @returns The kernel, or the scalar kernel if the level was not compiled in
+ */
+inline FloatCubicKernel getFloatCubicKernel(const Level level) {
+  switch (level) {
+#ifdef HERMITE_SIMD_X86
+  case SSE2:
+    return cubicSse2Float;
+  case AVX2:
+    return cubicAvx2Float;
+  case AVX512:
+    return cubicAvx512Float;
+#endif
+  default:
+    return cubicScalarFloat;
+  }
+}
+
+/**
+ * @brief Evaluates a cubic polynomial at many times with the best kernel
+ *
+ * @param c Coefficients of the polynomial, lowest power first
+ * @param t0 Time where u = 0
+ * @param invH Reciprocal of the time where u = 1 minus t0
+ * @param ts Array of times
+ * @param n Number of times
+ * @param out Output array, must have room for n numbers
+ */
+inline void evalCubic(const double c[], const double t0, const double invH,
+                      const double ts[], const std::size_t n, double out[]) {
+  static const CubicKernel kernel = getCubicKernel(getLevel());
+  kernel(c, t0, invH, ts, n, out);
+}
+
+/**
+ * @brief Evaluates a cubic polynomial with float coefficients at many times
+ * with the best kernel
+ *
+ * The times and u are computed in double, and only the polynomial is
+ * evaluated in float, so each instruction evaluates twice as many times.
+ *
+ * @see evalCubic()
+ */
+inline void evalCubic(const float c[], const double t0, const double invH,
+                      const double ts[], const std::size_t n, float out[]) {
+  static const FloatCubicKernel kernel = getFloatCubicKernel(getLevel());
+  kernel(c, t0, invH, ts, n, out);
+}
+
+/**
+ * @brief Evaluates one segment in the power basis at many times
+ *
+ * The segment is given as coefficients of u = (t - t0) * invH, laid out as
+ * the output of HermiteSub::getPowerBasis(), so coefs[j * D + dim] is the
+ * coefficient of u^j in dimension dim. Each dimension is evaluated with
+ * evalCubic() in chunks and then copied into the output vectors.
+ *
+ * @tparam D Number of dimensions
+ * @tparam T Scalar type of the coefficients, either double or float
+ *
+ * @param coefs Coefficients of the segment
+ * @param t0 Time at the start of the segment
+ * @param invH Reciprocal of the length of the segment
+ * @param deriv Derivative to evaluate: 0 for position, 1 for velocity, and 2
+ * for acceleration
+ * @param ts Array of times
+ * @param n Number of times
+ * @param out Output array, must have room for n vectors
+ */
+template <std::size_t D, typename T>
+void evalSegment(const T coefs[], const double t0, const double invH,
+                 const int deriv, const double ts[], const std::size_t n,
+                 Vector<D> out[]) {
+  const std::size_t chunk = 128;
+  T buf[chunk];
+
+  for (std::size_t dim = 0; dim < D; dim++) {
+    const double b = coefs[D + dim];
+    const double c = coefs[2 * D + dim];
+    const double d = coefs[3 * D + dim];
+
+    // differentiate with respect to t, including the chain rule
+    T poly[4] = {coefs[dim], coefs[D + dim], coefs[2 * D + dim],
+                 coefs[3 * D + dim]};
+    if (deriv == 1) {
+      poly[0] = static_cast<T>(b * invH);
+      poly[1] = static_cast<T>(2 * c * invH);
+      poly[2] = static_cast<T>(3 * d * invH);
+      poly[3] = 0;
+    } else if (deriv == 2) {
+      poly[0] = static_cast<T>(2 * c * invH * invH);
+      poly[1] = static_cast<T>(6 * d * invH * invH);
+      poly[2] = 0;
+      poly[3] = 0;
+    }
+
+    for (std::size_t start = 0; start < n; start += chunk) {
+      const std::size_t count = std::min(chunk, n - start);
+      evalCubic(poly, t0, invH, ts + start, count, buf);
+      for (std::size_t i = 0; i < count; i++) {
+        out[start + i][dim] = buf[i];
+      }
+    }
+  }
+}
+} // namespace simd
+} // namespace hermite
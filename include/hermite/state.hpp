@@ -0,0 +1,27 @@
+/**
+ * @file
+ *
+ * Contains the state data structure
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "hermite/thirdparty/simplevectors.hpp"
+
+namespace hermite {
+using svector::Vector;
+
+/**
+ * @brief Position, velocity, and acceleration at a single time
+ *
+ * Returned by BaseInterpol::getState() so that all three can be calculated
+ * with one segment lookup.
+ */
+template <std::size_t D> struct State {
+  Vector<D> pos; //!< Position vector
+  Vector<D> vel; //!< Velocity vector
+  Vector<D> acc; //!< Acceleration vector
+};
+} // namespace hermite
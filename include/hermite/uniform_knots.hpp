@@ -0,0 +1,109 @@
+/**
+ * @file
+ *
+ * Constant time segment lookup for evenly spaced knots
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace hermite {
+/**
+ * @brief Default tolerance for detecting evenly spaced knots
+ *
+ * Relative to the spacing, so knots are treated as evenly spaced if each of
+ * them is within this fraction of the spacing from where it should be.
+ */
+const double UNIFORM_TOLERANCE = 1e-9;
+
+/**
+ * @brief Finds segments of evenly spaced knots in constant time
+ *
+ * If the knots t0, t1, ..., tn-1 are evenly spaced, then the segment containing
+ * a time t is floor((t - t0) / dt), clamped to the first and last segments.
+ * This is computed with a multiplication and two comparisons, with no branches
+ * or memory accesses.
+ *
+ * @note The index is nudged up by twice the tolerance, so a time that is on a
+ * knot, or within rounding of one, gets the later segment, like the binary
+ * search in splpos().
+ */
+class UniformKnots {
+public:
+  /**
+   * @brief Default constructor
+   *
+   * Initializes with no knots, which are not evenly spaced
+   */
+  UniformKnots()
+      : m_uniform{false}, m_t0{0}, m_invStep{0}, m_bias{0}, m_last{0} {}
+
+  /**
+   * @brief Constructor
+   *
+   * Checks whether the knots are evenly spaced, in linear time.
+   *
+   * @param ts Knot times, sorted with no repeats
+   * @param n Number of knots
+   * @param tol Tolerance, relative to the spacing. Must be positive.
+   *
+   * @note Fewer than 2 knots are not evenly spaced.
+   */
+  UniformKnots(const double ts[], const std::size_t n,
+               const double tol = UNIFORM_TOLERANCE)
+      : UniformKnots{} {
+    if (n < 2) {
+      return;
+    }
+
+    const double step = (ts[n - 1] - ts[0]) / static_cast<double>(n - 1);
+    for (std::size_t i = 1; i < n - 1; i++) {
+      const double expected = ts[0] + step * static_cast<double>(i);
+      if (std::fabs(ts[i] - expected) > tol * step) {
+        return;
+      }
+    }
+
+    m_uniform = true;
+    m_t0 = ts[0];
+    m_invStep = 1 / step;
+    m_bias = 2 * tol;
+    m_last = static_cast<double>(n - 2);
+  }
+
+  /**
+   * @brief Checks whether the knots are evenly spaced
+   *
+   * @returns True if getSegment() can be used
+   */
+  bool isUniform() const { return m_uniform; }
+
+  /**
+   * @brief Gets the segment containing a time
+   *
+   * @param t Time
+   *
+   * @returns Index of the lower knot of the segment, between 0 and n - 2
+   *
+   * @note Only valid if isUniform() is true.
+   */
+  int getSegment(const double t) const {
+    const double k = (t - m_t0) * m_invStep + m_bias;
+    // also catches NaN, which cannot be converted to int
+    if (!(k > 0)) {
+      return 0;
+    }
+    return static_cast<int>(std::min(k, m_last));
+  }
+
+private:
+  bool m_uniform;
+  double m_t0;
+  double m_invStep;
+  double m_bias;
+  double m_last;
+};
+} // namespace hermite
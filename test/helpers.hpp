@@ -0,0 +1,44 @@
+/**
+ * @file
+ *
+ * Checks shared by the tests
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+#include <hermite/base_spline.hpp>
+#include <hermite/state.hpp>
+
+namespace hermite {
+namespace test {
+/**
+ * Expects two splines to have the same position, velocity, and acceleration at
+ * times spaced 0.37 apart, from a second before the first time of the expected
+ * spline to a second after its last time
+ *
+ * @param spline Spline under test
+ * @param expected Reference spline, usually a Cubic or Hermite through the
+ * same waypoints
+ * @param tol Largest difference allowed in any component
+ */
+template <std::size_t D>
+void expectSameSpline(const BaseSpline<D> &spline,
+                      const BaseSpline<D> &expected, const double tol) {
+  const double start = expected.getLowestTime() - 1;
+  const double end = expected.getHighestTime() + 1;
+  for (double t = start; t <= end; t += 0.37) {
+    const State<D> a = spline.getState(t);
+    const State<D> e = expected.getState(t);
+    for (std::size_t dim = 0; dim < D; dim++) {
+      ASSERT_NEAR(a.pos[dim], e.pos[dim], tol) << "at t = " << t;
+      ASSERT_NEAR(a.vel[dim], e.vel[dim], tol) << "at t = " << t;
+      ASSERT_NEAR(a.acc[dim], e.acc[dim], tol) << "at t = " << t;
+    }
+  }
+}
+} // namespace test
+} // namespace hermite
@@ -0,0 +1,49 @@
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "hermite/bounding_box.hpp"
+
+using namespace hermite;
+
+TEST(BoundingBox, EmptyTest) {
+  const BoundingBox<2> empty;
+  EXPECT_TRUE(empty.isEmpty());
+  EXPECT_FALSE(empty.contains({0, 0}));
+  EXPECT_FALSE(empty.intersects(empty));
+
+  const BoundingBox<2> box{{0, 0}, {1, 2}};
+  const BoundingBox<2> merged = BoundingBox<2>::merge(empty, box);
+  EXPECT_EQ(merged.lower, box.lower);
+  EXPECT_EQ(merged.upper, box.upper);
+}
+
+TEST(BoundingBox, QueryTest) {
+  const BoundingBox<2> box{{0, 0}, {1, 2}};
+  EXPECT_FALSE(box.isEmpty());
+  EXPECT_TRUE(box.contains({0.5, 2}));
+  EXPECT_FALSE(box.contains({1.5, 1}));
+
+  EXPECT_TRUE(box.intersects({{1, 1}, {3, 3}}));
+  EXPECT_FALSE(box.intersects({{1.1, 1}, {3, 3}}));
+  EXPECT_FALSE(box.intersects({{0, 2.5}, {1, 3}}));
+
+  EXPECT_EQ(box.getSquaredDistance({0.5, 1}), 0);
+  EXPECT_DOUBLE_EQ(box.getSquaredDistance({4, 6}), 25);
+  EXPECT_DOUBLE_EQ(box.getSquaredDistance({-2, 1}), 4);
+
+  const BoundingBox<2> merged =
+      BoundingBox<2>::merge(box, BoundingBox<2>{{-1, 1}, {0.5, 3}});
+  EXPECT_EQ(merged.lower, (Vector<2>{-1, 0}));
+  EXPECT_EQ(merged.upper, (Vector<2>{1, 3}));
+}
+
+TEST(BoundingBox, BoxDistanceTest) {
+  const BoundingBox<2> box{{0, 0}, {1, 2}};
+  EXPECT_EQ(box.getSquaredDistance(BoundingBox<2>{{0.5, 1}, {3, 3}}), 0);
+  EXPECT_DOUBLE_EQ(box.getSquaredDistance(BoundingBox<2>{{4, 6}, {5, 7}}), 25);
+  EXPECT_DOUBLE_EQ(box.getSquaredDistance(BoundingBox<2>{{-3, 1}, {-2, 5}}),
+                   4);
+  EXPECT_EQ(box.getSquaredDistance(BoundingBox<2>{}),
+            std::numeric_limits<double>::infinity());
+}
@@ -0,0 +1,169 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hermite/compiled.hpp"
+#include "hermite/cubic.hpp"
+#include "hermite/hermite.hpp"
+
+using namespace hermite;
+
+namespace {
+template <std::size_t D>
+void expectSame(const BaseSpline<D> &expected, const CompiledSpline<D> &res,
+                const double t) {
+  for (std::size_t dim = 0; dim < D; dim++) {
+    EXPECT_NEAR(res.getPos(t)[dim], expected.getPos(t)[dim], 0.000001);
+    EXPECT_NEAR(res.getVel(t)[dim], expected.getVel(t)[dim], 0.000001);
+    EXPECT_NEAR(res.getAcc(t)[dim], expected.getAcc(t)[dim], 0.000001);
+  }
+}
+} // namespace
+
+TEST(CompiledSpline, EmptyTest) {
+  CompiledSpline<2> spl;
+  EXPECT_TRUE(spl.getPos(1).isZero());
+  EXPECT_TRUE(spl.getVel(1).isZero());
+  EXPECT_TRUE(spl.getAcc(1).isZero());
+  EXPECT_NEAR(spl.getLowestTime(), 0, 0.000001);
+  EXPECT_NEAR(spl.getHighestTime(), 0, 0.000001);
+}
+
+TEST(CompiledSpline, OneKnotTest) {
+  Hermite<1> h;
+  h.insert({2, {3}, {1}});
+
+  auto spl = h.compile();
+  EXPECT_TRUE(spl.getPos(2).isZero());
+  EXPECT_NEAR(spl.getLowestTime(), 2, 0.000001);
+  EXPECT_NEAR(spl.getHighestTime(), 2, 0.000001);
+}
+
+TEST(CompiledSpline, HermiteTest) {
+  Hermite<2> h;
+  h.insert({-3, {-2, 1}, {0, 1}});
+  h.insert({0, {2, 0}, {1, -1}});
+  h.insert({2, {3, 4}, {2, 0}});
+  h.insert({6, {0, 1}, {0, 2}});
+
+  auto spl = h.compile();
+  EXPECT_NEAR(spl.getLowestTime(), -3, 0.000001);
+  EXPECT_NEAR(spl.getHighestTime(), 6, 0.000001);
+
+  for (double t = -4; t <= 7; t += 0.25) {
+    expectSame(h, spl, t);
+  }
+}
+
+TEST(CompiledSpline, CubicTest) {
+  Pose<2> p1{0, {1, 0}, {2, 1}};
+  Pose<2> p2{2, {2, 3}, {0, 0}};
+  Pose<2> p3{5, {0, -1}, {0, 0}};
+  Pose<2> p4{8, {0, 2}, {1, 0}};
+
+  std::vector<Pose<2>> poses{p1, p2, p3, p4};
+  Cubic<2> cub{poses};
+
+  auto spl = cub.compile();
+  for (double t = -1; t <= 9; t += 0.25) {
+    expectSame(cub, spl, t);
+  }
+
+  EXPECT_NEAR(spl.getLength(0.01), cub.getLength(0.01), 0.000001);
+}
+
+TEST(CompiledSpline, BatchAndCursorTest) {
+  Hermite<1> h;
+  for (int i = 0; i < 10; i++) {
+    h.insert({i * 1.0, {i % 2 * 1.0}, {i % 3 * 1.0}});
+  }
+  auto spl = h.compile();
+
+  std::vector<double> ts;
+  for (double t = -1; t <= 10; t += 0.1) {
+    ts.push_back(t);
+  }
+  ts.push_back(3);
+
+  std::vector<Vector<1>> out(ts.size());
+  spl.getVelBatch(ts.data(), ts.size(), out.data());
+
+  SplineCursor<CompiledSpline<1>> cur{spl};
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    EXPECT_NEAR(out[i][0], h.getVel(ts[i])[0], 0.000001);
+    EXPECT_NEAR(cur.getPos(ts[i])[0], h.getPos(ts[i])[0], 0.000001);
+  }
+}
+
+TEST(CompiledSpline, StateTest) {
+  Hermite<2> h;
+  h.insert({-3, {-2, 1}, {0, 1}});
+  h.insert({0, {2, 0}, {1, -1}});
+  h.insert({2, {3, 4}, {2, 0}});
+  auto spl = h.compile();
+
+  std::vector<double> ts{-4, -3, -1, 0, 1, 2, 3};
+  std::vector<State<2>> batch(ts.size());
+  spl.getStateBatch(ts.data(), ts.size(), batch.data());
+
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    auto res = h.getState(ts[i]);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(batch[i].pos[dim], res.pos[dim], 0.000001);
+      EXPECT_NEAR(batch[i].vel[dim], res.vel[dim], 0.000001);
+      EXPECT_NEAR(batch[i].acc[dim], res.acc[dim], 0.000001);
+    }
+  }
+}
+
+TEST(CompiledSpline, FloatTest) {
+  // large absolute times lose no precision, since u is found in double
+  const double start = 1e8;
+  std::vector<Pose<2>> poses;
+  for (int i = 0; i < 20; i++) {
+    poses.push_back(Pose<2>{start + i * 0.5,
+                            {std::sin(i * 0.3), i % 3 * 1.0},
+                            {0, 0}});
+  }
+  Cubic<2> cub{poses};
+
+  const CompiledSpline<2> spl = cub.compile();
+  const CompiledSpline<2, float> single = cub.compile<float>();
+  EXPECT_EQ(single.getCoefficients().size(), spl.getCoefficients().size());
+
+  std::vector<double> ts;
+  for (double t = start - 1; t <= start + 11; t += 0.01) {
+    ts.push_back(t);
+  }
+
+  std::vector<Vector<2>> batch(ts.size());
+  single.getPosBatch(ts.data(), ts.size(), batch.data());
+
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    const auto expected = spl.getState(ts[i]);
+    const auto res = single.getState(ts[i]);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(res.pos[dim], expected.pos[dim], 0.0001);
+      EXPECT_NEAR(res.vel[dim], expected.vel[dim], 0.0001);
+      EXPECT_NEAR(res.acc[dim], expected.acc[dim], 0.001);
+      EXPECT_NEAR(batch[i][dim], expected.pos[dim], 0.0001);
+    }
+  }
+}
+
+TEST(CompiledSpline, FloatHermiteTest) {
+  Hermite<2> h;
+  h.insert({-3, {-2, 1}, {0, 1}});
+  h.insert({0, {2, 0}, {1, -1}});
+  h.insert({2, {3, 4}, {2, 0}});
+
+  const auto spl = h.compile<float>();
+  SplineCursor<CompiledSpline<2, float>> cur{spl};
+  for (double t = -4; t <= 3; t += 0.25) {
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(cur.getPos(t)[dim], h.getPos(t)[dim], 0.0001);
+      EXPECT_NEAR(spl.getVel(t)[dim], h.getVel(t)[dim], 0.0001);
+    }
+  }
+}
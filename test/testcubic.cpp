@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -318,6 +322,175 @@ TEST(Cubic, MaxAccTest) {
   EXPECT_NEAR(spl.getMaxAcceleration(0.001), 2.079, 0.01);
 }
 
+TEST(Cubic, ExactMaxTest) {
+  Pose<2> p1{0, {1, 0}, {2, 1}};
+  Pose<2> p2{2, {2, 3}, {0, 0}};
+  Pose<2> p3{5, {0, -1}, {0, 0}};
+  Pose<2> p4{8, {0, 2}, {1, 1e31}};
+
+  std::vector<Pose<2>> poses{p1, p2, p3, p4};
+  Cubic<2> spl{poses};
+
+  EXPECT_NEAR(spl.getMaxDistance(), spl.getMaxDistance(0.00001), 0.0001);
+  EXPECT_NEAR(spl.getMaxSpeed(), spl.getMaxSpeed(0.00001), 0.0001);
+  EXPECT_NEAR(spl.getMaxAcceleration(), spl.getMaxAcceleration(0.00001),
+              0.0001);
+
+  // same as the compiled spline
+  const auto compiled = spl.compile();
+  EXPECT_NEAR(compiled.getMaxSpeed(), spl.getMaxSpeed(), 1e-12);
+  EXPECT_NEAR(compiled.getMaxAcceleration(), spl.getMaxAcceleration(), 1e-12);
+}
+
+TEST(Cubic, RangeMaxTest) {
+  std::vector<Pose<2>> poses;
+  for (int i = 0; i < 20; i++) {
+    poses.push_back({i * 0.4, {std::sin(i * 0.9), i * 0.2}, {0, 0}});
+  }
+  Cubic<2> spl{poses};
+
+  double speed = 0;
+  double acc = 0;
+  for (int i = 0; i <= 20000; i++) {
+    const double t = 1.1 + 3.0 * i / 20000;
+    speed = std::max(speed, magn(spl.getVel(t)));
+    acc = std::max(acc, magn(spl.getAcc(t)));
+  }
+
+  EXPECT_NEAR(spl.getMaxSpeed(1.1, 4.1), speed, 1e-6);
+  EXPECT_NEAR(spl.getMaxAcceleration(4.1, 1.1), acc, 1e-6);
+  EXPECT_NEAR(spl.getMaxDistance(-1, 10), spl.getMaxDistance(), 1e-12);
+}
+
+TEST(Cubic, BoundingBoxTest) {
+  std::vector<Pose<2>> poses;
+  for (int i = 0; i < 10; i++) {
+    poses.push_back({i * 0.4, {std::sin(i * 0.9), i * 0.2}, {0, 0}});
+  }
+  Cubic<2> spl{poses};
+
+  const BoundingBox<2> box = spl.getBoundingBox();
+  double lowest = 0;
+  double highest = 0;
+  for (int i = 0; i <= 20000; i++) {
+    const Vector<2> pos = spl.getPos(3.6 * i / 20000);
+    EXPECT_LT(box.getSquaredDistance(pos), 1e-24);
+    lowest = std::min(lowest, pos[0]);
+    highest = std::max(highest, pos[0]);
+  }
+  EXPECT_NEAR(box.lower[0], lowest, 1e-6);
+  EXPECT_NEAR(box.upper[0], highest, 1e-6);
+
+  EXPECT_EQ(spl.getBoundingBoxes().size(), 9);
+  EXPECT_TRUE(box.contains(spl.getBoundingBox(1.3, 0.5).lower));
+}
+
+TEST(Cubic, ClosestTimeTest) {
+  std::vector<Pose<2>> poses;
+  for (int i = 0; i < 20; i++) {
+    poses.push_back({i * 0.4, {std::sin(i * 0.9), i * 0.2}, {0, 0}});
+  }
+  Cubic<2> spl{poses};
+
+  const Vector<2> point{0.7, 1.3};
+  double best = 0;
+  double bestDist = magn(spl.getPos(0) - point);
+  for (int i = 0; i <= 100000; i++) {
+    const double t = 7.6 * i / 100000;
+    const double dist = magn(spl.getPos(t) - point);
+    if (dist < bestDist) {
+      best = t;
+      bestDist = dist;
+    }
+  }
+
+  EXPECT_NEAR(spl.getClosestTime(point), best, 1e-3);
+  EXPECT_NEAR(spl.getClosestTime(point, 7), spl.getClosestTime(point), 1e-9);
+  EXPECT_NEAR(spl.getClosestTime(spl.getPos(2.9)), 2.9, 1e-6);
+}
+
+TEST(Cubic, ExactLengthTest) {
+  Pose<2> p1{0, {1, 0}, {2, 1}};
+  Pose<2> p2{2, {2, 3}, {0, 0}};
+  Pose<2> p3{5, {0, -1}, {0, 0}};
+  Pose<2> p4{8, {0, 2}, {1, 1e31}};
+
+  std::vector<Pose<2>> poses{p1, p2, p3, p4};
+  Cubic<2> spl{poses};
+
+  EXPECT_NEAR(spl.getLength(), spl.getLength(0.00001), 0.0001);
+  EXPECT_NEAR(spl.getLength(1, 3) + spl.getLength(3, 7), spl.getLength(1, 7),
+              1e-12);
+
+  // rebuilding clears the cache
+  poses[1].setPos({4, 3});
+  Cubic<2> expected{poses};
+  spl.rebuild(poses);
+  EXPECT_NEAR(spl.getLength(), expected.getLength(), 1e-12);
+
+  Cubic<2> empty;
+  EXPECT_EQ(empty.getLength(), 0);
+}
+
+TEST(Cubic, ConcurrentLengthTest) {
+  std::vector<Pose<2>> poses;
+  for (int i = 0; i < 200; i++) {
+    poses.push_back({i * 0.5, {i % 3 * 1.0, i % 5 * -0.5}, {0, 0}});
+  }
+  const Cubic<2> spl{poses};
+  const Cubic<2> expected{poses};
+  const double length = expected.getLength();
+  const double maxSpeed = expected.getMaxSpeed();
+
+  // the first queries measure the segments from several threads at once
+  std::vector<double> lengths(4);
+  std::vector<double> maxSpeeds(4);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < 4; i++) {
+    threads.emplace_back([&spl, &lengths, &maxSpeeds, i]() {
+      lengths[i] = spl.getLength();
+      maxSpeeds[i] = spl.getMaxSpeed();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (std::size_t i = 0; i < 4; i++) {
+    EXPECT_EQ(lengths[i], length);
+    EXPECT_EQ(maxSpeeds[i], maxSpeed);
+  }
+}
+
+TEST(Cubic, TimeAtDistanceTest) {
+  std::vector<Pose<2>> poses;
+  for (int i = 0; i < 20; i++) {
+    poses.push_back({i * 0.4, {std::sin(i * 0.9), i * 0.2}, {0, 0}});
+  }
+  Cubic<2> spl{poses};
+
+  const double length = spl.getLength();
+  Cubic<2>::DistanceCursor cursor{spl};
+  for (int i = 0; i <= 200; i++) {
+    const double dist = length * i / 200;
+    const double t = spl.getTimeAtDistance(dist);
+    EXPECT_NEAR(spl.getLength(0, t), dist, 1e-9);
+    EXPECT_NEAR(cursor.getTime(dist), t, 1e-9);
+  }
+  for (int i = 200; i >= 0; i -= 7) {
+    const double dist = length * i / 200;
+    EXPECT_NEAR(cursor.getTime(dist), spl.getTimeAtDistance(dist), 1e-9);
+  }
+
+  // rebuilding is noticed
+  poses[3].setPos({5, 5});
+  spl.rebuild(poses);
+  const Vector<2> pos = cursor.getPos(length / 4);
+  const Vector<2> expected = spl.getPosAtDistance(length / 4);
+  EXPECT_NEAR(pos[0], expected[0], 1e-9);
+  EXPECT_NEAR(pos[1], expected[1], 1e-9);
+}
+
 TEST(Cubic, ArcLengthTest) {
   Pose<1> p1{0, {1}, {2}};
   Pose<1> p2{2, {2}, {0}};
@@ -379,3 +552,253 @@ TEST(Cubic, AssignTest) {
   EXPECT_NEAR(y3[0], 0, 0.01);
   EXPECT_NEAR(y4[0], -0.392, 0.01);
 }
+
+TEST(Cubic, BatchMatchesSingleTest) {
+  Pose<2> p1{0, {1, 0}, {2, 1}};
+  Pose<2> p2{2, {2, 3}, {0, 0}};
+  Pose<2> p3{5, {0, -1}, {0, 0}};
+  Pose<2> p4{8, {0, 2}, {1, 0}};
+
+  std::vector<Pose<2>> poses{p1, p2, p3, p4};
+  Cubic<2> spl{poses};
+
+  // sorted, repeated, out of bounds, and one backwards jump
+  std::vector<double> ts{-1, 0, 1, 1, 2, 4, 5, 7.5, 8, 10, 0.5, 6};
+  std::vector<Vector<2>> pos(ts.size());
+  std::vector<Vector<2>> vel(ts.size());
+  std::vector<Vector<2>> acc(ts.size());
+
+  spl.getPosBatch(ts.data(), ts.size(), pos.data());
+  spl.getVelBatch(ts.data(), ts.size(), vel.data());
+  spl.getAccBatch(ts.data(), ts.size(), acc.data());
+
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(pos[i][dim], spl.getPos(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(vel[i][dim], spl.getVel(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(acc[i][dim], spl.getAcc(ts[i])[dim], 0.000001);
+    }
+  }
+}
+
+TEST(Cubic, BatchEmptyTest) {
+  Cubic<1> spl;
+
+  double ts[2] = {-3, 1};
+  Vector<1> out[2] = {{4}, {5}};
+  spl.getVelBatch(ts, 2, out);
+
+  EXPECT_TRUE(out[0].isZero());
+  EXPECT_TRUE(out[1].isZero());
+}
+
+TEST(Cubic, CursorMatchesSingleTest) {
+  std::vector<Pose<2>> poses;
+  for (int i = 0; i < 20; i++) {
+    poses.push_back({i * 0.5, {i * 1.0, -i * 2.0}, {1, 0}});
+  }
+  Cubic<2> spl{poses};
+
+  SplineCursor<Cubic<2>> cur{spl};
+
+  // forward steps, then big jumps in both directions
+  std::vector<double> ts;
+  for (double t = -0.5; t <= 10; t += 0.05) {
+    ts.push_back(t);
+  }
+  ts.push_back(1);
+  ts.push_back(9);
+  ts.push_back(0.2);
+
+  for (const double t : ts) {
+    auto pos = cur.getPos(t);
+    auto vel = cur.getVel(t);
+    auto acc = cur.getAcc(t);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(pos[dim], spl.getPos(t)[dim], 0.000001);
+      EXPECT_NEAR(vel[dim], spl.getVel(t)[dim], 0.000001);
+      EXPECT_NEAR(acc[dim], spl.getAcc(t)[dim], 0.000001);
+    }
+  }
+}
+
+TEST(Cubic, CursorEmptyTest) {
+  Cubic<1> spl;
+  Cubic<1>::Cursor cur{spl};
+  EXPECT_TRUE(cur.getPos(1).isZero());
+}
+
+TEST(Cubic, StateTest) {
+  Pose<2> p1{0, {1, 0}, {2, 1}};
+  Pose<2> p2{2, {2, 3}, {0, 0}};
+  Pose<2> p3{5, {0, -1}, {0, 0}};
+  Pose<2> p4{8, {0, 2}, {1, 0}};
+
+  std::vector<Pose<2>> poses{p1, p2, p3, p4};
+  Cubic<2> spl{poses};
+
+  std::vector<double> ts{-1, 0, 1, 2, 4, 5, 7.5, 8, 10, 0.5};
+  std::vector<State<2>> batch(ts.size());
+  spl.getStateBatch(ts.data(), ts.size(), batch.data());
+
+  Cubic<2>::Cursor cur{spl};
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    auto res = spl.getState(ts[i]);
+    auto curRes = cur.getState(ts[i]);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(res.pos[dim], spl.getPos(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(res.vel[dim], spl.getVel(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(res.acc[dim], spl.getAcc(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(batch[i].pos[dim], res.pos[dim], 0.000001);
+      EXPECT_NEAR(curRes.vel[dim], res.vel[dim], 0.000001);
+    }
+  }
+}
+
+TEST(Cubic, DenseBatchTest) {
+  Pose<3> p1{0, {1, 0, 3}, {2, 1, 0}};
+  Pose<3> p2{2, {2, 3, 1}, {0, 0, 0}};
+  Pose<3> p3{5, {0, -1, 2}, {0, 0, 0}};
+  Pose<3> p4{8, {0, 2, 0}, {1, 0, 1}};
+
+  std::vector<Pose<3>> poses{p1, p2, p3, p4};
+  Cubic<3> spl{poses};
+  auto compiled = spl.compile();
+
+  std::vector<double> ts;
+  for (double t = -0.5; t <= 8.5; t += 0.001) {
+    ts.push_back(t);
+  }
+
+  std::vector<Vector<3>> vel(ts.size());
+  std::vector<Vector<3>> compiledVel(ts.size());
+  spl.getVelBatch(ts.data(), ts.size(), vel.data());
+  compiled.getVelBatch(ts.data(), ts.size(), compiledVel.data());
+
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    for (std::size_t dim = 0; dim < 3; dim++) {
+      EXPECT_NEAR(vel[i][dim], spl.getVel(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(compiledVel[i][dim], spl.getVel(ts[i])[dim], 0.000001);
+    }
+  }
+}
+
+TEST(Cubic, UniformTest) {
+  std::vector<Pose<2>> waypoints;
+  for (int i = 0; i <= 20; i++) {
+    const double t = 0.1 * i - 1;
+    waypoints.push_back({t, {t * t, -t}, {2 * t, -1}});
+  }
+
+  Cubic<2> cub{waypoints};
+  EXPECT_TRUE(cub.isUniform());
+
+  // nudge one knot so that the binary search is used
+  auto uneven = waypoints;
+  uneven[7].setTime(uneven[7].getTime() + 0.01);
+  EXPECT_FALSE(Cubic<2>{uneven}.isUniform());
+
+  // reference values from the low-level binary search
+  std::vector<double> xs;
+  std::vector<double> ys;
+  for (const auto &p : waypoints) {
+    xs.push_back(p.getTime());
+    ys.push_back(p.getPos()[0]);
+  }
+  std::vector<double> y2s(xs.size());
+  spline(xs.data(), ys.data(), static_cast<int>(xs.size()), -2, 2, y2s.data());
+
+  std::vector<double> ts;
+  for (double t = -1.5; t <= 1.5; t += 0.0125) {
+    ts.push_back(t);
+  }
+  for (const auto &p : waypoints) {
+    ts.push_back(p.getTime());
+  }
+
+  const auto compiled = cub.compile();
+  EXPECT_TRUE(compiled.isUniform());
+  for (const double t : ts) {
+    double pos;
+    double vel;
+    double acc;
+    const int n = static_cast<int>(xs.size());
+    splpos(xs.data(), ys.data(), y2s.data(), n, t, &pos);
+    splvel(xs.data(), ys.data(), y2s.data(), n, t, &vel);
+    splacc(xs.data(), ys.data(), y2s.data(), n, t, &acc);
+
+    EXPECT_NEAR(cub.getPos(t)[0], pos, 1e-9);
+    EXPECT_NEAR(cub.getVel(t)[0], vel, 1e-9);
+    EXPECT_NEAR(cub.getAcc(t)[0], acc, 1e-9);
+    EXPECT_NEAR(compiled.getPos(t)[0], pos, 1e-9);
+    EXPECT_NEAR(compiled.getAcc(t)[0], acc, 1e-9);
+  }
+}
+
+TEST(Cubic, ResolveTest) {
+  std::vector<Pose<2>> waypoints{{0, {1, 0}, {2, 1}},
+                                 {1.5, {2, 3}, {0, 0}},
+                                 {2, {4, 1}, {0, 0}},
+                                 {5, {0, -1}, {-1, 0}}};
+  Cubic<2> cub{waypoints};
+
+  std::vector<Vector<2>> positions{{3, 1}, {-2, 0}, {1, 1}, {4, 2}};
+  Vector<2> startVel{0, 1e31};
+  Vector<2> endVel{1, -2};
+  EXPECT_TRUE(cub.resolve(positions, startVel, endVel));
+
+  std::vector<Pose<2>> expectedPoses;
+  for (std::size_t i = 0; i < waypoints.size(); i++) {
+    expectedPoses.push_back({waypoints[i].getTime(), positions[i], {0, 0}});
+  }
+  expectedPoses.front().setVel(startVel);
+  expectedPoses.back().setVel(endVel);
+  Cubic<2> expected{expectedPoses};
+
+  for (double t = -1; t <= 6; t += 0.1) {
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(cub.getPos(t)[dim], expected.getPos(t)[dim], 1e-9);
+      EXPECT_NEAR(cub.getAcc(t)[dim], expected.getAcc(t)[dim], 1e-9);
+    }
+  }
+
+  const auto all = cub.getAllWaypoints();
+  EXPECT_NEAR(all[1].getPos()[0], -2, 0.001);
+  EXPECT_NEAR(all[3].getVel()[1], -2, 0.001);
+
+  // wrong number of positions
+  positions.pop_back();
+  EXPECT_FALSE(cub.resolve(positions, startVel, endVel));
+  EXPECT_NEAR(cub.getAllWaypoints()[1].getPos()[0], -2, 0.001);
+
+  Cubic<2> empty;
+  EXPECT_FALSE(empty.resolve({}, startVel, endVel));
+}
+
+TEST(Cubic, FloatTest) {
+  // large absolute times, which float could not hold to a millisecond
+  const double start = 1e7;
+  std::vector<Pose<2>> poses;
+  std::vector<Pose<2, float>> singlePoses;
+  for (int i = 0; i < 6; i++) {
+    const double t = start + i * 0.5;
+    const Vector<2> pos{static_cast<double>(i % 3), -0.1 * i};
+    poses.push_back({t, pos, {0, 0}});
+    singlePoses.push_back({t, pos, {0, 0}});
+  }
+  poses.front().setVel({1, 1e31});
+  singlePoses.front().setVel({1, 1e31});
+
+  const Cubic<2> cub{poses};
+  const Cubic<2, float> single{singlePoses};
+
+  for (double t = start - 0.5; t <= start + 3; t += 0.01) {
+    const auto expected = cub.getState(t);
+    const auto res = single.getState(t);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(res.pos[dim], expected.pos[dim], 1e-5);
+      EXPECT_NEAR(res.vel[dim], expected.vel[dim], 1e-5);
+      EXPECT_NEAR(res.acc[dim], expected.acc[dim], 1e-4);
+    }
+  }
+}
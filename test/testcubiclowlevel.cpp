@@ -1,6 +1,13 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "hermite/cubic/cubic_impl.hpp"
+#include "hermite/cubic/cubic_parallel.hpp"
 #include "hermite/cubic/cubic_vec.hpp"
 
 using namespace hermite;
@@ -183,3 +190,235 @@ TEST(CubicVec, AssignTest) {
   EXPECT_NEAR(y3[0], 0.193, 0.01);
   EXPECT_NEAR(y4[0], 0.785, 0.01);
 }
+
+TEST(CubicImpl, HuntTest) {
+  double t[6] = {0, 2, 5, 8, 9, 12};
+  int n = 6;
+
+  // every guess should give the same segment as a bisection
+  double xs[9] = {-3, 0, 1, 2, 4.5, 8, 8.5, 12, 20};
+  int expected[9] = {0, 0, 0, 1, 1, 3, 3, 4, 4};
+  for (int i = 0; i < 9; i++) {
+    for (int guess = -1; guess <= n; guess++) {
+      EXPECT_EQ(splhunt(t, n, xs[i], guess), expected[i]);
+    }
+  }
+}
+
+TEST(CubicImpl, StateTest) {
+  double t[4] = {0, 2, 5, 8};
+  double y[4] = {1, 2, 0, 0};
+  int n = 4;
+  double ydd[4];
+
+  spline(t, y, n, 2, 1, ydd);
+
+  double xs[5] = {-1, 1, 4, 5, 7.5};
+  for (int i = 0; i < 5; i++) {
+    double pos, vel, acc, y0, yd, ydd2;
+    EXPECT_TRUE(splstate(t, y, ydd, n, xs[i], &pos, &vel, &acc));
+    ASSERT_TRUE(splpos(t, y, ydd, n, xs[i], &y0));
+    ASSERT_TRUE(splvel(t, y, ydd, n, xs[i], &yd));
+    ASSERT_TRUE(splacc(t, y, ydd, n, xs[i], &ydd2));
+
+    EXPECT_NEAR(pos, y0, 0.000001);
+    EXPECT_NEAR(vel, yd, 0.000001);
+    EXPECT_NEAR(acc, ydd2, 0.000001);
+  }
+}
+
+TEST(CubicImpl, SegmentTest) {
+  double t[4] = {0, 2, 5, 8};
+  double y[4] = {1, 2, 0, 0};
+  double z[4] = {-1, 3, 2, 0};
+  int n = 4;
+  double ydd[4];
+  double zdd[4];
+
+  spline(t, y, n, 2, 1, ydd);
+  spline(t, z, n, 0, 0, zdd);
+
+  double xs[6] = {-1, 1, 2, 4, 5, 7.5};
+  int expected[6] = {0, 0, 1, 1, 2, 2};
+  for (int i = 0; i < 6; i++) {
+    // one search, shared by both dimensions
+    SplineSegment seg{};
+    ASSERT_TRUE(splseg(t, n, xs[i], &seg));
+    EXPECT_EQ(seg.klo, expected[i]);
+    EXPECT_EQ(seg.khi, expected[i] + 1);
+
+    SplineSegment known{};
+    ASSERT_TRUE(splsegat(t, expected[i], xs[i], &known));
+    EXPECT_NEAR(known.a, seg.a, 0.000001);
+    EXPECT_NEAR(known.b, seg.b, 0.000001);
+
+    double y0, yd, ydd2, z0, zd, zdd2;
+    ASSERT_TRUE(splpos(t, y, ydd, n, xs[i], &y0));
+    ASSERT_TRUE(splvel(t, y, ydd, n, xs[i], &yd));
+    ASSERT_TRUE(splacc(t, y, ydd, n, xs[i], &ydd2));
+    ASSERT_TRUE(splpos(t, z, zdd, n, xs[i], &z0));
+    ASSERT_TRUE(splvel(t, z, zdd, n, xs[i], &zd));
+    ASSERT_TRUE(splacc(t, z, zdd, n, xs[i], &zdd2));
+
+    EXPECT_NEAR(splpos(y, ydd, seg), y0, 0.000001);
+    EXPECT_NEAR(splvel(y, ydd, seg), yd, 0.000001);
+    EXPECT_NEAR(splacc(ydd, seg), ydd2, 0.000001);
+    EXPECT_NEAR(splpos(z, zdd, seg), z0, 0.000001);
+    EXPECT_NEAR(splvel(z, zdd, seg), zd, 0.000001);
+    EXPECT_NEAR(splacc(zdd, seg), zdd2, 0.000001);
+
+    double pos, vel, acc;
+    splstate(z, zdd, seg, &pos, &vel, &acc);
+    EXPECT_NEAR(pos, z0, 0.000001);
+    EXPECT_NEAR(vel, zd, 0.000001);
+    EXPECT_NEAR(acc, zdd2, 0.000001);
+  }
+
+  double same[2] = {1, 1};
+  SplineSegment seg{};
+  EXPECT_FALSE(splseg(same, 2, 1, &seg));
+}
+
+TEST(CubicImpl, SolveTest) {
+  const int m = 3;
+  for (int n = 2; n <= 12; n += 5) {
+    std::vector<double> t(n);
+    std::vector<double> y(n * m);
+    for (int i = 0; i < n; i++) {
+      t[i] = 0.5 * i + 0.1 * (i % 3);
+      for (int j = 0; j < m; j++) {
+        y[i * m + j] = (j + 1) * t[i] * t[i] - (i % 2) * j;
+      }
+    }
+    double yp1[m] = {2, -1, 0.5};
+    double ypn[m] = {-3, 0, 4};
+
+    std::vector<double> fac(4 * n);
+    std::vector<double> y2(n * m);
+    splfactor(t.data(), n, fac.data());
+    splsolve(fac.data(), y.data(), n, m, yp1, ypn, y2.data());
+
+    // each spline should match solving it on its own
+    for (int j = 0; j < m; j++) {
+      std::vector<double> yj(n);
+      std::vector<double> y2j(n);
+      for (int i = 0; i < n; i++) {
+        yj[i] = y[i * m + j];
+      }
+      spline(t.data(), yj.data(), n, yp1[j], ypn[j], y2j.data());
+
+      for (int i = 0; i < n; i++) {
+        EXPECT_NEAR(y2[i * m + j], y2j[i], 1e-9);
+      }
+    }
+  }
+}
+
+TEST(CubicVec, NaturalEndTest) {
+  // the second dimension has a natural start, so it is solved on its own
+  std::vector<Pose<2>> waypoints{{0, {1, 1}, {2, 1e31}},
+                                 {2, {2, 2}, {0, 0}},
+                                 {5, {0, 0}, {0, 0}},
+                                 {8, {0, 3}, {1, 1}}};
+  CubicVec<2> vec{waypoints};
+
+  double t[4] = {0, 2, 5, 8};
+  double y0[4] = {1, 2, 0, 0};
+  double y1[4] = {1, 2, 0, 3};
+  double y20[4];
+  double y21[4];
+  spline(t, y0, 4, 2, 1, y20);
+  spline(t, y1, 4, 1e31, 1, y21);
+
+  for (double x = 0; x <= 8; x += 0.5) {
+    double pos0, pos1;
+    splpos(t, y0, y20, 4, x, &pos0);
+    splpos(t, y1, y21, 4, x, &pos1);
+    EXPECT_NEAR(vec.splpos(x)[0], pos0, 1e-9);
+    EXPECT_NEAR(vec.splpos(x)[1], pos1, 1e-9);
+  }
+}
+
+TEST(CubicImpl, ParallelTest) {
+  const int m = 2;
+  const int n = 20000;
+  std::vector<double> t(n);
+  std::vector<double> y(n * m);
+  for (int i = 0; i < n; i++) {
+    t[i] = 0.5 * i + 0.1 * (i % 3);
+    y[i * m] = std::sin(0.01 * i) + (i % 7);
+    y[i * m + 1] = 0.001 * i * (i % 5);
+  }
+
+  // clamped and natural ends change the system, so both are checked
+  const double ends[2][2] = {{1, -2}, {1e31, 1e31}};
+  for (int e = 0; e < 2; e++) {
+    const double yp1[m] = {ends[e][0], ends[e][0]};
+    const double ypn[m] = {ends[e][1], ends[e][1]};
+
+    std::vector<std::vector<double>> expected(m);
+    double scale = 0;
+    for (int j = 0; j < m; j++) {
+      std::vector<double> yj(n);
+      for (int i = 0; i < n; i++) {
+        yj[i] = y[i * m + j];
+      }
+      expected[j].resize(n);
+      spline(t.data(), yj.data(), n, yp1[j], ypn[j], expected[j].data());
+      for (int i = 0; i < n; i++) {
+        scale = std::max(scale, std::fabs(expected[j][i]));
+      }
+    }
+
+    for (int threads = 1; threads <= 7; threads += 2) {
+      std::vector<double> y2(n * m);
+      splparallel(t.data(), y.data(), n, m, yp1, ypn, y2.data(), threads);
+
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+          ASSERT_NEAR(y2[i * m + j], expected[j][i],
+                      PARALLEL_TOLERANCE * scale);
+        }
+      }
+    }
+  }
+}
+
+TEST(CubicImpl, ParallelSmallTest) {
+  // more threads than pairs of points
+  double t[5] = {0, 2, 5, 8, 9};
+  double y[5] = {1, 2, 0, 0, 3};
+  double yp1 = 2;
+  double ypn = 1;
+
+  double expected[5];
+  double y2[5];
+  spline(t, y, 5, yp1, ypn, expected);
+  splparallel(t, y, 5, 1, &yp1, &ypn, y2, 8);
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_NEAR(y2[i], expected[i], 1e-9);
+  }
+
+  EXPECT_EQ(splthreads(10), 1);
+}
+
+TEST(CubicImpl, RunTest) {
+  std::atomic<int> runs[4] = {{0}, {0}, {0}, {0}};
+  splrun(4, [&](const int k) { runs[k]++; });
+  for (int k = 0; k < 4; k++) {
+    EXPECT_EQ(runs[k].load(), 1);
+  }
+
+  // the started threads are joined before the exception leaves
+  std::atomic<int> finished{0};
+  EXPECT_THROW(splrun(4,
+                      [&](const int k) {
+                        if (k == 0) {
+                          throw std::runtime_error{"failed"};
+                        }
+                        finished++;
+                      }),
+               std::runtime_error);
+  EXPECT_EQ(finished.load(), 3);
+}
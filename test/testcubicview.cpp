@@ -0,0 +1,94 @@
+#include <cstddef>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <hermite/cubic.hpp>
+#include <hermite/cubic/cubic_workspace.hpp>
+#include <hermite/cubic_view.hpp>
+
+#include "helpers.hpp"
+
+using namespace hermite;
+
+TEST(CubicView, MatchesCubicTest) {
+  const double ts[4] = {-1, 0.5, 2, 4.5};
+  const double xs[4] = {0, 2, 1, 3};
+  const double ys[4] = {1, 1, 0, -3};
+
+  // the second dimension has a natural end
+  CubicView<2> view{ts, {xs, ys}, 4, {1, -2}, {0.5, 1e31}};
+  Pose<2> p1{-1, {0, 1}, {1, -2}};
+  Pose<2> p2{0.5, {2, 1}, {0, 0}};
+  Pose<2> p3{2, {1, 0}, {0, 0}};
+  Pose<2> p4{4.5, {3, -3}, {0.5, 1e31}};
+  const Cubic<2> cub{{p1, p2, p3, p4}};
+
+  EXPECT_EQ(view.size(), 4u);
+  EXPECT_DOUBLE_EQ(view.getLowestTime(), -1);
+  EXPECT_DOUBLE_EQ(view.getHighestTime(), 4.5);
+  EXPECT_FALSE(view.isUniform());
+  EXPECT_NEAR(view.getPos(0.5)[0], 2, 1e-12);
+  EXPECT_NEAR(view.getVel(-1)[1], -2, 1e-12);
+  EXPECT_NEAR(view.getAcc(4.5)[1], 0, 1e-12);
+  test::expectSameSpline(view, cub, 1e-12);
+
+  const double batchTimes[3] = {-2, 1, 5};
+  State<2> states[3];
+  Vector<2> vels[3];
+  view.getStateBatch(batchTimes, 3, states);
+  view.getVelBatch(batchTimes, 3, vels);
+  for (std::size_t i = 0; i < 3; i++) {
+    EXPECT_NEAR(states[i].pos[1], cub.getPos(batchTimes[i])[1], 1e-12);
+    EXPECT_NEAR(vels[i][0], cub.getVel(batchTimes[i])[0], 1e-12);
+  }
+}
+
+TEST(CubicView, ResolveTest) {
+  const double ts[3] = {0, 1, 3};
+  std::vector<double> xs{0, 2, 1};
+  const double ys[3] = {1, 0, 2};
+
+  // the view reads the arrays, so changes show up after resolving
+  CubicView<2> view{ts, {xs.data(), ys}, 3, {0, 0}, {0, 0}};
+  xs[1] = 5;
+  view.resolve({0, 0}, {0, 0});
+  EXPECT_NEAR(view.getPos(1)[0], 5, 1e-12);
+
+  Pose<2> p1{0, {0, 1}, {0, 0}};
+  Pose<2> p2{1, {5, 0}, {0, 0}};
+  Pose<2> p3{3, {1, 2}, {0, 0}};
+  const Cubic<2> cub{{p1, p2, p3}};
+  test::expectSameSpline(view, cub, 1e-12);
+
+  // the same solve, with scratch memory from the caller
+  CubicWorkspace workspace;
+  xs[1] = 2;
+  view.resolve({0, 0}, {0, 0}, workspace);
+  xs[1] = 5;
+  view.resolve({0, 0}, {0, 0}, workspace);
+  test::expectSameSpline(view, cub, 1e-12);
+
+  CubicView<2> copy{view};
+  test::expectSameSpline(copy, cub, 1e-12);
+
+  CubicView<2> assigned;
+  assigned = view;
+  test::expectSameSpline(assigned, cub, 1e-12);
+}
+
+TEST(CubicView, EmptyTest) {
+  CubicView<2> empty;
+  EXPECT_EQ(empty.size(), 0u);
+  EXPECT_DOUBLE_EQ(empty.getLowestTime(), 0);
+  EXPECT_DOUBLE_EQ(empty.getPos(1)[0], 0);
+  EXPECT_EQ(empty.getAccData(0), nullptr);
+
+  const double ts[1] = {-1};
+  const double xs[1] = {0};
+  const double ys[1] = {1};
+  CubicView<2> one{ts, {xs, ys}, 1, {0, 0}, {0, 0}};
+  EXPECT_DOUBLE_EQ(one.getHighestTime(), -1);
+  EXPECT_DOUBLE_EQ(one.getVel(1)[1], 0);
+  EXPECT_DOUBLE_EQ(one.getLength(0.1), 0);
+}
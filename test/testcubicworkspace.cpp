@@ -0,0 +1,160 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <hermite/cubic.hpp>
+#include <hermite/cubic/cubic_impl.hpp>
+#include <hermite/cubic/cubic_workspace.hpp>
+
+#include "helpers.hpp"
+
+using namespace hermite;
+
+namespace {
+// counts heap allocations while counting is on. This file is built as its own
+// test binary, so the replacement operator new below only serves these tests.
+std::atomic<bool> counting{false};
+std::atomic<std::size_t> allocations{0};
+} // namespace
+
+void *operator new(std::size_t size) {
+  if (counting) {
+    allocations++;
+  }
+
+  void *res = std::malloc(size == 0 ? 1 : size);
+  if (res == nullptr) {
+    throw std::bad_alloc{};
+  }
+  return res;
+}
+
+// kept out of line so that GCC does not inline free() into callers whose
+// pointers came from a new expression, which it warns about
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+TEST(CubicWorkspace, SplineTest) {
+  double t[4] = {0, 2, 5, 8};
+  double y[4] = {1, 2, 0, 0};
+  double expected[4];
+  double y2[4];
+  double u[4];
+  spline(t, y, 4, 2, 1e31, expected);
+
+  allocations = 0;
+  counting = true;
+  spline(t, y, 4, 2, 1e31, y2, u);
+  counting = false;
+
+  EXPECT_EQ(allocations.load(), 0u);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(y2[i], expected[i]);
+  }
+}
+
+TEST(CubicWorkspace, ReserveTest) {
+  CubicWorkspace workspace;
+  EXPECT_EQ(workspace.size(), 0u);
+
+  workspace.reserve(10, 3);
+  EXPECT_EQ(workspace.size(), CubicWorkspace::getSize(10, 3));
+
+  // never shrinks
+  workspace.reserve(5, 3);
+  EXPECT_EQ(workspace.size(), CubicWorkspace::getSize(10, 3));
+
+  CubicWorkspace sized{20, 2};
+  EXPECT_EQ(sized.size(), CubicWorkspace::getSize(20, 2));
+}
+
+TEST(CubicWorkspace, RebuildTest) {
+  // natural start in the last dimension
+  Pose<3> p1{0, {0, 1, 0}, {1, -1, 1e31}};
+  Pose<3> p2{1.3, {1.3, -0.3, 1}, {0, 0, 0}};
+  Pose<3> p3{2, {2, -1, 2}, {0, 0, 0}};
+  Pose<3> p4{3.3, {3.3, -2.3, 3}, {0, 0, 0}};
+  Pose<3> p5{4, {4, -3, 0}, {0, 0, 0}};
+  const std::vector<Pose<3>> first{p1, p2, p3, p4, p5};
+
+  Pose<3> q2{1.3, {-2.6, -0.3, 1}, {0, 0, 0}};
+  Pose<3> q4{3.3, {-6.6, 5, 3}, {0, 0, 0}};
+  const std::vector<Pose<3>> second{p1, q2, p3, q4, p5};
+  const std::vector<Pose<3>> smaller{p1, q2, p3};
+
+  CubicWorkspace workspace;
+  Cubic<3> cub;
+  cub.rebuild(first, workspace);
+  cub.rebuild(first);
+
+  allocations = 0;
+  counting = true;
+  cub.rebuild(second, workspace);
+  cub.rebuild(smaller, workspace);
+  cub.rebuild(second);
+  counting = false;
+
+  EXPECT_EQ(allocations.load(), 0u);
+  EXPECT_NEAR(cub.getPos(1.3)[0], -2.6, 1e-12);
+  EXPECT_NEAR(cub.getPos(3.3)[1], 5, 1e-12);
+  EXPECT_NEAR(cub.getAcc(0)[2], 0, 1e-12);
+
+  // same as constructing a new spline
+  const Cubic<3> expected{second};
+  test::expectSameSpline(cub, expected, 1e-12);
+}
+
+TEST(CubicWorkspace, ResolveTest) {
+  Pose<3> p1{0, {0, 1, 0}, {1, -1, 1e31}};
+  Pose<3> p2{1.3, {1.3, -0.3, 1}, {0, 0, 0}};
+  Pose<3> p3{2, {2, -1, 2}, {0, 0, 0}};
+  Pose<3> p4{3.3, {3.3, -2.3, 3}, {0, 0, 0}};
+  const std::vector<Vector<3>> positions{
+      {0, 0, 0}, {6.5, -0.3, 1}, {10, -1, 2}, {-1, 4, 3}};
+  const Vector<3> startVel{5, -1, 1e31};
+  const Vector<3> endVel{5, -1, 0};
+
+  CubicWorkspace workspace;
+  Cubic<3> cub{{p1, p2, p3, p4}};
+
+  allocations = 0;
+  counting = true;
+  const bool resolved = cub.resolve(positions, startVel, endVel, workspace);
+  counting = false;
+
+  EXPECT_TRUE(resolved);
+  // the first solve with this workspace grows it
+  EXPECT_EQ(allocations.load(), 1u);
+
+  allocations = 0;
+  counting = true;
+  cub.resolve(positions, startVel, endVel, workspace);
+  cub.resolve(positions, startVel, endVel);
+  counting = false;
+
+  EXPECT_EQ(allocations.load(), 0u);
+  EXPECT_NEAR(cub.getPos(2)[0], 10, 1e-12);
+  EXPECT_NEAR(cub.getVel(3.3)[0], 5, 1e-12);
+
+  Pose<3> q1{0, {0, 0, 0}, startVel};
+  Pose<3> q2{1.3, {6.5, -0.3, 1}, {0, 0, 0}};
+  Pose<3> q3{2, {10, -1, 2}, {0, 0, 0}};
+  Pose<3> q4{3.3, {-1, 4, 3}, endVel};
+  const Cubic<3> expected{{q1, q2, q3, q4}};
+  test::expectSameSpline(cub, expected, 1e-12);
+}
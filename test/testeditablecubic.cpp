@@ -0,0 +1,163 @@
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <hermite/cubic.hpp>
+#include <hermite/editable_cubic.hpp>
+
+#include "helpers.hpp"
+
+using namespace hermite;
+
+TEST(EditableCubic, ConstructTest) {
+  Pose<2> p1{0, {0, 0}, {1, 0}};
+  Pose<2> p2{1.4, {1, 1}, {0, 0}};
+  Pose<2> p3{2.8, {0, 2}, {0, 0}};
+  Pose<2> p4{3, {-1, 3}, {-1, 1e31}};
+
+  // the waypoints are sorted
+  EditableCubic<2> spline{{p3, p1, p4, p2}};
+
+  EXPECT_EQ(spline.size(), 4u);
+  EXPECT_DOUBLE_EQ(spline.getLowestTime(), 0);
+  EXPECT_DOUBLE_EQ(spline.getHighestTime(), 3);
+  EXPECT_TRUE(spline.exists(2.8));
+  EXPECT_FALSE(spline.exists(0.5));
+  EXPECT_EQ(spline.getLastSolveSize(), 4u);
+  EXPECT_NEAR(spline.getPos(1.4)[1], 1, 1e-12);
+  EXPECT_NEAR(spline.getVel(0)[0], 1, 1e-12);
+  EXPECT_NEAR(spline.getAcc(3)[1], 0, 1e-12);
+
+  const Cubic<2> expected{{p1, p2, p3, p4}};
+  test::expectSameSpline(spline, expected, 1e-12);
+}
+
+TEST(EditableCubic, EditTest) {
+  std::vector<Pose<2>> waypoints;
+  for (int i = 0; i < 1000; i++) {
+    const double t = i + 0.4 * (i % 3);
+    waypoints.push_back({t, {std::sin(t), i % 5 * 1.0}, {0, 0}});
+  }
+  waypoints.back().setVel({-1, 1e31});
+  EditableCubic<2> spline{waypoints};
+
+  // edits in the middle only solve near them
+  spline.replace({500.8, {3, -2}, {0, 0}});
+  EXPECT_LT(spline.getLastSolveSize(), 200u);
+  EXPECT_NEAR(spline.getPos(500.8)[0], 3, 1e-12);
+  test::expectSameSpline(spline, Cubic<2>{spline.getAllWaypoints()}, 1e-9);
+
+  spline.insert({300.5, {-1, 4}, {0, 0}});
+  EXPECT_LT(spline.getLastSolveSize(), 200u);
+  EXPECT_EQ(spline.size(), 1001u);
+  EXPECT_NEAR(spline.getPos(300.5)[1], 4, 1e-12);
+  test::expectSameSpline(spline, Cubic<2>{spline.getAllWaypoints()}, 1e-9);
+
+  spline.erase(700.4);
+  EXPECT_LT(spline.getLastSolveSize(), 200u);
+  EXPECT_EQ(spline.size(), 1000u);
+  EXPECT_FALSE(spline.exists(700.4));
+  test::expectSameSpline(spline, Cubic<2>{spline.getAllWaypoints()}, 1e-9);
+
+  // existing and missing times are ignored
+  spline.insert({300.5, {100, 100}, {0, 0}});
+  spline.replace({300.6, {100, 100}, {0, 0}});
+  spline.erase(300.6);
+  EXPECT_EQ(spline.size(), 1000u);
+  EXPECT_NEAR(spline.getPos(300.5)[1], 4, 1e-12);
+}
+
+TEST(EditableCubic, EndTest) {
+  Pose<2> p1{0, {0, 0}, {1, 0}};
+  Pose<2> p2{1, {1, 1}, {0, 0}};
+  Pose<2> p3{2, {0, 2}, {-1, 1e31}};
+  EditableCubic<2> spline{{p1, p2, p3}};
+
+  // the ends take their velocities from the new first and last waypoints
+  spline.insert({-3, {1, 1}, {2, 1e31}});
+  EXPECT_NEAR(spline.getVel(-3)[0], 2, 1e-12);
+  EXPECT_NEAR(spline.getAcc(-3)[1], 0, 1e-12);
+  test::expectSameSpline(spline, Cubic<2>{spline.getAllWaypoints()}, 1e-12);
+
+  spline.erase(2);
+  EXPECT_NEAR(spline.getVel(1)[1], 0, 1e-12);
+  test::expectSameSpline(spline, Cubic<2>{spline.getAllWaypoints()}, 1e-12);
+
+  spline.insertOrReplace({-3, {0, 0}, {-2, 0.5}});
+  EXPECT_NEAR(spline.getVel(-3)[1], 0.5, 1e-12);
+  spline.insertOrReplace({5, {0, 0}, {0, 0}});
+  EXPECT_DOUBLE_EQ(spline.getHighestTime(), 5);
+  test::expectSameSpline(spline, Cubic<2>{spline.getAllWaypoints()}, 1e-12);
+}
+
+TEST(EditableCubic, ToleranceTest) {
+  std::vector<Pose<2>> waypoints;
+  for (int i = 0; i < 300; i++) {
+    waypoints.push_back({i * 1.0, {std::sin(i * 1.0), i % 5 * 1.0}, {0, 0}});
+  }
+  EditableCubic<2> spline{waypoints};
+  EXPECT_DOUBLE_EQ(spline.getTolerance(), EDIT_TOLERANCE);
+
+  spline.replace({150, {1, 2}, {0, 0}});
+  const std::size_t defaultSize = spline.getLastSolveSize();
+
+  spline.setTolerance(0);
+  spline.replace({150, {1, 1}, {0, 0}});
+  EXPECT_GE(spline.getLastSolveSize(), defaultSize);
+  test::expectSameSpline(spline, Cubic<2>{spline.getAllWaypoints()}, 1e-9);
+
+  spline.setTolerance(1e-3);
+  spline.replace({150, {2, 1}, {0, 0}});
+  EXPECT_LE(spline.getLastSolveSize(), 2 * EDIT_WINDOW + 3);
+  EXPECT_NEAR(spline.getPos(150)[0], 2, 1e-12);
+  test::expectSameSpline(spline, Cubic<2>{spline.getAllWaypoints()}, 1e-2);
+}
+
+TEST(EditableCubic, FewWaypointsTest) {
+  EditableCubic<2> spline;
+  EXPECT_EQ(spline.size(), 0u);
+  EXPECT_DOUBLE_EQ(spline.getPos(1)[0], 0);
+  EXPECT_DOUBLE_EQ(spline.getLength(0.1), 0);
+
+  spline.insert({1, {1, 2}, {0, 0}});
+  EXPECT_DOUBLE_EQ(spline.getHighestTime(), 1);
+  EXPECT_DOUBLE_EQ(spline.getVel(1)[0], 0);
+
+  // a straight line between two waypoints with matching velocities
+  spline.insert({3, {3, 0}, {1, -1}});
+  spline.replace({1, {1, 2}, {1, -1}});
+  EXPECT_NEAR(spline.getPos(2)[0], 2, 1e-12);
+  EXPECT_NEAR(spline.getVel(2.5)[1], -1, 1e-12);
+
+  spline.insert({2, {0, 0}, {0, 0}});
+  test::expectSameSpline(spline, Cubic<2>{spline.getAllWaypoints()}, 1e-12);
+
+  spline.erase(1);
+  spline.erase(3);
+  EXPECT_EQ(spline.size(), 1u);
+  EXPECT_DOUBLE_EQ(spline.getAcc(2)[1], 0);
+}
+
+TEST(EditableCubic, CopyTest) {
+  Pose<2> p1{0, {0, 0}, {1, 0}};
+  Pose<2> p2{1, {1, 1}, {0, 0}};
+  Pose<2> p3{2, {0, 2}, {-1, 0}};
+  EditableCubic<2> spline{{p1, p2, p3}};
+  spline.setTolerance(1e-6);
+
+  EditableCubic<2> copy{spline};
+  EditableCubic<2> assigned;
+  assigned = spline;
+  spline.erase(1);
+
+  EXPECT_EQ(copy.size(), 3u);
+  EXPECT_EQ(spline.size(), 2u);
+  EXPECT_DOUBLE_EQ(assigned.getTolerance(), 1e-6);
+  EXPECT_NEAR(copy.getPos(1)[1], 1, 1e-12);
+
+  const Cubic<2> expected{{p1, p2, p3}};
+  test::expectSameSpline(copy, expected, 1e-12);
+  test::expectSameSpline(assigned, expected, 1e-12);
+}
@@ -0,0 +1,272 @@
+#include <initializer_list>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hermite/flat_hermite.hpp"
+#include "hermite/hermite.hpp"
+
+#include "helpers.hpp"
+
+using namespace hermite;
+
+TEST(FlatHermite, InsertTest) {
+  Pose<2> p1{-3, {0, 1}, {2, 0}};
+  Pose<2> p2{-1.2, {3, -2}, {1, 1}};
+  Pose<2> p3{0, {1, 5}, {0, 3}};
+  Pose<2> p4{2.5, {-2, 0}, {-1, 2}};
+
+  FlatHermite<2> f;
+  Hermite<2> h;
+  for (const auto &p : {p3, p1, p4, p2}) {
+    f.insert(p);
+    h.insert(p);
+  }
+
+  // already exists after rounding
+  f.insert({0.05, {9, 9}, {9, 9}});
+  h.insert({0.05, {9, 9}, {9, 9}});
+
+  EXPECT_EQ(f.size(), 4);
+  EXPECT_NEAR(f.getLowestTime(), -3, 0.001);
+  EXPECT_NEAR(f.getHighestTime(), 2.5, 0.001);
+
+  const auto waypoints = f.getAllWaypoints();
+  ASSERT_EQ(waypoints.size(), 4u);
+  EXPECT_NEAR(waypoints[1].getTime(), -1.2, 1e-12);
+  EXPECT_NEAR(waypoints[2].getPos()[1], 5, 1e-12);
+  EXPECT_NEAR(waypoints[3].getVel()[0], -1, 1e-12);
+  EXPECT_NEAR(f.getPos(-1.2)[0], 3, 1e-12);
+  EXPECT_NEAR(f.getVel(0)[1], 3, 1e-12);
+  test::expectSameSpline(f, h, 1e-9);
+}
+
+TEST(FlatHermite, ReplaceTest) {
+  Pose<2> p1{-3, {0, 1}, {2, 0}};
+  Pose<2> p2{-1.2, {3, -2}, {1, 1}};
+  Pose<2> p3{2.5, {-2, 0}, {-1, 2}};
+
+  FlatHermite<2> f;
+  Hermite<2> h;
+  for (const auto &p : {p1, p2, p3}) {
+    f.insert(p);
+    h.insert(p);
+  }
+
+  // replacing a missing time does nothing, and insertOrReplace() inserts it
+  f.replace({2.5, {1, 1}, {0, 0}});
+  h.replace({2.5, {1, 1}, {0, 0}});
+  f.replace({1, {1, 1}, {0, 0}});
+  h.replace({1, {1, 1}, {0, 0}});
+  f.insertOrReplace({-1.2, {4, 4}, {1, 0}});
+  h.insertOrReplace({-1.2, {4, 4}, {1, 0}});
+  f.insertOrReplace({3, {4, 4}, {1, 0}});
+  h.insertOrReplace({3, {4, 4}, {1, 0}});
+
+  EXPECT_EQ(f.size(), 4);
+  EXPECT_FALSE(f.exists(1));
+  EXPECT_NEAR(f.getPos(2.5)[0], 1, 1e-12);
+  EXPECT_NEAR(f.getPos(-1.2)[1], 4, 1e-12);
+  EXPECT_NEAR(f.getVel(3)[0], 1, 1e-12);
+  test::expectSameSpline(f, h, 1e-9);
+}
+
+TEST(FlatHermite, EraseTest) {
+  Pose<2> p1{-3, {0, 1}, {2, 0}};
+  Pose<2> p2{-1.2, {3, -2}, {1, 1}};
+  Pose<2> p3{0, {1, 5}, {0, 3}};
+  Pose<2> p4{2.5, {-2, 0}, {-1, 2}};
+  Pose<2> p5{4, {6, 3}, {2, -1}};
+
+  FlatHermite<2> f;
+  Hermite<2> h;
+  for (const auto &p : {p1, p2, p3, p4, p5}) {
+    f.insert(p);
+    h.insert(p);
+  }
+
+  EXPECT_TRUE(f.exists(2.5));
+  EXPECT_TRUE(f.exists(Pose<2>{-1.2, {0, 0}, {0, 0}}));
+  EXPECT_FALSE(f.exists(1));
+
+  f.erase(2.5);
+  h.erase(2.5);
+  f.erase(Pose<2>{-3, {0, 0}, {0, 0}});
+  h.erase(Pose<2>{-3, {0, 0}, {0, 0}});
+  f.erase(1);
+  h.erase(1);
+
+  EXPECT_FALSE(f.exists(2.5));
+  EXPECT_EQ(f.size(), 3);
+  EXPECT_NEAR(f.getLowestTime(), -1.2, 1e-12);
+  EXPECT_NEAR(f.getPos(4)[0], 6, 1e-12);
+  test::expectSameSpline(f, h, 1e-9);
+}
+
+TEST(FlatHermite, BatchEditTest) {
+  FlatHermite<2> f;
+  Hermite<2> h;
+  f.insert({0, {0, 0}, {0, 0}});
+  h.insert({0, {0, 0}, {0, 0}});
+  f.insert({10, {5, 5}, {0, 0}});
+  h.insert({10, {5, 5}, {0, 0}});
+
+  // unsorted, with an existing time and a repeated time
+  std::vector<Pose<2>> poses{{6, {1, 2}, {3, 4}},  {-2, {0, 1}, {1, 0}},
+                             {10, {9, 9}, {9, 9}}, {3, {2, 2}, {1, 1}},
+                             {6.01, {7, 7}, {7, 7}}, {12, {1, 0}, {0, 1}}};
+  f.insertBatch(poses);
+  for (const auto &p : poses) {
+    h.insert(p);
+  }
+
+  EXPECT_EQ(f.size(), 6);
+  EXPECT_NEAR(f.getPos(6)[1], 2, 1e-12);
+  EXPECT_NEAR(f.getPos(10)[0], 5, 1e-12);
+  test::expectSameSpline(f, h, 1e-9);
+
+  f.eraseBatch({3, 12, 7});
+  h.erase(3);
+  h.erase(12);
+  h.erase(7);
+
+  EXPECT_EQ(f.size(), 4);
+  EXPECT_NEAR(f.getHighestTime(), 10, 1e-12);
+  test::expectSameSpline(f, h, 1e-9);
+}
+
+TEST(FlatHermite, EmptyTest) {
+  FlatHermite<2> f;
+  EXPECT_NEAR(f.getLowestTime(), 0, 0.001);
+  EXPECT_NEAR(f.getPos(1)[0], 0, 0.001);
+  EXPECT_NEAR(f.getState(1).acc[1], 0, 0.001);
+
+  f.insert({1, {3, 3}, {1, 1}});
+  EXPECT_NEAR(f.getVel(1)[0], 0, 0.001);
+  EXPECT_NEAR(f.getLength(0.1), 0, 0.001);
+
+  std::vector<double> ts{0, 1, 2};
+  std::vector<Vector<2>> out(3, Vector<2>{1, 1});
+  f.getPosBatch(ts.data(), ts.size(), out.data());
+  EXPECT_NEAR(out[2][1], 0, 0.001);
+}
+
+TEST(FlatHermite, CopyTest) {
+  FlatHermite<2> f{100};
+  f.insert({-3, {0, 1}, {2, 0}});
+  f.insert({0, {1, 5}, {0, 3}});
+  f.insert({2.5, {-2, 0}, {-1, 2}});
+
+  FlatHermite<2> g{f};
+  FlatHermite<2> k;
+  k = f;
+  f.erase(0);
+
+  EXPECT_EQ(f.size(), 2);
+  EXPECT_EQ(g.size(), 3);
+  EXPECT_EQ(k.size(), 3);
+  EXPECT_TRUE(k.exists(0));
+  EXPECT_FALSE(k.exists(0.015));
+  EXPECT_NEAR(g.getPos(0)[1], 5, 1e-12);
+}
+
+TEST(FlatHermite, EvaluationTest) {
+  Pose<2> p1{-3, {0, 1}, {2, 0}};
+  Pose<2> p2{-1.2, {3, -2}, {1, 1}};
+  Pose<2> p3{0, {1, 5}, {0, 3}};
+  Pose<2> p4{2.5, {-2, 0}, {-1, 2}};
+  Pose<2> p5{4, {6, 3}, {2, -1}};
+
+  FlatHermite<2> f;
+  Hermite<2> h;
+  for (const auto &p : {p1, p2, p3, p4, p5}) {
+    f.insert(p);
+    h.insert(p);
+  }
+
+  std::vector<double> ts;
+  for (double t = -4; t <= 5; t += 0.01) {
+    ts.push_back(t);
+  }
+
+  std::vector<Vector<2>> pos(ts.size());
+  std::vector<Vector<2>> acc(ts.size());
+  std::vector<State<2>> states(ts.size());
+  f.getPosBatch(ts.data(), ts.size(), pos.data());
+  f.getAccBatch(ts.data(), ts.size(), acc.data());
+  f.getStateBatch(ts.data(), ts.size(), states.data());
+
+  FlatHermite<2>::Cursor cur{f};
+  const auto compiled = f.compile();
+  const auto expCompiled = h.compile();
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    const auto expPos = h.getPos(ts[i]);
+    const auto expVel = h.getVel(ts[i]);
+    const auto expAcc = h.getAcc(ts[i]);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(pos[i][dim], expPos[dim], 1e-9);
+      EXPECT_NEAR(acc[i][dim], expAcc[dim], 1e-9);
+      EXPECT_NEAR(states[i].vel[dim], expVel[dim], 1e-9);
+      EXPECT_NEAR(cur.getPos(ts[i])[dim], expPos[dim], 1e-9);
+      EXPECT_NEAR(compiled.getPos(ts[i])[dim],
+                  expCompiled.getPos(ts[i])[dim], 1e-9);
+    }
+  }
+
+  EXPECT_NEAR(f.getLength(0.01), h.getLength(0.01), 1e-9);
+  EXPECT_NEAR(f.getMaxSpeed(0.01), h.getMaxSpeed(0.01), 1e-9);
+}
+
+TEST(FlatHermite, CursorAfterModifyTest) {
+  FlatHermite<2> f;
+  f.insert({0, {1, 5}, {0, 3}});
+  f.insert({2.5, {-2, 0}, {-1, 2}});
+  f.insert({4, {6, 3}, {2, -1}});
+
+  FlatHermite<2>::Cursor cur{f};
+  EXPECT_NEAR(cur.getPos(3)[0], f.getPos(3)[0], 1e-9);
+
+  f.insertOrReplace({3, {8, 8}, {0, 0}});
+  EXPECT_NEAR(cur.getPos(3)[0], 8, 1e-12);
+  EXPECT_NEAR(cur.getPos(3.2)[0], f.getPos(3.2)[0], 1e-9);
+  f.erase(3);
+  EXPECT_NEAR(cur.getPos(3.2)[0], f.getPos(3.2)[0], 1e-9);
+}
+
+TEST(FlatHermite, UniformTest) {
+  FlatHermite<2> f;
+  Hermite<2> h;
+  for (int i = 0; i <= 20; i++) {
+    const double t = 0.5 * i - 3;
+    const Pose<2> p{t, {t * t, 2 - t}, {2 * t, i % 3 - 1.0}};
+    f.insert(p);
+    h.insert(p);
+  }
+  EXPECT_TRUE(f.isUniform());
+
+  // acceleration is not continuous, so the subinterval on knots must match
+  std::vector<double> ts;
+  for (double t = -4; t <= 8; t += 0.05) {
+    ts.push_back(t);
+  }
+  std::vector<Vector<2>> acc(ts.size());
+  f.getAccBatch(ts.data(), ts.size(), acc.data());
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    EXPECT_NEAR(f.getAcc(ts[i])[1], h.getAcc(ts[i])[1], 1e-9);
+    EXPECT_NEAR(acc[i][1], h.getAcc(ts[i])[1], 1e-9);
+  }
+
+  f.insert({7.5, {0, 0}, {0, 0}});
+  EXPECT_TRUE(f.isUniform());
+  f.insert({9, {0, 0}, {0, 0}});
+  EXPECT_FALSE(f.isUniform());
+  f.erase(9);
+  EXPECT_TRUE(f.isUniform());
+  f.insert({0.2, {0, 0}, {0, 0}});
+  f.erase(0.2);
+  EXPECT_TRUE(f.isUniform());
+  f.eraseBatch({-3, 7.5});
+  EXPECT_TRUE(f.isUniform());
+  f.erase(2);
+  EXPECT_FALSE(f.isUniform());
+}
@@ -1,3 +1,11 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "hermite/hermite.hpp"
@@ -604,6 +612,448 @@ TEST(Hermite, MaxAccTest) {
   EXPECT_NEAR(h.getMaxAcceleration(0.001), 3.5, 0.01);
 }
 
+TEST(Hermite, ExactMaxTest) {
+  Hermite<1> h;
+  h.insert({-3, {-2}, {0}});
+  h.insert({0, {2}, {1}});
+  h.insert({2, {3}, {2}});
+  h.insert({6, {0}, {0}});
+
+  EXPECT_NEAR(h.getMaxDistance(), h.getMaxDistance(0.0001), 0.0001);
+  EXPECT_NEAR(h.getMaxSpeed(), h.getMaxSpeed(0.0001), 0.0001);
+  EXPECT_NEAR(h.getMaxAcceleration(), h.getMaxAcceleration(0.0001), 0.001);
+
+  // the sampled maxima can only fall short of the exact ones
+  Hermite<3> curve;
+  curve.insert({0, {1, 0, 0}, {0, 3, -1}});
+  curve.insert({1.3, {0, 2, 1}, {-4, 0, 2}});
+  curve.insert({2.1, {-1, 0, 2}, {0, -5, 0}});
+  curve.insert({4, {2, -1, 0}, {1, 1, 1}});
+
+  EXPECT_GE(curve.getMaxDistance() + 1e-12, curve.getMaxDistance(0.01));
+  EXPECT_GE(curve.getMaxSpeed() + 1e-12, curve.getMaxSpeed(0.01));
+  EXPECT_GE(curve.getMaxAcceleration() + 1e-12,
+            curve.getMaxAcceleration(0.01));
+  EXPECT_NEAR(curve.getMaxSpeed(), curve.getMaxSpeed(0.00001), 0.0001);
+
+  Hermite<3> single;
+  EXPECT_EQ(single.getMaxSpeed(), 0);
+  single.insert({0, {1, 2, 3}, {1, 1, 1}});
+  EXPECT_EQ(single.getMaxSpeed(), 0);
+}
+
+TEST(Hermite, RangeMaxTest) {
+  Hermite<2> h;
+  EXPECT_EQ(h.getMaxSpeed(0, 1), 0);
+
+  for (int i = 0; i < 20; i++) {
+    h.insert({i * 0.5, {std::cos(i * 0.7), i * 0.1}, {1, std::sin(i * 0.3)}});
+  }
+
+  // brute force over the window
+  const auto sampled = [&h](const double t0, const double t1, int deriv) {
+    double res = 0;
+    for (int i = 0; i <= 20000; i++) {
+      const double t = t0 + (t1 - t0) * i / 20000;
+      const Vector<2> val =
+          deriv == 0 ? h.getPos(t) : deriv == 1 ? h.getVel(t) : h.getAcc(t);
+      res = std::max(res, magn(val));
+    }
+    return res;
+  };
+
+  for (const auto &window : {std::make_pair(0.3, 0.4),
+                             std::make_pair(1.2, 4.7),
+                             std::make_pair(2.0, 7.5)}) {
+    const double t0 = window.first;
+    const double t1 = window.second;
+    EXPECT_NEAR(h.getMaxDistance(t0, t1), sampled(t0, t1, 0), 1e-6);
+    EXPECT_NEAR(h.getMaxSpeed(t0, t1), sampled(t0, t1, 1), 1e-6);
+    // the acceleration jumps at waypoints, so sampling can miss the end of a
+    // subinterval
+    EXPECT_GE(h.getMaxAcceleration(t0, t1) + 1e-9, sampled(t0, t1, 2));
+    EXPECT_NEAR(h.getMaxAcceleration(t0, t1), sampled(t0, t1, 2), 0.05);
+    EXPECT_EQ(h.getMaxSpeed(t1, t0), h.getMaxSpeed(t0, t1));
+  }
+
+  EXPECT_NEAR(h.getMaxSpeed(-10, 100), h.getMaxSpeed(), 1e-12);
+
+  // replacing a waypoint updates the maxima next to it
+  h.getMaxSpeed();
+  h.replace({5, {4, 4}, {6, 0}});
+  Hermite<2> fresh;
+  for (const auto &waypoint : h.getAllWaypoints()) {
+    fresh.insert(waypoint);
+  }
+  EXPECT_NEAR(h.getMaxSpeed(), fresh.getMaxSpeed(), 1e-12);
+  EXPECT_NEAR(h.getMaxDistance(3, 6), fresh.getMaxDistance(3, 6), 1e-12);
+  EXPECT_NEAR(h.getMaxAcceleration(4.2, 9), fresh.getMaxAcceleration(4.2, 9),
+              1e-12);
+}
+
+TEST(Hermite, BoundingBoxTest) {
+  Hermite<2> h;
+  EXPECT_TRUE(h.getBoundingBox().isEmpty());
+  EXPECT_TRUE(h.getBoundingBoxes().empty());
+
+  for (int i = 0; i < 12; i++) {
+    h.insert({i * 0.5, {std::cos(i * 0.7), i * 0.1}, {1, std::sin(i * 0.3)}});
+  }
+
+  // every sample is inside, and the box is tight
+  const auto check = [&h](const double t0, const double t1) {
+    const BoundingBox<2> box = h.getBoundingBox(t0, t1);
+    Vector<2> lower = h.getPos(t0);
+    Vector<2> upper = lower;
+    for (int i = 0; i <= 20000; i++) {
+      const Vector<2> pos = h.getPos(t0 + (t1 - t0) * i / 20000);
+      // up to rounding between getPos() and the power basis
+      EXPECT_LT(box.getSquaredDistance(pos), 1e-24);
+      for (std::size_t dim = 0; dim < 2; dim++) {
+        lower[dim] = std::min(lower[dim], pos[dim]);
+        upper[dim] = std::max(upper[dim], pos[dim]);
+      }
+    }
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(box.lower[dim], lower[dim], 1e-6);
+      EXPECT_NEAR(box.upper[dim], upper[dim], 1e-6);
+    }
+  };
+  check(0, 5.5);
+  check(1.2, 3.9);
+  check(2.1, 2.3);
+
+  const std::vector<BoundingBox<2>> boxes = h.getBoundingBoxes();
+  ASSERT_EQ(boxes.size(), 11);
+  for (std::size_t i = 0; i < boxes.size(); i++) {
+    const BoundingBox<2> expected = h.getBoundingBox(i * 0.5, i * 0.5 + 0.5);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(boxes[i].lower[dim], expected.lower[dim], 1e-12);
+      EXPECT_NEAR(boxes[i].upper[dim], expected.upper[dim], 1e-12);
+    }
+  }
+
+  // replacing a waypoint grows the box
+  h.getBoundingBox();
+  h.replace({2.5, {5, -5}, {0, 0}});
+  EXPECT_TRUE(h.getBoundingBox().contains({5, -5}));
+  EXPECT_FALSE(h.getBoundingBox(0, 2).contains({5, -5}));
+}
+
+TEST(Hermite, ClosestTimeTest) {
+  Hermite<2> h;
+  EXPECT_EQ(h.getClosestTime({1, 1}), 0);
+
+  for (int i = 0; i < 30; i++) {
+    h.insert({i * 0.5, {std::cos(i * 0.7), i * 0.1}, {1, std::sin(i * 0.3)}});
+  }
+
+  // brute force
+  const auto sampled = [&h](const Vector<2> &point) {
+    double best = 0;
+    double bestDist = magn(h.getPos(0) - point);
+    for (int i = 0; i <= 100000; i++) {
+      const double t = 14.5 * i / 100000;
+      const double dist = magn(h.getPos(t) - point);
+      if (dist < bestDist) {
+        best = t;
+        bestDist = dist;
+      }
+    }
+    return best;
+  };
+
+  double prev = 0;
+  for (const Vector<2> &point : {Vector<2>{0.3, 0.4}, Vector<2>{-2, 1.5},
+                                 Vector<2>{1.1, 2.9}, Vector<2>{5, -5}}) {
+    const double t = h.getClosestTime(point);
+    EXPECT_NEAR(t, sampled(point), 1e-3);
+    EXPECT_LE(magn(h.getPos(t) - point),
+              magn(h.getPos(sampled(point)) - point) + 1e-12);
+
+    // the hint only changes how fast the answer is found
+    EXPECT_NEAR(h.getClosestTime(point, prev), t, 1e-9);
+    EXPECT_NEAR(h.getClosestTime(point, 100), t, 1e-9);
+    prev = t;
+  }
+
+  // on the spline
+  EXPECT_NEAR(h.getClosestTime(h.getPos(6.3)), 6.3, 1e-6);
+
+  // past the last waypoint
+  EXPECT_EQ(h.getClosestTime({0, 100}), 14.5);
+}
+
+TEST(Hermite, SeparationTest) {
+  // two robots crossing paths, with waypoints at different times
+  Hermite<2> a;
+  Hermite<2> b;
+  for (int i = 0; i <= 10; i++) {
+    a.insert({i * 1.0, {i * 1.0, std::sin(i * 0.5)}, {1, 0.5 * std::cos(i)}});
+  }
+  for (int i = 0; i <= 14; i++) {
+    const double t = 1.5 + i * 0.6;
+    b.insert({t, {10 - t, 0.3 * std::cos(t)}, {-1, 0}});
+  }
+
+  const double threshold = 0.5;
+  const Separation sep = a.getSeparation(b, threshold);
+
+  // brute force over the common window, from 1.5 to 9.9
+  double best = 1e300;
+  double bestTime = 0;
+  std::vector<double> crossings;
+  double prev = magn(a.getPos(1.5) - b.getPos(1.5));
+  for (int i = 0; i <= 200000; i++) {
+    const double t = 1.5 + 8.4 * i / 200000;
+    const double dist = magn(a.getPos(t) - b.getPos(t));
+    if (dist < best) {
+      best = dist;
+      bestTime = t;
+    }
+    if ((prev < threshold) != (dist < threshold)) {
+      crossings.push_back(t);
+    }
+    prev = dist;
+  }
+
+  EXPECT_LE(sep.distance, best);
+  EXPECT_NEAR(sep.distance, best, 1e-6);
+  EXPECT_NEAR(sep.time, bestTime, 1e-4);
+  EXPECT_FALSE(sep.startsBelow);
+  ASSERT_EQ(sep.crossings.size(), crossings.size());
+  ASSERT_EQ(sep.crossings.size(), 2);
+  for (std::size_t i = 0; i < crossings.size(); i++) {
+    EXPECT_NEAR(sep.crossings[i], crossings[i], 1e-4);
+    const double dist =
+        magn(a.getPos(sep.crossings[i]) - b.getPos(sep.crossings[i]));
+    EXPECT_NEAR(dist, threshold, 1e-9);
+  }
+
+  // symmetric
+  const Separation reverse = b.getSeparation(a, threshold);
+  EXPECT_NEAR(reverse.distance, sep.distance, 1e-12);
+  EXPECT_EQ(reverse.crossings.size(), sep.crossings.size());
+
+  // no crossings needed
+  EXPECT_TRUE(a.getSeparation(b, -1).crossings.empty());
+  EXPECT_NEAR(a.getSeparation(b, -1).distance, sep.distance, 1e-12);
+
+  // no common time window
+  Hermite<2> later;
+  later.insert({20, {0, 0}, {1, 1}});
+  later.insert({21, {1, 1}, {1, 1}});
+  EXPECT_EQ(a.getSeparation(later, 1).distance,
+            std::numeric_limits<double>::infinity());
+}
+
+TEST(Hermite, SeparationTouchTest) {
+  // the distance is 1 + (t - 0.5)^2, which touches 1 on a waypoint
+  Hermite<1> a;
+  a.insert({0, {0}, {0}});
+  a.insert({1, {0}, {0}});
+  Hermite<1> b;
+  b.insert({0, {1.25}, {-1}});
+  b.insert({0.5, {1}, {0}});
+  b.insert({1, {1.25}, {1}});
+
+  const Separation sep = a.getSeparation(b, 1);
+  EXPECT_NEAR(sep.distance, 1, 1e-12);
+  EXPECT_NEAR(sep.time, 0.5, 1e-9);
+  EXPECT_FALSE(sep.startsBelow);
+  EXPECT_TRUE(sep.crossings.empty());
+
+  // dipping below gives two crossings
+  const Separation dip = a.getSeparation(b, 1.0625);
+  ASSERT_EQ(dip.crossings.size(), 2);
+  EXPECT_NEAR(dip.crossings[0], 0.25, 1e-9);
+  EXPECT_NEAR(dip.crossings[1], 0.75, 1e-9);
+}
+
+TEST(Hermite, Separation3DTest) {
+  // a brief close approach between two samples spaced 0.1 apart
+  Hermite<3> a;
+  a.insert({0, {-5, 0, 0}, {10, 0, 0}});
+  a.insert({1, {5, 0, 0}, {10, 0, 0}});
+  Hermite<3> b;
+  b.insert({0, {5, 0, 0.2}, {-10, 0, 0}});
+  b.insert({0.3, {2, 0, 0.2}, {-10, 0, 0}});
+  b.insert({1, {-5, 0, 0.2}, {-10, 0, 0}});
+
+  const Separation sep = a.getSeparation(b, 1);
+  EXPECT_NEAR(sep.distance, 0.2, 1e-9);
+  EXPECT_NEAR(sep.time, 0.5, 1e-9);
+  ASSERT_EQ(sep.crossings.size(), 2);
+  EXPECT_NEAR(sep.crossings[0], 0.5 - std::sqrt(0.96) / 20, 1e-9);
+  EXPECT_NEAR(sep.crossings[1], 0.5 + std::sqrt(0.96) / 20, 1e-9);
+
+  double sampled = 1e300;
+  for (int i = 0; i <= 10; i++) {
+    sampled = std::min(sampled, magn(a.getPos(i * 0.1 + 0.05) -
+                                     b.getPos(i * 0.1 + 0.05)));
+  }
+  EXPECT_GT(sampled, 0.9);
+}
+
+TEST(Hermite, ExactLengthTest) {
+  Hermite<2> h;
+  EXPECT_EQ(h.getLength(), 0);
+  EXPECT_EQ(h.getLength(0, 1), 0);
+
+  h.insert({0, {1, 0}, {0, 3}});
+  h.insert({1.5, {0, 2}, {-4, 0}});
+  h.insert({2.5, {-1, 0}, {0, -5}});
+  h.insert({4, {2, -1}, {1, 1}});
+  h.insert({5, {2, 1}, {0, 0}});
+
+  EXPECT_NEAR(h.getLength(), h.getLength(0.00001), 0.0001);
+  EXPECT_NEAR(h.getLength(-1, 10), h.getLength(), 1e-12);
+  EXPECT_NEAR(h.getLength(0.7, 3.1) + h.getLength(3.1, 4.6),
+              h.getLength(0.7, 4.6), 1e-12);
+  EXPECT_NEAR(h.getLength(1.5, 0.2), -h.getLength(0.2, 1.5), 1e-12);
+  EXPECT_NEAR(h.getLength(2.6, 2.9),
+              h.getLength(2.6, 5) - h.getLength(2.9, 5), 1e-12);
+
+  // every kind of edit gives the same lengths as a fresh spline
+  h.replace({1.5, {0, 3}, {-3, 1}});
+  h.replace({5, {1, 1}, {0, 1}});
+  h.getLength();
+  h.replace({0, {0, 0}, {1, 1}});
+  h.insert({3, {0, -3}, {1, 0}});
+  h.erase(4);
+  h.insertOrReplace({2.5, {-2, 0}, {0, -5}});
+
+  Hermite<2> fresh;
+  for (const auto &waypoint : h.getAllWaypoints()) {
+    fresh.insert(waypoint);
+  }
+  EXPECT_NEAR(h.getLength(), fresh.getLength(), 1e-12);
+  EXPECT_NEAR(h.getLength(0.3, 2.7), fresh.getLength(0.3, 2.7), 1e-12);
+
+  // copies keep the lengths
+  const Hermite<2> copy = h;
+  EXPECT_NEAR(copy.getLength(), fresh.getLength(), 1e-12);
+}
+
+TEST(Hermite, ReplaceLengthTest) {
+  Hermite<1> h{1};
+  for (int i = 0; i < 40; i++) {
+    h.insert({static_cast<double>(i), {i % 3 * 1.0}, {1}});
+  }
+  h.getLength();
+
+  // a few replacements are patched into the cache, including ones that move
+  // a waypoint within its rounding
+  h.replace({10.5, {4}, {0}});
+  h.replace({10.2, {5}, {-1}});
+  h.replace({39, {0}, {0}});
+
+  Hermite<1> fresh{1};
+  for (const auto &waypoint : h.getAllWaypoints()) {
+    fresh.insert(waypoint);
+  }
+  EXPECT_NEAR(h.getLength(), fresh.getLength(), 1e-9);
+  EXPECT_NEAR(h.getLength(9.5, 11), fresh.getLength(9.5, 11), 1e-12);
+}
+
+TEST(Hermite, ConcurrentLengthTest) {
+  Hermite<1> h{1};
+  Hermite<1> expected{1};
+  for (int i = 0; i < 40; i++) {
+    h.insert({static_cast<double>(i), {i % 3 * 1.0}, {1}});
+    expected.insert({static_cast<double>(i), {i % 3 * 1.0}, {1}});
+  }
+  h.getLength();
+  h.replace({10, {4}, {0}});
+  expected.replace({10, {4}, {0}});
+  const double length = expected.getLength();
+  const double maxSpeed = expected.getMaxSpeed();
+
+  // the first queries apply the patch from several threads at once
+  const Hermite<1> &shared = h;
+  std::vector<double> lengths(4);
+  std::vector<double> maxSpeeds(4);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < 4; i++) {
+    threads.emplace_back([&shared, &lengths, &maxSpeeds, i]() {
+      lengths[i] = shared.getLength();
+      maxSpeeds[i] = shared.getMaxSpeed();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (std::size_t i = 0; i < 4; i++) {
+    EXPECT_NEAR(lengths[i], length, 1e-9);
+    EXPECT_NEAR(maxSpeeds[i], maxSpeed, 1e-12);
+  }
+}
+
+TEST(Hermite, TimeAtDistanceTest) {
+  Hermite<2> h;
+  EXPECT_EQ(h.getTimeAtDistance(1), 0);
+
+  h.insert({0, {1, 0}, {0, 3}});
+  h.insert({1.5, {0, 2}, {-4, 0}});
+  h.insert({2.5, {-1, 0}, {0, -5}});
+  h.insert({4, {2, -1}, {1, 1}});
+  h.insert({5, {2, 1}, {0, 0}});
+
+  const double length = h.getLength();
+  for (int i = 0; i <= 20; i++) {
+    const double dist = length * i / 20;
+    const double t = h.getTimeAtDistance(dist);
+    EXPECT_NEAR(h.getLength(0, t), dist, 1e-9);
+  }
+
+  EXPECT_EQ(h.getTimeAtDistance(-1), 0);
+  EXPECT_EQ(h.getTimeAtDistance(length + 1), 5);
+
+  const Vector<2> pos = h.getPosAtDistance(length / 3);
+  const Vector<2> expected = h.getPos(h.getTimeAtDistance(length / 3));
+  EXPECT_EQ(pos[0], expected[0]);
+  EXPECT_EQ(pos[1], expected[1]);
+}
+
+TEST(Hermite, DistanceCursorTest) {
+  Hermite<2> h;
+  for (int i = 0; i < 30; i++) {
+    h.insert({i * 0.5, {std::cos(i * 0.7), i * 0.1}, {1, std::sin(i * 0.3)}});
+  }
+
+  Hermite<2>::DistanceCursor cursor{h};
+  const double length = h.getLength();
+
+  // forward in small steps, then backward, then jumping around
+  for (int i = 0; i <= 500; i++) {
+    const double dist = length * i / 500;
+    EXPECT_NEAR(cursor.getTime(dist), h.getTimeAtDistance(dist), 1e-9);
+  }
+  for (int i = 500; i >= 0; i -= 3) {
+    const double dist = length * i / 500;
+    EXPECT_NEAR(cursor.getTime(dist), h.getTimeAtDistance(dist), 1e-9);
+  }
+  for (int i = 0; i < 50; i++) {
+    const double dist = length * ((i * 37) % 50) / 50;
+    EXPECT_NEAR(cursor.getTime(dist), h.getTimeAtDistance(dist), 1e-9);
+  }
+
+  // edits are noticed
+  cursor.getTime(length / 2);
+  h.replace({7, {3, 3}, {0, 0}});
+  EXPECT_NEAR(cursor.getTime(length / 2), h.getTimeAtDistance(length / 2),
+              1e-9);
+  h.erase(7.5);
+  const Vector<2> pos = cursor.getPos(length / 2);
+  const Vector<2> expected = h.getPosAtDistance(length / 2);
+  EXPECT_NEAR(pos[0], expected[0], 1e-9);
+  EXPECT_NEAR(pos[1], expected[1], 1e-9);
+
+  cursor.reset();
+  EXPECT_NEAR(cursor.getTime(1), h.getTimeAtDistance(1), 1e-9);
+}
+
 TEST(Hermite, ArcLengthTest) {
   Hermite<1> h;
 
@@ -672,3 +1122,177 @@ TEST(Hermite, AssignTest) {
   EXPECT_NEAR(h2.getPos(3.5)[0], 3.227, 0.01);
   EXPECT_NEAR(h2.getPos(6)[0], 0, 0.01);
 }
+
+TEST(Hermite, BatchMatchesSingleTest) {
+  Hermite<2> h;
+  h.insert({-3, {-2, 1}, {0, 1}});
+  h.insert({0, {2, 0}, {1, -1}});
+  h.insert({2, {3, 4}, {2, 0}});
+  h.insert({6, {0, 1}, {0, 2}});
+
+  // sorted, repeated, out of bounds, and one backwards jump
+  std::vector<double> ts{-5, -3, -1.5, -1.5, 0, 1, 2, 3.5, 6, 8, -2, 4};
+  std::vector<Vector<2>> pos(ts.size());
+  std::vector<Vector<2>> vel(ts.size());
+  std::vector<Vector<2>> acc(ts.size());
+
+  h.getPosBatch(ts.data(), ts.size(), pos.data());
+  h.getVelBatch(ts.data(), ts.size(), vel.data());
+  h.getAccBatch(ts.data(), ts.size(), acc.data());
+
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(pos[i][dim], h.getPos(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(vel[i][dim], h.getVel(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(acc[i][dim], h.getAcc(ts[i])[dim], 0.000001);
+    }
+  }
+}
+
+TEST(Hermite, BatchNotEnoughTest) {
+  Hermite<1> h;
+  h.insert({-3, {-2}, {0}});
+
+  double ts[2] = {-3, 1};
+  Vector<1> out[2] = {{4}, {5}};
+  h.getPosBatch(ts, 2, out);
+
+  EXPECT_TRUE(out[0].isZero());
+  EXPECT_TRUE(out[1].isZero());
+}
+
+TEST(Hermite, CursorMatchesSingleTest) {
+  Hermite<2> h;
+  for (int i = 0; i < 20; i++) {
+    h.insert({i * 0.5, {i * 1.0, -i * 2.0}, {1, i % 3 - 1.0}});
+  }
+
+  SplineCursor<Hermite<2>> cur{h};
+
+  // forward steps, then big jumps in both directions
+  std::vector<double> ts;
+  for (double t = -0.5; t <= 10; t += 0.05) {
+    ts.push_back(t);
+  }
+  ts.push_back(1);
+  ts.push_back(9);
+  ts.push_back(0.2);
+
+  for (const double t : ts) {
+    auto pos = cur.getPos(t);
+    auto vel = cur.getVel(t);
+    auto acc = cur.getAcc(t);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(pos[dim], h.getPos(t)[dim], 0.000001);
+      EXPECT_NEAR(vel[dim], h.getVel(t)[dim], 0.000001);
+      EXPECT_NEAR(acc[dim], h.getAcc(t)[dim], 0.000001);
+    }
+  }
+}
+
+TEST(Hermite, CursorAfterModifyTest) {
+  Hermite<1> h;
+  h.insert({0, {0}, {0}});
+  h.insert({4, {4}, {0}});
+
+  Hermite<1>::Cursor cur{h};
+  EXPECT_NEAR(cur.getPos(1)[0], h.getPos(1)[0], 0.000001);
+
+  h.insert({2, {10}, {0}});
+  EXPECT_NEAR(cur.getPos(1)[0], h.getPos(1)[0], 0.000001);
+
+  h.replace({2, {-10}, {0}});
+  EXPECT_NEAR(cur.getPos(1.5)[0], h.getPos(1.5)[0], 0.000001);
+
+  h.erase(0);
+  h.erase(2);
+  EXPECT_TRUE(cur.getPos(1.5).isZero());
+}
+
+TEST(Hermite, StateTest) {
+  Hermite<2> h;
+  h.insert({-3, {-2, 1}, {0, 1}});
+  h.insert({0, {2, 0}, {1, -1}});
+  h.insert({2, {3, 4}, {2, 0}});
+  h.insert({6, {0, 1}, {0, 2}});
+
+  std::vector<double> ts{-5, -3, -1.5, 0, 1, 2, 3.5, 6, 8, -2};
+  std::vector<State<2>> batch(ts.size());
+  h.getStateBatch(ts.data(), ts.size(), batch.data());
+
+  Hermite<2>::Cursor cur{h};
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    auto res = h.getState(ts[i]);
+    auto curRes = cur.getState(ts[i]);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(res.pos[dim], h.getPos(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(res.vel[dim], h.getVel(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(res.acc[dim], h.getAcc(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(batch[i].pos[dim], res.pos[dim], 0.000001);
+      EXPECT_NEAR(batch[i].vel[dim], res.vel[dim], 0.000001);
+      EXPECT_NEAR(batch[i].acc[dim], res.acc[dim], 0.000001);
+      EXPECT_NEAR(curRes.acc[dim], res.acc[dim], 0.000001);
+    }
+  }
+}
+
+TEST(Hermite, StateEmptyTest) {
+  Hermite<2> h;
+  auto res = h.getState(1);
+  EXPECT_TRUE(res.pos.isZero());
+  EXPECT_TRUE(res.vel.isZero());
+  EXPECT_TRUE(res.acc.isZero());
+}
+
+TEST(Hermite, DenseBatchTest) {
+  Hermite<3> h;
+  h.insert({-3, {-2, 1, 0}, {0, 1, 1}});
+  h.insert({0, {2, 0, 1}, {1, -1, 0}});
+  h.insert({2, {3, 4, 2}, {2, 0, -1}});
+  h.insert({6, {0, 1, 3}, {0, 2, 0}});
+
+  std::vector<double> ts;
+  for (double t = -3.5; t <= 6.5; t += 0.001) {
+    ts.push_back(t);
+  }
+
+  std::vector<Vector<3>> pos(ts.size());
+  std::vector<Vector<3>> acc(ts.size());
+  h.getPosBatch(ts.data(), ts.size(), pos.data());
+  h.getAccBatch(ts.data(), ts.size(), acc.data());
+
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    for (std::size_t dim = 0; dim < 3; dim++) {
+      EXPECT_NEAR(pos[i][dim], h.getPos(ts[i])[dim], 0.000001);
+      EXPECT_NEAR(acc[i][dim], h.getAcc(ts[i])[dim], 0.000001);
+    }
+  }
+}
+
+TEST(Hermite, FloatTest) {
+  // large absolute times, which float could not hold to a millisecond
+  const double start = 1e7;
+  Hermite<2> h{1000};
+  Hermite<2, float> single{1000};
+  h.insert({start, {-2, 1}, {0, 1}});
+  h.insert({start + 0.5, {2, 0}, {1, -1}});
+  h.insert({start + 2, {3, 4}, {2, 0}});
+  single.insert({start, {-2, 1}, {0, 1}});
+  single.insert({start + 0.5, {2, 0}, {1, -1}});
+  single.insert({start + 2, {3, 4}, {2, 0}});
+
+  EXPECT_EQ(single.getLowestTime(), start);
+  EXPECT_EQ(single.getAllWaypoints()[1].getTime(), start + 0.5);
+
+  for (double t = start - 0.5; t <= start + 2.5; t += 0.01) {
+    const auto expected = h.getState(t);
+    const auto res = single.getState(t);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(res.pos[dim], expected.pos[dim], 1e-5);
+      EXPECT_NEAR(res.vel[dim], expected.vel[dim], 1e-5);
+      EXPECT_NEAR(res.acc[dim], expected.acc[dim], 1e-4);
+    }
+  }
+
+  EXPECT_NEAR(single.getLength(), h.getLength(), 1e-5);
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hermite/cubic.hpp"
+#include "hermite/cubic/cubic_impl.hpp"
+#include "hermite/flat_hermite.hpp"
+#include "hermite/knot_index.hpp"
+
+using namespace hermite;
+
+TEST(KnotIndex, EmptyTest) {
+  KnotIndex<double> index;
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(index.size(), 0);
+}
+
+TEST(KnotIndex, UpperBoundTest) {
+  // every tree shape up to a few levels, including incomplete last levels
+  for (std::size_t n = 1; n <= 40; n++) {
+    std::vector<double> knots;
+    for (std::size_t i = 0; i < n; i++) {
+      knots.push_back(1.5 * static_cast<double>(i * i) - 3);
+    }
+
+    const KnotIndex<double> index{knots.data(), n};
+    EXPECT_EQ(index.size(), n);
+    for (double x = -5; x <= knots.back() + 2; x += 0.25) {
+      const auto expected =
+          std::upper_bound(knots.begin(), knots.end(), x) - knots.begin();
+      EXPECT_EQ(index.upperBound(x), static_cast<std::size_t>(expected));
+    }
+
+    if (n >= 2) {
+      for (const double x : knots) {
+        EXPECT_EQ(index.findSegment(x),
+                  splhunt(knots.data(), static_cast<int>(n), x, -1));
+      }
+      EXPECT_EQ(index.findSegment(-100), 0);
+      EXPECT_EQ(index.findSegment(1e9), static_cast<int>(n) - 2);
+    }
+  }
+}
+
+TEST(KnotIndex, IntegerTest) {
+  std::vector<std::int64_t> knots{-30, -7, 0, 2, 3, 50, 51, 900};
+  const KnotIndex<std::int64_t> index{knots.data(), knots.size()};
+  for (std::int64_t x = -40; x <= 1000; x++) {
+    const auto expected =
+        std::upper_bound(knots.begin(), knots.end(), x) - knots.begin();
+    EXPECT_EQ(index.upperBound(x), static_cast<std::size_t>(expected));
+  }
+}
+
+TEST(KnotIndex, SplineTest) {
+  std::vector<Pose<2>> waypoints;
+  FlatHermite<2> flat;
+  for (int i = 0; i < 50; i++) {
+    const double t = 0.1 * i * i;
+    waypoints.push_back({t, {t, i % 4 - 1.5}, {1, 0}});
+    flat.insert(waypoints.back());
+  }
+
+  Cubic<2> cub{waypoints};
+  auto compiled = cub.compile();
+  const Cubic<2> cubNoIndex{cub};
+  const auto compiledNoIndex = compiled;
+  const FlatHermite<2> flatNoIndex{flat};
+
+  cub.buildIndex();
+  compiled.buildIndex();
+  flat.buildIndex();
+  EXPECT_TRUE(cub.hasIndex());
+  EXPECT_TRUE(compiled.hasIndex());
+  EXPECT_TRUE(flat.hasIndex());
+  EXPECT_FALSE(cubNoIndex.hasIndex());
+
+  for (double t = -10; t <= 260; t += 0.35) {
+    EXPECT_NEAR(cub.getPos(t)[1], cubNoIndex.getPos(t)[1], 1e-9);
+    EXPECT_NEAR(compiled.getAcc(t)[1], compiledNoIndex.getAcc(t)[1], 1e-9);
+    EXPECT_NEAR(flat.getAcc(t)[1], flatNoIndex.getAcc(t)[1], 1e-9);
+  }
+
+  // knots have different accelerations on each side
+  for (const auto &p : waypoints) {
+    EXPECT_NEAR(flat.getAcc(p.getTime())[1],
+                flatNoIndex.getAcc(p.getTime())[1], 1e-9);
+  }
+
+  flat.insert({300, {0, 0}, {0, 0}});
+  EXPECT_FALSE(flat.hasIndex());
+
+  // rebuilding a Cubic keeps its index, over the new times
+  waypoints.resize(20);
+  cub.rebuild(waypoints);
+  const Cubic<2> rebuilt{waypoints};
+  EXPECT_TRUE(cub.hasIndex());
+  for (double t = -1; t <= 40; t += 0.35) {
+    EXPECT_NEAR(cub.getPos(t)[1], rebuilt.getPos(t)[1], 1e-9);
+  }
+}
@@ -0,0 +1,123 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <hermite/cubic.hpp>
+#include <hermite/lazy_cubic.hpp>
+
+#include "helpers.hpp"
+
+using namespace hermite;
+
+TEST(LazyCubic, BurstTest) {
+  Pose<2> p1{0, {0, 0}, {1, -1}};
+  Pose<2> p2{1.3, {1.69, 1}, {0, 0}};
+  Pose<2> p3{2, {4, 2}, {0, 0}};
+  Pose<2> p4{3.3, {10.89, 0}, {0, 0}};
+  Pose<2> p5{4, {16, 1}, {1, -1}};
+
+  LazyCubic<2> spline{{p1, p2, p3, p4, p5}};
+  EXPECT_TRUE(spline.isDirty());
+  EXPECT_EQ(spline.getSolveCount(), 0u);
+
+  spline.commit();
+  EXPECT_FALSE(spline.isDirty());
+  EXPECT_EQ(spline.getSolveCount(), 1u);
+  spline.resetCounters();
+
+  // a burst of edits is solved once, on the first query
+  for (int i = 0; i < 10; i++) {
+    spline.insertOrReplace({2.5, {1.0 * i, 2}, {0, 0}});
+  }
+  spline.erase(1.3);
+  spline.replace({3.3, {-4, 4}, {0, 0}});
+  spline.insert({5, {3, 3}, {0, 1}});
+  EXPECT_TRUE(spline.isDirty());
+  EXPECT_EQ(spline.getSolveCount(), 0u);
+  EXPECT_EQ(spline.getAvoidedSolveCount(), 12u);
+
+  EXPECT_NEAR(spline.getPos(2.5)[0], 9, 1e-12);
+  EXPECT_NEAR(spline.getPos(3.3)[1], 4, 1e-12);
+  EXPECT_NEAR(spline.getVel(5)[1], 1, 1e-12);
+  EXPECT_EQ(spline.getSolveCount(), 1u);
+  EXPECT_FALSE(spline.isDirty());
+
+  const Cubic<2> expected{spline.getAllWaypoints()};
+  test::expectSameSpline(spline, expected, 1e-12);
+}
+
+TEST(LazyCubic, NoChangeTest) {
+  Pose<2> p1{0, {0, 0}, {1, -1}};
+  Pose<2> p2{1.3, {1.69, 1}, {0, 0}};
+  Pose<2> p3{2, {4, 2}, {1, -1}};
+
+  LazyCubic<2> spline{{p1, p2, p3}};
+  spline.commit();
+
+  // edits that change nothing do not mark the spline
+  spline.insert({2, {100, 100}, {0, 0}});
+  spline.replace({2.5, {100, 100}, {0, 0}});
+  spline.erase(2.5);
+  EXPECT_FALSE(spline.isDirty());
+  EXPECT_TRUE(spline.exists(2));
+  EXPECT_FALSE(spline.exists(2.5));
+  EXPECT_EQ(spline.size(), 3u);
+  EXPECT_DOUBLE_EQ(spline.getPos(2)[0], 4);
+
+  // the domain does not need a solve
+  spline.erase(0);
+  EXPECT_DOUBLE_EQ(spline.getLowestTime(), 1.3);
+  EXPECT_TRUE(spline.isDirty());
+}
+
+TEST(LazyCubic, CompileTest) {
+  Pose<2> p1{0, {0, 0}, {1, -1}};
+  Pose<2> p2{1.3, {1.69, 1}, {0, 0}};
+  Pose<2> p3{2, {4, 2}, {0, 0}};
+  Pose<2> p4{3.3, {10.89, 0}, {1, -1}};
+
+  LazyCubic<2> spline{{p1, p2, p3, p4}};
+  spline.erase(2);
+
+  const CompiledSpline<2> compiled = spline.compile();
+  EXPECT_FALSE(spline.isDirty());
+  EXPECT_NEAR(compiled.getPos(1.3)[0], 1.69, 1e-12);
+  for (double t = 0; t <= 3.3; t += 0.5) {
+    EXPECT_NEAR(compiled.getPos(t)[0], spline.getPos(t)[0], 1e-9);
+  }
+}
+
+TEST(LazyCubic, CopyTest) {
+  Pose<2> p1{0, {0, 0}, {1, -1}};
+  Pose<2> p2{1.3, {1.69, 1}, {0, 0}};
+  Pose<2> p3{2, {4, 2}, {1, -1}};
+
+  LazyCubic<2> spline{{p1, p2, p3}};
+  spline.insert({1.5, {0, 0}, {0, 0}});
+
+  LazyCubic<2> copy{spline};
+  LazyCubic<2> assigned;
+  assigned = spline;
+  spline.erase(1.5);
+
+  EXPECT_TRUE(copy.isDirty());
+  EXPECT_EQ(assigned.size(), 4u);
+  EXPECT_EQ(spline.size(), 3u);
+  EXPECT_NEAR(copy.getPos(1.5)[0], 0, 1e-12);
+  EXPECT_NEAR(assigned.getPos(1.5)[1], 0, 1e-12);
+
+  const Cubic<2> expected{{p1, p2, {1.5, {0, 0}, {0, 0}}, p3}};
+  test::expectSameSpline(copy, expected, 1e-12);
+  test::expectSameSpline(assigned, expected, 1e-12);
+}
+
+TEST(LazyCubic, EmptyTest) {
+  LazyCubic<2> spline;
+  EXPECT_FALSE(spline.isDirty());
+  EXPECT_DOUBLE_EQ(spline.getPos(1)[0], 0);
+  EXPECT_DOUBLE_EQ(spline.getHighestTime(), 0);
+
+  spline.insert({1, {1, 1}, {0, 0}});
+  EXPECT_DOUBLE_EQ(spline.getVel(1)[1], 0);
+  EXPECT_EQ(spline.getSolveCount(), 1u);
+}
@@ -0,0 +1,55 @@
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include "hermite/pod_vector.hpp"
+#include "hermite/pose.hpp"
+
+using namespace hermite;
+
+TEST(PodVector, LayoutTest) {
+  static_assert(std::is_trivially_copyable<PodVector<3>>::value,
+                "PodVector should be trivially copyable");
+  static_assert(std::is_trivially_copyable<Pose<3>>::value,
+                "Pose should be trivially copyable");
+  static_assert(alignof(PodVector<3>) >= 16, "PodVector should be aligned");
+
+  EXPECT_GE(sizeof(PodVector<3>), 3 * sizeof(double));
+  EXPECT_LE(sizeof(PodVector<3>), 4 * sizeof(double));
+}
+
+TEST(PodVector, DefaultTest) {
+  PodVector<3> v;
+  EXPECT_NEAR(v[0], 0, 0.001);
+  EXPECT_NEAR(v[1], 0, 0.001);
+  EXPECT_NEAR(v[2], 0, 0.001);
+}
+
+TEST(PodVector, ConversionTest) {
+  Vector<3> a{1, -2, 3.5};
+  PodVector<3> p = a;
+  EXPECT_NEAR(p[0], 1, 0.001);
+  EXPECT_NEAR(p[1], -2, 0.001);
+  EXPECT_NEAR(p.data()[2], 3.5, 0.001);
+
+  p[1] = 4;
+  Vector<3> b = p;
+  EXPECT_NEAR(b[0], 1, 0.001);
+  EXPECT_NEAR(b[1], 4, 0.001);
+  EXPECT_NEAR(p.toVector()[2], 3.5, 0.001);
+}
+
+TEST(PodVector, ScaleTest) {
+  PodVector<2> p = Vector<2>{1, -3};
+  const auto res = p * 2;
+  EXPECT_NEAR(res[0], 2, 0.001);
+  EXPECT_NEAR(res[1], -6, 0.001);
+}
+
+TEST(PodVector, PoseTest) {
+  Pose<2> a{1, {2, 3}, {4, 5}};
+  Pose<2> b{a.getTime(), a.getPosData(), a.getVelData()};
+  EXPECT_NEAR(b.getPos()[1], 3, 0.001);
+  EXPECT_NEAR(b.getVel()[0], 4, 0.001);
+  EXPECT_NEAR(b.getVelData()[1], 5, 0.001);
+}
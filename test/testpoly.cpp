@@ -0,0 +1,215 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "hermite/poly/poly.hpp"
+
+using namespace hermite;
+
+TEST(Poly, EvaluateTest) {
+  const double c[4] = {1, -2, 0, 3};
+  EXPECT_NEAR(poly::evaluate(c, 3, 2), 1 - 4 + 24, 1e-12);
+  EXPECT_NEAR(poly::evaluate(c, 0, 2), 1, 1e-12);
+}
+
+TEST(Poly, FindRootsTest) {
+  // (x - 0.25)(x - 0.5)(x - 0.75), which is exact in binary
+  const double c[4] = {-0.09375, 0.6875, -1.5, 1};
+  double roots[3];
+  ASSERT_EQ(poly::findRoots(c, 3, 0, 1, roots), 3);
+  EXPECT_NEAR(roots[0], 0.25, 1e-12);
+  EXPECT_NEAR(roots[1], 0.5, 1e-12);
+  EXPECT_NEAR(roots[2], 0.75, 1e-12);
+
+  // only the roots in the interval
+  ASSERT_EQ(poly::findRoots(c, 3, 0.3, 2, roots), 2);
+  EXPECT_NEAR(roots[0], 0.5, 1e-12);
+  EXPECT_NEAR(roots[1], 0.75, 1e-12);
+
+  // roots on the ends are found once
+  ASSERT_EQ(poly::findRoots(c, 3, 0.25, 0.75, roots), 3);
+  EXPECT_EQ(roots[0], 0.25);
+  EXPECT_EQ(roots[2], 0.75);
+}
+
+TEST(Poly, FindRootsDegenerateTest) {
+  // tiny leading coefficient, so nearly a line
+  const double nearLine[3] = {-0.5, 1, 1e-14};
+  double roots[6];
+  ASSERT_EQ(poly::findRoots(nearLine, 2, 0, 1, roots), 1);
+  EXPECT_NEAR(roots[0], 0.5, 1e-12);
+
+  // no real roots
+  const double positive[3] = {1, 0, 1};
+  EXPECT_EQ(poly::findRoots(positive, 2, -10, 10, roots), 0);
+
+  const double zero[3] = {0, 0, 0};
+  EXPECT_EQ(poly::findRoots(zero, 2, 0, 1, roots), 0);
+
+  // degree 5 with close roots: x(x - 0.2)(x - 0.2001)(x - 0.6)(x - 1)
+  double quintic[6] = {0, 0, 0, 0, 0, 1};
+  const double r[5] = {0, 0.2, 0.2001, 0.6, 1};
+  // multiply out one root at a time
+  double prod[6] = {1, 0, 0, 0, 0, 0};
+  for (int k = 0; k < 5; k++) {
+    for (int j = k + 1; j >= 1; j--) {
+      prod[j] = prod[j - 1] - r[k] * prod[j];
+    }
+    prod[0] = -r[k] * prod[0];
+  }
+  std::copy(prod, prod + 6, quintic);
+
+  ASSERT_EQ(poly::findRoots(quintic, 5, -0.5, 1.5, roots), 5);
+  for (int k = 0; k < 5; k++) {
+    EXPECT_NEAR(roots[k], r[k], 1e-9);
+  }
+}
+
+TEST(Poly, FindMaxTest) {
+  // -(x - 0.3)^2 + 2
+  const double c[3] = {2 - 0.09, 0.6, -1};
+  double at = -1;
+  EXPECT_NEAR(poly::findMax(c, 2, 0, 1, &at), 2, 1e-12);
+  EXPECT_NEAR(at, 0.3, 1e-12);
+
+  // maximum at an end
+  EXPECT_NEAR(poly::findMax(c, 2, 0.5, 1, &at), 2 - 0.04, 1e-12);
+  EXPECT_NEAR(at, 0.5, 1e-12);
+}
+
+TEST(Poly, SegmentMaxTest) {
+  // p(u) = (u, u^3 - u) over a segment of length 2
+  const double c[8] = {0, 0, 1, -1, 0, 0, 0, 1};
+  const double invH = 0.5;
+
+  // brute force
+  double dist = 0;
+  double speed = 0;
+  double acc = 0;
+  for (int i = 0; i <= 100000; i++) {
+    const double u = i / 100000.0;
+    const double x = u;
+    const double y = u * u * u - u;
+    const double vx = invH;
+    const double vy = (3 * u * u - 1) * invH;
+    const double ay = 6 * u * invH * invH;
+    dist = std::max(dist, x * x + y * y);
+    speed = std::max(speed, vx * vx + vy * vy);
+    acc = std::max(acc, ay * ay);
+  }
+
+  EXPECT_NEAR(poly::getSegmentMax<2>(c, invH, 0), dist, 1e-9);
+  EXPECT_NEAR(poly::getSegmentMax<2>(c, invH, 1), speed, 1e-9);
+  EXPECT_NEAR(poly::getSegmentMax<2>(c, invH, 2), acc, 1e-9);
+
+  // part of the segment, where the acceleration peaks at the end and the
+  // speed peaks at the start
+  EXPECT_NEAR(poly::getSegmentMax<2>(c, invH, 2, 0.1, 0.5), 0.5625, 1e-12);
+  EXPECT_NEAR(poly::getSegmentMax<2>(c, invH, 1, 0.2, 0.5),
+              0.25 + 0.5 * 0.88 * 0.5 * 0.88, 1e-12);
+}
+
+TEST(Poly, SegmentBoundsTest) {
+  // p(u) = (u, u^3 - u), where y has a minimum at u = 1 / sqrt(3)
+  const double c[8] = {0, 0, 1, -1, 0, 0, 0, 1};
+  double lower[2];
+  double upper[2];
+  poly::getSegmentBounds<2>(c, 0, 1, lower, upper);
+
+  const double root = 1 / std::sqrt(3.0);
+  EXPECT_EQ(lower[0], 0);
+  EXPECT_EQ(upper[0], 1);
+  EXPECT_NEAR(lower[1], root * root * root - root, 1e-12);
+  EXPECT_NEAR(upper[1], 0, 1e-12);
+
+  // the minimum is outside of this part
+  poly::getSegmentBounds<2>(c, 0.7, 0.9, lower, upper);
+  EXPECT_NEAR(lower[1], 0.7 * 0.7 * 0.7 - 0.7, 1e-12);
+  EXPECT_NEAR(upper[1], 0.9 * 0.9 * 0.9 - 0.9, 1e-12);
+}
+
+TEST(Poly, ClosestUTest) {
+  // p(u) = (u, u^3 - u)
+  const double c[8] = {0, 0, 1, -1, 0, 0, 0, 1};
+
+  double best = 0;
+  double bestSq = 1e300;
+  const double point[2] = {0.8, 0.1};
+  for (int i = 0; i <= 1000000; i++) {
+    const double u = i / 1000000.0;
+    const double dx = u - point[0];
+    const double dy = u * u * u - u - point[1];
+    if (dx * dx + dy * dy < bestSq) {
+      best = u;
+      bestSq = dx * dx + dy * dy;
+    }
+  }
+
+  double sqDist = 0;
+  EXPECT_NEAR(poly::getClosestU<2>(c, point, &sqDist), best, 1e-6);
+  EXPECT_NEAR(sqDist, bestSq, 1e-12);
+
+  // beyond the end of the segment
+  const double far[2] = {3, 0};
+  EXPECT_EQ(poly::getClosestU<2>(c, far), 1);
+}
+
+TEST(Poly, SubSegmentTest) {
+  const double c[8] = {1, -2, 3, 0.5, -1, 4, 2, -3};
+  double sub[8];
+  poly::getSubSegment<2>(c, 0.2, 0.7, sub);
+
+  for (int i = 0; i <= 10; i++) {
+    const double v = i / 10.0;
+    const double u = 0.2 + 0.5 * v;
+    for (int dim = 0; dim < 2; dim++) {
+      const double whole[4] = {c[dim], c[2 + dim], c[4 + dim], c[6 + dim]};
+      const double part[4] = {sub[dim], sub[2 + dim], sub[4 + dim],
+                              sub[6 + dim]};
+      EXPECT_NEAR(poly::evaluate(part, 3, v), poly::evaluate(whole, 3, u),
+                  1e-12);
+    }
+  }
+}
+
+TEST(Poly, SegmentLengthTest) {
+  // a straight line, p(u) = (3u, 4u)
+  const double line[8] = {0, 0, 3, 4, 0, 0, 0, 0};
+  EXPECT_NEAR(poly::getSegmentLength<2>(line, 0, 1), 5, 1e-12);
+  EXPECT_NEAR(poly::getSegmentLength<2>(line, 0.2, 0.6), 2, 1e-12);
+  EXPECT_NEAR(poly::getSegmentLength<2>(line, 0.6, 0.2), -2, 1e-12);
+
+  // p(u) = (u, u^2), whose length has a closed form
+  const double parabola[8] = {0, 0, 1, 0, 0, 1, 0, 0};
+  const double expected =
+      0.5 * std::sqrt(5.0) + 0.25 * std::log(2 + std::sqrt(5.0));
+  EXPECT_NEAR(poly::getSegmentLength<2>(parabola, 0, 1), expected, 1e-12);
+
+  // stops and turns around at u = 0.5, where the speed is not smooth
+  const double cusp[4] = {0, 1, -3, 2};
+  double brute = 0;
+  for (int i = 0; i < 1000000; i++) {
+    const double u = (i + 0.5) / 1000000;
+    brute += std::abs(1 - 6 * u + 6 * u * u) / 1000000;
+  }
+  EXPECT_NEAR(poly::getSegmentLength<1>(cusp, 0, 1), brute, 1e-9);
+}
+
+TEST(Poly, UAtLengthTest) {
+  const double line[8] = {0, 0, 3, 4, 0, 0, 0, 0};
+  EXPECT_NEAR(poly::getUAtLength<2>(line, 0, 2), 0.4, 1e-12);
+  EXPECT_NEAR(poly::getUAtLength<2>(line, 0.6, -2), 0.2, 1e-12);
+  EXPECT_EQ(poly::getUAtLength<2>(line, 0.3, 0), 0.3);
+
+  // measuring back to the answer gives the same length
+  const double parabola[8] = {0, 0, 1, 0, 0, 1, 0, 0};
+  const double u = poly::getUAtLength<2>(parabola, 0.1, 0.8);
+  EXPECT_NEAR(poly::getSegmentLength<2>(parabola, 0.1, u), 0.8, 1e-10);
+
+  // passes through a stop at u = 0.5
+  const double cusp[4] = {0, 1, -3, 2};
+  const double half = poly::getSegmentLength<1>(cusp, 0, 0.5);
+  const double v = poly::getUAtLength<1>(cusp, 0, half + 0.01);
+  EXPECT_GT(v, 0.5);
+  EXPECT_NEAR(poly::getSegmentLength<1>(cusp, 0, v), half + 0.01, 1e-10);
+}
@@ -58,3 +58,15 @@ TEST(Pose, AssignPose) {
   EXPECT_NEAR(pose2.getPos()[0], 3, 0.000001);
   EXPECT_NEAR(pose2.getVel()[0], 0, 0.000001);
 }
+
+TEST(Pose, FloatPose) {
+  static_assert(sizeof(Pose<3, float>) < sizeof(Pose<3>),
+                "float poses should be smaller");
+
+  // the time keeps every digit, and the vectors are rounded to float
+  Pose<3, float> pose{1e9 + 0.25, {0.1, 2, -3}, {1, 0, 0.3}};
+  EXPECT_EQ(pose.getTime(), 1e9 + 0.25);
+  EXPECT_EQ(pose.getPos()[0], static_cast<double>(0.1f));
+  EXPECT_EQ(pose.getPos()[2], -3);
+  EXPECT_EQ(pose.getVel()[2], static_cast<double>(0.3f));
+}
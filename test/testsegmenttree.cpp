@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hermite/segment_tree.hpp"
+
+using namespace hermite;
+
+namespace {
+struct Sum {
+  double val;
+
+  static Sum merge(const Sum &a, const Sum &b) { return Sum{a.val + b.val}; }
+};
+
+// not commutative, so the order of merging is checked
+struct Concat {
+  std::vector<int> vals;
+
+  static Concat merge(const Concat &a, const Concat &b) {
+    Concat res = a;
+    res.vals.insert(res.vals.end(), b.vals.begin(), b.vals.end());
+    return res;
+  }
+};
+} // namespace
+
+TEST(SegmentTree, EmptyTest) {
+  SegmentTree<Sum> tree;
+  EXPECT_EQ(tree.size(), 0u);
+  EXPECT_EQ(tree.getAll().val, 0);
+  EXPECT_EQ(tree.query(0, 0).val, 0);
+}
+
+TEST(SegmentTree, QueryTest) {
+  std::vector<Sum> values;
+  for (int i = 0; i < 13; i++) {
+    values.push_back(Sum{static_cast<double>(i * i)});
+  }
+
+  SegmentTree<Sum> tree{values};
+  EXPECT_EQ(tree.size(), 13u);
+  EXPECT_EQ(tree.getLeafCount(), 16u);
+  EXPECT_EQ(tree.getNode(1).val, tree.getAll().val);
+
+  for (std::size_t first = 0; first <= 13; first++) {
+    for (std::size_t last = first; last <= 13; last++) {
+      double expected = 0;
+      for (std::size_t i = first; i < last; i++) {
+        expected += values[i].val;
+      }
+      EXPECT_EQ(tree.query(first, last).val, expected);
+    }
+  }
+}
+
+TEST(SegmentTree, SetTest) {
+  std::vector<Sum> values(7, Sum{1});
+  SegmentTree<Sum> tree{values};
+
+  tree.set(3, Sum{10});
+  tree.set(6, Sum{-2});
+  EXPECT_EQ(tree.get(3).val, 10);
+  EXPECT_EQ(tree.getAll().val, 5 + 10 - 2);
+  EXPECT_EQ(tree.query(2, 5).val, 12);
+
+  // reassigning reuses the tree
+  tree.assign(std::vector<Sum>(3, Sum{2}));
+  EXPECT_EQ(tree.size(), 3u);
+  EXPECT_EQ(tree.getAll().val, 6);
+}
+
+TEST(SegmentTree, OrderTest) {
+  std::vector<Concat> values;
+  for (int i = 0; i < 11; i++) {
+    values.push_back(Concat{{i}});
+  }
+
+  const SegmentTree<Concat> tree{values};
+  const auto res = tree.query(2, 9);
+  ASSERT_EQ(res.vals.size(), 7u);
+  EXPECT_TRUE(std::is_sorted(res.vals.begin(), res.vals.end()));
+  EXPECT_EQ(res.vals[0], 2);
+}
@@ -0,0 +1,134 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hermite/simd/simd.hpp"
+
+using namespace hermite;
+using svector::Vector;
+
+TEST(Simd, KernelsMatchScalarTest) {
+  const double c[4] = {1.5, -2, 0.25, 3};
+  const double t0 = 2;
+  const double invH = 0.5;
+
+  // odd length so every kernel has a remainder
+  std::vector<double> ts;
+  for (int i = 0; i < 37; i++) {
+    ts.push_back(1.5 + i * 0.07);
+  }
+
+  std::vector<double> expected(ts.size());
+  simd::cubicScalar(c, t0, invH, ts.data(), ts.size(), expected.data());
+
+  const simd::Level levels[4] = {simd::SCALAR, simd::SSE2, simd::AVX2,
+                                 simd::AVX512};
+  for (const auto level : levels) {
+    if (!simd::isSupported(level)) {
+      continue;
+    }
+
+    // every length up to the full array
+    for (std::size_t n = 0; n <= ts.size(); n++) {
+      std::vector<double> out(n + 1, -99);
+      simd::getCubicKernel(level)(c, t0, invH, ts.data(), n, out.data());
+      for (std::size_t i = 0; i < n; i++) {
+        EXPECT_NEAR(out[i], expected[i], 0.000000001);
+      }
+
+      // make sure nothing was written past the end
+      EXPECT_EQ(out[n], -99);
+    }
+  }
+}
+
+TEST(Simd, BestLevelSupportedTest) {
+  EXPECT_TRUE(simd::isSupported(simd::getLevel()));
+  EXPECT_TRUE(simd::isSupported(simd::SCALAR));
+}
+
+TEST(Simd, EvalSegmentTest) {
+  // p(u) = 1 + 2u + 3u^2 + 4u^3 in dim 0, and -u^3 in dim 1
+  const double coefs[8] = {1, 0, 2, 0, 3, 0, 4, -1};
+  const double t0 = 1;
+  const double invH = 0.5;
+
+  std::vector<double> ts;
+  for (int i = 0; i < 300; i++) {
+    ts.push_back(1 + i * 0.01);
+  }
+
+  std::vector<Vector<2>> pos(ts.size());
+  std::vector<Vector<2>> vel(ts.size());
+  std::vector<Vector<2>> acc(ts.size());
+  simd::evalSegment<2>(coefs, t0, invH, 0, ts.data(), ts.size(), pos.data());
+  simd::evalSegment<2>(coefs, t0, invH, 1, ts.data(), ts.size(), vel.data());
+  simd::evalSegment<2>(coefs, t0, invH, 2, ts.data(), ts.size(), acc.data());
+
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    const double u = (ts[i] - t0) * invH;
+    EXPECT_NEAR(pos[i][0], 1 + 2 * u + 3 * u * u + 4 * u * u * u, 0.000001);
+    EXPECT_NEAR(vel[i][0], (2 + 6 * u + 12 * u * u) * invH, 0.000001);
+    EXPECT_NEAR(acc[i][0], (6 + 24 * u) * invH * invH, 0.000001);
+    EXPECT_NEAR(pos[i][1], -u * u * u, 0.000001);
+    EXPECT_NEAR(vel[i][1], -3 * u * u * invH, 0.000001);
+    EXPECT_NEAR(acc[i][1], -6 * u * invH * invH, 0.000001);
+  }
+}
+
+TEST(Simd, FloatKernelsMatchScalarTest) {
+  const float c[4] = {1.5f, -2, 0.25f, 3};
+  const double invH = 0.5;
+
+  // large absolute times, since u is found in double before rounding
+  const double t0 = 1e9;
+  std::vector<double> ts;
+  for (int i = 0; i < 53; i++) {
+    ts.push_back(t0 - 0.5 + i * 0.07);
+  }
+
+  std::vector<float> expected(ts.size());
+  simd::cubicScalarFloat(c, t0, invH, ts.data(), ts.size(), expected.data());
+
+  const simd::Level levels[4] = {simd::SCALAR, simd::SSE2, simd::AVX2,
+                                 simd::AVX512};
+  for (const auto level : levels) {
+    if (!simd::isSupported(level)) {
+      continue;
+    }
+
+    for (std::size_t n = 0; n <= ts.size(); n++) {
+      std::vector<float> out(n + 1, -99);
+      simd::getFloatCubicKernel(level)(c, t0, invH, ts.data(), n, out.data());
+      for (std::size_t i = 0; i < n; i++) {
+        const double u = (ts[i] - t0) * invH;
+        EXPECT_NEAR(out[i], expected[i], 0.00001);
+        EXPECT_NEAR(out[i], 1.5 - 2 * u + 0.25 * u * u + 3 * u * u * u,
+                    0.00001);
+      }
+
+      EXPECT_EQ(out[n], -99);
+    }
+  }
+}
+
+TEST(Simd, FloatEvalSegmentTest) {
+  const float coefs[8] = {1, 0, 2, 0, 3, 0, 4, -1};
+  const double t0 = 1;
+  const double invH = 0.5;
+
+  std::vector<double> ts;
+  for (int i = 0; i < 300; i++) {
+    ts.push_back(1 + i * 0.01);
+  }
+
+  std::vector<Vector<2>> vel(ts.size());
+  simd::evalSegment<2>(coefs, t0, invH, 1, ts.data(), ts.size(), vel.data());
+
+  for (std::size_t i = 0; i < ts.size(); i++) {
+    const double u = (ts[i] - t0) * invH;
+    EXPECT_NEAR(vel[i][0], (2 + 6 * u + 12 * u * u) * invH, 0.00001);
+    EXPECT_NEAR(vel[i][1], -3 * u * u * invH, 0.00001);
+  }
+}
@@ -1,3 +1,5 @@
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "hermite/hermite/hermite_sub.hpp"
@@ -121,3 +123,30 @@ TEST(HermiteSubTest, AssignTest) {
   EXPECT_NEAR(h.getAcc(0)[0], 2.78125, 0.01);
   EXPECT_NEAR(h.getAcc(1)[0], 4.5625, 0.01);
 }
+
+TEST(HermiteSubTest, BatchTest) {
+  HermiteSub<2> h{{3, 0}, {1.5, 2.5}, {2.8, -3.8}, {1, 0}, -1, 3};
+
+  std::vector<double> ts;
+  for (int i = 0; i < 101; i++) {
+    ts.push_back(-1.5 + i * 0.05);
+  }
+
+  // also check a batch too short for the kernels
+  for (const std::size_t n : {ts.size(), std::size_t{3}}) {
+    std::vector<Vector<2>> pos(n);
+    std::vector<Vector<2>> vel(n);
+    std::vector<Vector<2>> acc(n);
+    h.getPosBatch(ts.data(), n, pos.data());
+    h.getVelBatch(ts.data(), n, vel.data());
+    h.getAccBatch(ts.data(), n, acc.data());
+
+    for (std::size_t i = 0; i < n; i++) {
+      for (std::size_t dim = 0; dim < 2; dim++) {
+        EXPECT_NEAR(pos[i][dim], h.getPos(ts[i])[dim], 0.00001);
+        EXPECT_NEAR(vel[i][dim], h.getVel(ts[i])[dim], 0.00001);
+        EXPECT_NEAR(acc[i][dim], h.getAcc(ts[i])[dim], 0.00001);
+      }
+    }
+  }
+}
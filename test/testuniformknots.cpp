@@ -0,0 +1,43 @@
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hermite/uniform_knots.hpp"
+
+using namespace hermite;
+
+TEST(UniformKnots, DetectTest) {
+  std::vector<double> even{-1, -0.5, 0, 0.5, 1, 1.5};
+  std::vector<double> uneven{-1, -0.5, 0, 0.6, 1, 1.5};
+  std::vector<double> nearlyEven{0, 0.1, 0.2 + 1e-13, 0.30000000000000004};
+
+  EXPECT_TRUE(UniformKnots(even.data(), even.size()).isUniform());
+  EXPECT_FALSE(UniformKnots(uneven.data(), uneven.size()).isUniform());
+  EXPECT_TRUE(UniformKnots(nearlyEven.data(), nearlyEven.size()).isUniform());
+  EXPECT_FALSE(UniformKnots(even.data(), 1).isUniform());
+  EXPECT_FALSE(UniformKnots().isUniform());
+}
+
+TEST(UniformKnots, SegmentTest) {
+  // times that are not exactly representable
+  std::vector<double> ts;
+  for (int i = 0; i <= 30; i++) {
+    ts.push_back(0.1 * i);
+  }
+
+  const UniformKnots knots{ts.data(), ts.size()};
+  ASSERT_TRUE(knots.isUniform());
+
+  // a time on a knot gets the later segment, like a binary search
+  for (int i = 0; i < 30; i++) {
+    EXPECT_EQ(knots.getSegment(ts[i]), i);
+    EXPECT_EQ(knots.getSegment(ts[i] + 0.05), i);
+  }
+
+  EXPECT_EQ(knots.getSegment(ts[30]), 29);
+  EXPECT_EQ(knots.getSegment(-5), 0);
+  EXPECT_EQ(knots.getSegment(100), 29);
+  EXPECT_EQ(knots.getSegment(std::numeric_limits<double>::quiet_NaN()), 0);
+  EXPECT_EQ(knots.getSegment(std::numeric_limits<double>::infinity()), 29);
+}
@@ -54,3 +54,15 @@ TEST(HermiteUnitTest, AssignTest) {
   EXPECT_NEAR(h.getAcc(0.75)[0], 14.5, 0.00001);
   EXPECT_NEAR(h.getAcc(1)[0], 25, 0.00001);
 }
+
+TEST(HermiteUnitTest, StateTest) {
+  HermiteUnit<2> h{{1, 3}, {-0.5, 1.5}, {0, 2.8}, {4, 1}};
+  for (double t = -0.5; t <= 1.5; t += 0.25) {
+    auto res = h.getState(t);
+    for (std::size_t dim = 0; dim < 2; dim++) {
+      EXPECT_NEAR(res.pos[dim], h.getPos(t)[dim], 0.00001);
+      EXPECT_NEAR(res.vel[dim], h.getVel(t)[dim], 0.00001);
+      EXPECT_NEAR(res.acc[dim], h.getAcc(t)[dim], 0.00001);
+    }
+  }
+}